@@ -33,7 +33,7 @@ void AddMatchAction::redoImpl(TournamentStore & tournament) {
         tournament.getPlayer(*bluePlayerId).addMatch(mCombinedId);
     }
 
-    category.pushMatch(std::make_unique<MatchStore>(mCombinedId, mType, mTitle, mBye, whitePlayerId, bluePlayerId));
+    category.pushMatch(MatchStore(mCombinedId, mType, mTitle, mBye, whitePlayerId, bluePlayerId));
 }
 
 void AddMatchAction::undoImpl(TournamentStore & tournament) {
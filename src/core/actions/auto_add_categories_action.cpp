@@ -1,5 +1,3 @@
-#include <set>
-
 #include "core/actions/add_players_to_category_action.hpp"
 #include "core/actions/auto_add_categories_action.hpp"
 #include "core/actions/draw_categories_action.hpp"
@@ -15,100 +13,13 @@ std::string AutoAddCategoriesAction::getDescription() const {
     return "Automatically add categories for players";
 }
 
-struct Solution {
-    bool possible;
-    std::multiset<size_t> sizes;
-    size_t next;
-
-    bool operator<(const Solution &other) {
-        if (possible != other.possible)
-            return possible; // smaller iff possible
-
-        auto i = sizes.begin();
-        auto j = other.sizes.begin();
-
-        while (i != sizes.end() && j != other.sizes.end()) {
-            if (*i != *j)
-                return *i > *j;
-
-            ++j;
-            ++i;
-        }
-
-        return false;
-    }
-};
-
-AutoAddCategoriesAction::AutoAddCategoriesAction(TournamentStore &tournament, std::vector<PlayerId> playerIds, std::string baseName, float maxDifference, size_t maxSize)
-    : mBaseName(baseName)
+AutoAddCategoriesAction::AutoAddCategoriesAction(TournamentStore &tournament, std::vector<std::vector<PlayerId>> playerIds, std::string baseName)
+    : mPlayerIds(std::move(playerIds))
+    , mBaseName(baseName)
     , mSeed(getSeed())
 {
-    std::vector<std::pair<float, PlayerId>> weights;
-    for (auto playerId : playerIds) {
-        if (!tournament.containsPlayer(playerId))
-            continue;
-        const PlayerStore &player = tournament.getPlayer(playerId);
-        if (!player.getWeight())
-            continue;
-        weights.emplace_back(player.getWeight()->toFloat(), playerId);
-    }
-
-    if (weights.empty())
-        return;
-
-    std::sort(weights.begin(), weights.end());
-
-    std::vector<Solution> dp(weights.size()+1);
-
-    auto & back = dp.back();
-    back.possible = true;
-
-    for (int i = weights.size() - 1; i >= 0; --i) {
-        Solution best_so_far;
-        best_so_far.possible = false;
-
-        for (size_t j = static_cast<size_t>(i); j < weights.size(); ++j) {
-            auto diff = 100.0 * (weights[j].first - weights[i].first)/weights[j].first;
-            auto size = j-static_cast<size_t>(i)+1;
-
-            if (size > maxSize)
-                break;
-            if (diff > maxDifference)
-                break;
-
-            const auto & next = dp[j+1];
-
-            Solution current;
-            current.possible = next.possible;
-            if (current.possible) { // no reason to copy if not possible
-                current.sizes = next.sizes;
-                current.sizes.insert(size);
-                if (current.sizes.size() > 50) // Limit to 50 to avoid n^3 complexity
-                    current.sizes.erase(std::prev(current.sizes.end()));
-            }
-            current.next = j+1;
-
-            if (current < best_so_far)
-                best_so_far = current;
-        }
-
-        dp[i] = best_so_far;
-    }
-
-    if (!dp[0].possible) return;
-
-    size_t next = 0;
-    while (next != weights.size()) {
-        auto sol = dp[next];
-        std::vector<PlayerId> playerIds;
-        for (size_t j = next; j < sol.next; ++j)
-            playerIds.push_back(weights[j].second);
-
+    for (size_t i = 0; i < mPlayerIds.size(); ++i)
         mCategoryIds.push_back(CategoryId::generate(tournament));
-        mPlayerIds.push_back(std::move(playerIds));
-
-        next = sol.next;
-    }
 }
 
 AutoAddCategoriesAction::AutoAddCategoriesAction(const std::vector<std::vector<PlayerId>> &playerIds, std::vector<CategoryId> categoryIds, std::string baseName, unsigned int seed)
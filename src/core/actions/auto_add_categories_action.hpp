@@ -8,7 +8,7 @@ class TournamentStore;
 class AutoAddCategoriesAction : public Action {
 public:
     AutoAddCategoriesAction() = default;
-    AutoAddCategoriesAction(TournamentStore &tournament, std::vector<PlayerId> playerIds, std::string baseName, float maxDifference, size_t maxSize);
+    AutoAddCategoriesAction(TournamentStore &tournament, std::vector<std::vector<PlayerId>> playerIds, std::string baseName); // Groups computed by AutoCategorizer
     AutoAddCategoriesAction(const std::vector<std::vector<PlayerId>> &playerIds, std::vector<CategoryId> categoryIds, std::string baseName, unsigned int seed);
 
     void redoImpl(TournamentStore & tournament) override;
@@ -24,8 +24,9 @@ void ChangePlayersWeightAction::redoImpl(TournamentStore & tournament) {
 
     mChangedCategories = getCategoriesThatChange(tournament);
     for (const CategoryId categoryId : mChangedCategories) {
-        const auto &category = tournament.getCategory(categoryId);
-        const auto &drawSystem = category.getDrawSystem();
+        auto &category = tournament.getCategory(categoryId);
+        auto &drawSystem = category.getDrawSystem();
+        drawSystem.invalidateResults(); // Weights are used for tie-breaking
         auto drawActions = drawSystem.updateCategory(tournament, category);
 
         for (std::unique_ptr<Action> &action : drawActions) {
@@ -54,6 +55,9 @@ void ChangePlayersWeightAction::undoImpl(TournamentStore & tournament) {
         std::advance(i, 1);
     }
 
+    for (const CategoryId categoryId : mChangedCategories)
+        tournament.getCategory(categoryId).getDrawSystem().invalidateResults();
+
     tournament.changePlayers(mChangedPlayers);
     tournament.resetCategoryResults(mChangedCategories);
 
@@ -4,6 +4,7 @@
 #include "core/actions/add_match_action.hpp"
 #include "core/draw_systems/draw_system.hpp"
 #include "core/id.hpp"
+#include "core/misc/thread_pool.hpp"
 #include "core/rulesets/ruleset.hpp"
 #include "core/stores/category_store.hpp"
 #include "core/stores/match_store.hpp"
@@ -48,23 +49,22 @@ void DrawCategoriesAction::redoImpl(TournamentStore & tournament) {
 
     tournament.beginResetMatches(mChangedCategories);
 
-    // Update categories
+    // Delete all existing matches and store the state needed for undo
+    std::vector<std::vector<PlayerId>> playerIds;
     for (auto categoryId : mChangedCategories) {
-        // Delete all existing matches
         CategoryStore & category = tournament.getCategory(categoryId);
 
-        for (const std::unique_ptr<MatchStore> &match : category.getMatches()) {
-            std::optional<PlayerId> whitePlayer = match->getPlayer(MatchStore::PlayerIndex::WHITE);
+        for (const MatchStore &match : category.getMatches()) {
+            std::optional<PlayerId> whitePlayer = match.getPlayer(MatchStore::PlayerIndex::WHITE);
             if (whitePlayer && tournament.containsPlayer(*whitePlayer))
-                tournament.getPlayer(*whitePlayer).eraseMatch(CombinedId(categoryId, match->getId()));
+                tournament.getPlayer(*whitePlayer).eraseMatch(CombinedId(categoryId, match.getId()));
 
-            std::optional<PlayerId> bluePlayer = match->getPlayer(MatchStore::PlayerIndex::BLUE);
+            std::optional<PlayerId> bluePlayer = match.getPlayer(MatchStore::PlayerIndex::BLUE);
             if (bluePlayer && tournament.containsPlayer(*bluePlayer))
-                tournament.getPlayer(*bluePlayer).eraseMatch(CombinedId(categoryId, match->getId()));
+                tournament.getPlayer(*bluePlayer).eraseMatch(CombinedId(categoryId, match.getId()));
         }
 
-        std::vector<std::unique_ptr<MatchStore>> matches = category.clearMatches();
-        mOldMatches.push_back(std::move(matches));
+        mOldMatches.push_back(category.clearMatches());
 
         mOldDrawSystems.push_back(category.getDrawSystem().clone());
 
@@ -73,23 +73,39 @@ void DrawCategoriesAction::redoImpl(TournamentStore & tournament) {
         status[static_cast<size_t>(MatchType::FINAL)] = category.getStatus(MatchType::FINAL);
         mOldStati.push_back(std::move(status));
 
-        // Init the category using the draw system
-        std::vector<PlayerId> playerIds(category.getPlayers().begin(), category.getPlayers().end());
-        std::sort(playerIds.begin(), playerIds.end()); // Required to ensure consistent ordering
-        std::vector<std::unique_ptr<AddMatchAction>> addMatchActions = category.getDrawSystem().initCategory(tournament, category, playerIds, mSeed);
+        std::vector<PlayerId> categoryPlayerIds(category.getPlayers().begin(), category.getPlayers().end());
+        std::sort(categoryPlayerIds.begin(), categoryPlayerIds.end()); // Required to ensure consistent ordering
+        playerIds.push_back(std::move(categoryPlayerIds));
+    }
 
-        for (auto &action : addMatchActions) {
-            action->redo(tournament);
-        }
+    // Init the categories using their draw systems. Each draw only touches its
+    // own category and draw system, so the categories are drawn in parallel.
+    // Every category is seeded with mSeed, making the result independent of scheduling
+    const size_t offset = mActions.size();
+    mActions.resize(offset + mChangedCategories.size());
+    {
+        const TournamentStore &constTournament = tournament;
+        ThreadPool::getInstance().parallelFor(mChangedCategories.size(), [&](size_t i) {
+            CategoryStore & category = tournament.getCategory(mChangedCategories[i]);
+            mActions[offset + i] = category.getDrawSystem().initCategory(constTournament, category, playerIds[i], mSeed);
+        });
+    }
 
-        mActions.push_back(std::move(addMatchActions));
+    // Apply the matches
+    for (size_t i = 0; i < mChangedCategories.size(); ++i) {
+        const CategoryId categoryId = mChangedCategories[i];
+        CategoryStore & category = tournament.getCategory(categoryId);
+
+        auto &addMatchActions = mActions[offset + i];
+        category.reserveMatches(addMatchActions.size());
+        for (auto &action : addMatchActions)
+            action->redo(tournament);
 
         // Compute category status
         category.setStatus(MatchType::ELIMINATION, CategoryStatus());
         category.setStatus(MatchType::FINAL, CategoryStatus());
 
-        for (const auto &matchPtr : category.getMatches()) {
-            const auto &match = *matchPtr;
+        for (const auto &match : category.getMatches()) {
             auto &status = category.getStatus(match.getType());
 
             if (match.getStatus() == MatchStatus::FINISHED)
@@ -146,17 +162,17 @@ void DrawCategoriesAction::undoImpl(TournamentStore & tournament) {
         category.setStatus(MatchType::ELIMINATION, oldStatus[static_cast<size_t>(MatchType::ELIMINATION)]);
         category.setStatus(MatchType::FINAL, oldStatus[static_cast<size_t>(MatchType::FINAL)]);
 
-        std::vector<std::unique_ptr<MatchStore>> matches = std::move(mOldMatches.back());
+        CategoryStore::MatchList matches = std::move(mOldMatches.back());
         mOldMatches.pop_back();
 
-        for (std::unique_ptr<MatchStore> & match : matches) {
-            std::optional<PlayerId> whitePlayer = match->getPlayer(MatchStore::PlayerIndex::WHITE);
+        for (MatchStore & match : matches) {
+            std::optional<PlayerId> whitePlayer = match.getPlayer(MatchStore::PlayerIndex::WHITE);
             if (whitePlayer && tournament.containsPlayer(*whitePlayer))
-                tournament.getPlayer(*whitePlayer).addMatch(match->getCombinedId());
+                tournament.getPlayer(*whitePlayer).addMatch(match.getCombinedId());
 
-            std::optional<PlayerId> bluePlayer = match->getPlayer(MatchStore::PlayerIndex::BLUE);
+            std::optional<PlayerId> bluePlayer = match.getPlayer(MatchStore::PlayerIndex::BLUE);
             if (bluePlayer && tournament.containsPlayer(*bluePlayer))
-                tournament.getPlayer(*bluePlayer).addMatch(match->getCombinedId());
+                tournament.getPlayer(*bluePlayer).addMatch(match.getCombinedId());
 
             category.pushMatch(std::move(match));
         }
@@ -4,12 +4,11 @@
 #include "core/actions/confirmable_action.hpp"
 #include "core/actions/confirmable_action.hpp"
 #include "core/actions/add_match_action.hpp"
+#include "core/stores/category_store.hpp"
 
 class CategoryId;
 class DrawSystem;
-class MatchStore;
 class TournamentStore;
-struct CategoryStatus;
 
 class DrawCategoriesAction : public Action, public ConfirmableAction {
 public:
@@ -38,7 +37,7 @@ private:
 
     // undo members
     std::vector<CategoryId> mChangedCategories;
-    std::vector<std::vector<std::unique_ptr<MatchStore>>> mOldMatches;
+    std::vector<CategoryStore::MatchList> mOldMatches;
     std::vector<std::vector<std::unique_ptr<AddMatchAction>>> mActions;
     std::vector<std::unique_ptr<DrawSystem>> mOldDrawSystems;
     std::vector<std::array<CategoryStatus, 2>> mOldStati;
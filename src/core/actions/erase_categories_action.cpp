@@ -75,14 +75,14 @@ void EraseCategoriesAction::redoImpl(TournamentStore & tournament) {
             player.eraseCategory(categoryId);
         }
 
-        for (const std::unique_ptr<MatchStore> &match : category.getMatches()) {
-            auto whitePlayerId = match->getPlayer(MatchStore::PlayerIndex::WHITE);
+        for (const MatchStore &match : category.getMatches()) {
+            auto whitePlayerId = match.getPlayer(MatchStore::PlayerIndex::WHITE);
             if (whitePlayerId)
-                tournament.getPlayer(*whitePlayerId).eraseMatch(match->getCombinedId());
+                tournament.getPlayer(*whitePlayerId).eraseMatch(match.getCombinedId());
 
-            auto bluePlayerId = match->getPlayer(MatchStore::PlayerIndex::BLUE);
+            auto bluePlayerId = match.getPlayer(MatchStore::PlayerIndex::BLUE);
             if (bluePlayerId)
-                tournament.getPlayer(*bluePlayerId).eraseMatch(match->getCombinedId());
+                tournament.getPlayer(*bluePlayerId).eraseMatch(match.getCombinedId());
         }
 
         mCategories.push(tournament.eraseCategory(categoryId));
@@ -111,14 +111,14 @@ void EraseCategoriesAction::undoImpl(TournamentStore & tournament) {
             player.addCategory(category->getId());
         }
 
-        for (const std::unique_ptr<MatchStore> &match : category->getMatches()) {
-            auto whitePlayerId = match->getPlayer(MatchStore::PlayerIndex::WHITE);
+        for (const MatchStore &match : category->getMatches()) {
+            auto whitePlayerId = match.getPlayer(MatchStore::PlayerIndex::WHITE);
             if (whitePlayerId)
-                tournament.getPlayer(*whitePlayerId).addMatch(match->getCombinedId());
+                tournament.getPlayer(*whitePlayerId).addMatch(match.getCombinedId());
 
-            auto bluePlayerId = match->getPlayer(MatchStore::PlayerIndex::BLUE);
+            auto bluePlayerId = match.getPlayer(MatchStore::PlayerIndex::BLUE);
             if (bluePlayerId)
-                tournament.getPlayer(*bluePlayerId).addMatch(match->getCombinedId());
+                tournament.getPlayer(*bluePlayerId).addMatch(match.getCombinedId());
         }
 
         tournament.addCategory(std::move(category));
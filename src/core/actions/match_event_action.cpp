@@ -73,8 +73,10 @@ void MatchEventAction::recover(TournamentStore &tournament) {
     tournament.changeMatches(match.getCategoryId(), {match.getId()});
 
     // Notify results
-    if (updatedStatus == MatchStatus::FINISHED || prevStatus == MatchStatus::FINISHED)
+    if (updatedStatus == MatchStatus::FINISHED || prevStatus == MatchStatus::FINISHED) {
+        category.getDrawSystem().updateMatchResult(category, match);
         tournament.resetCategoryResults({match.getCategoryId()});
+    }
 }
 
 bool MatchEventAction::shouldRecover() {
@@ -123,7 +125,8 @@ void MatchEventAction::notify(TournamentStore &tournament, const MatchStore &mat
     // Notify draw system
     // Changes to draws can only occur if the match was finished or is finished
     if (prevStatus == MatchStatus::FINISHED || match.getStatus() == MatchStatus::FINISHED) {
-        const auto &drawSystem = category.getDrawSystem();
+        auto &drawSystem = category.getDrawSystem();
+        drawSystem.updateMatchResult(category, match);
         auto drawActions = drawSystem.updateCategory(tournament, category);
         for (std::unique_ptr<Action> &action : drawActions) {
             action->redo(tournament);
@@ -58,10 +58,10 @@ void ResetMatchesAction::redoImpl(TournamentStore & tournament) {
                 continue;
             const auto &category = tournament.getCategory(categoryId);
             for (const auto &match : category.getMatches()) {
-                if (match->getStatus() == MatchStatus::NOT_STARTED)
+                if (match.getStatus() == MatchStatus::NOT_STARTED)
                     continue;
 
-                mChangedMatches.push_back(match->getCombinedId());
+                mChangedMatches.push_back(match.getCombinedId());
             }
         }
     }
@@ -111,8 +111,10 @@ void ResetMatchesAction::redoImpl(TournamentStore & tournament) {
                 concurrentGroup.updateStatus(match);
             }
 
-            if (prevStatus == MatchStatus::FINISHED)
+            if (prevStatus == MatchStatus::FINISHED) {
+                category.getDrawSystem().updateMatchResult(category, match);
                 categoryDrawUpdates.insert(category.getId());
+            }
         }
     }
 
@@ -193,8 +195,10 @@ void ResetMatchesAction::undoImpl(TournamentStore & tournament) {
                 concurrentGroup.updateStatus(match);
             }
 
-            if (prevStatus == MatchStatus::FINISHED)
+            if (prevStatus == MatchStatus::FINISHED) {
+                category.getDrawSystem().updateMatchResult(category, match);
                 categoryDrawUpdates.insert(category.getId());
+            }
         }
     }
 
@@ -35,7 +35,7 @@ private:
     // undo fields
     std::vector<CombinedId> mChangedMatches;
     std::stack<MatchStore::State> mPrevStates;
-    std::stack<std::vector<MatchEvent>> mPrevEvents;
+    std::stack<MatchStore::EventList> mPrevEvents;
     std::stack<std::unique_ptr<Action>> mDrawActions;
 };
 
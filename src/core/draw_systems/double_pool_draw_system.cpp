@@ -226,6 +226,20 @@ DrawSystem::ResultList DoublePoolDrawSystem::getResults(const TournamentStore &t
     return results;
 }
 
+void DoublePoolDrawSystem::updateMatchResult(const CategoryStore &category, const MatchStore &match) {
+    if (mFirstPool)
+        mFirstPool->updateMatchResult(category, match);
+    if (mSecondPool)
+        mSecondPool->updateMatchResult(category, match);
+}
+
+void DoublePoolDrawSystem::invalidateResults() {
+    if (mFirstPool)
+        mFirstPool->invalidateResults();
+    if (mSecondPool)
+        mSecondPool->invalidateResults();
+}
+
 bool DoublePoolDrawSystem::hasFinalBlock() const {
     return true;
 }
@@ -18,6 +18,8 @@ public:
     std::vector<std::unique_ptr<AddMatchAction>> initCategory(const TournamentStore &tournament, const CategoryStore &category, const std::vector<PlayerId> &playerIds, unsigned int seed) override;
     std::vector<std::unique_ptr<Action>> updateCategory(const TournamentStore &tournament, const CategoryStore &category) const override;
     ResultList getResults(const TournamentStore &tournament, const CategoryStore &category) const override;
+    void updateMatchResult(const CategoryStore &category, const MatchStore &match) override;
+    void invalidateResults() override;
 
     template<typename Archive>
     void serialize(Archive& ar, uint32_t const version) {
@@ -10,6 +10,7 @@
 class Action;
 class AddMatchAction;
 class CategoryStore;
+class MatchStore;
 class TournamentStore;
 
 class DrawSystem {
@@ -27,6 +28,12 @@ public:
     virtual std::vector<std::unique_ptr<Action>> updateCategory(const TournamentStore &tournament, const CategoryStore &category) const = 0;
     virtual ResultList getResults(const TournamentStore &tournament, const CategoryStore &category) const = 0;
 
+    // Notify the draw system that a match went to or from finished, or changed while finished.
+    // Draw systems may use this to keep cached results up to date
+    virtual void updateMatchResult(const CategoryStore &category, const MatchStore &match) {}
+    // Drop any cached results. Used when results may change for reasons other than match results
+    virtual void invalidateResults() {}
+
     template<typename Archive>
     void serialize(Archive& ar, uint32_t const version) {}
 
@@ -4,5 +4,6 @@ enum class DrawSystemIdentifier {
     BEST_OF_THREE,
     POOL,
     DOUBLE_POOL,
+    KNOCKOUT,
 };
 
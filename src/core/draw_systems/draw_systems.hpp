@@ -3,5 +3,6 @@
 #include "core/draw_systems/best_of_three_draw_system.hpp"
 #include "core/draw_systems/double_pool_draw_system.hpp"
 #include "core/draw_systems/draw_system.hpp"
+#include "core/draw_systems/knockout_draw_system.hpp"
 #include "core/draw_systems/pool_draw_system.hpp"
 
@@ -0,0 +1,437 @@
+#include <array>
+#include <map>
+#include <unordered_set>
+
+#include "core/actions/add_match_action.hpp"
+#include "core/actions/set_match_player_action.hpp"
+#include "core/draw_systems/knockout_draw_system.hpp"
+#include "core/rulesets/ruleset.hpp"
+#include "core/shuffle.hpp"
+#include "core/stores/category_store.hpp"
+#include "core/stores/player_store.hpp"
+#include "core/stores/tournament_store.hpp"
+
+namespace {
+    // Input of a bracket node while the bracket is being built. WINNER and LOSER
+    // refer to node indices before resolution and to match indices afterwards
+    struct Source {
+        enum class Kind { NONE, PLAYER, WINNER, LOSER };
+
+        Kind kind = Kind::NONE;
+        std::optional<PlayerId> player;
+        size_t index = 0;
+    };
+
+    struct Node {
+        std::array<Source, 2> sources;
+        MatchType type;
+        std::string title;
+        std::optional<unsigned int> winnerRank;
+        std::optional<unsigned int> loserRank;
+    };
+
+    Source winnerOf(size_t index) {
+        Source source;
+        source.kind = Source::Kind::WINNER;
+        source.index = index;
+        return source;
+    }
+
+    Source loserOf(size_t index) {
+        Source source;
+        source.kind = Source::Kind::LOSER;
+        source.index = index;
+        return source;
+    }
+
+    size_t reverseBits(size_t value, size_t bits) {
+        size_t res = 0;
+        for (size_t i = 0; i < bits; ++i) {
+            res = (res << 1) | (value & 1);
+            value >>= 1;
+        }
+        return res;
+    }
+
+    std::string roundTitle(size_t roundsFromFinal) {
+        if (roundsFromFinal == 1)
+            return "Semi-Final";
+        if (roundsFromFinal == 2)
+            return "Quarter-Final";
+        return "Elimination";
+    }
+}
+
+std::unique_ptr<DrawSystem> KnockoutDrawSystem::clone() const {
+    return std::make_unique<KnockoutDrawSystem>(*this);
+}
+
+std::string KnockoutDrawSystem::getName() const {
+    return "Knockout";
+}
+
+std::vector<std::unique_ptr<AddMatchAction>> KnockoutDrawSystem::initCategory(const TournamentStore &tournament, const CategoryStore &category, const std::vector<PlayerId> &playerIds, unsigned int seed) {
+    assert(playerIds.size() == category.getPlayers().size()); // This draw system is not made to be composed
+
+    mMatches.clear();
+    mMatchIndices.clear();
+    mChangedMatches.clear();
+    mInvalidated = true;
+    mPlayers = playerIds;
+
+    std::vector<std::unique_ptr<AddMatchAction>> actions;
+    if (mPlayers.size() <= 1)
+        return actions;
+
+    std::mt19937 randomEng(seed);
+    shuffle(mPlayers.begin(), mPlayers.end(), randomEng);
+
+    size_t rounds = 1;
+    while ((static_cast<size_t>(1) << rounds) < mPlayers.size())
+        ++rounds;
+
+    // Spread the byes over the bracket by placing them in bit-reversed order.
+    // There are always fewer byes than first round matches, so no match is left empty
+    const size_t firstRoundCount = static_cast<size_t>(1) << (rounds - 1);
+    const size_t byeCount = 2 * firstRoundCount - mPlayers.size();
+    std::vector<bool> hasBye(firstRoundCount, false);
+    for (size_t i = 0; i < byeCount; ++i)
+        hasBye[reverseBits(i, rounds - 1)] = true;
+
+    std::vector<Node> nodes;
+    std::vector<size_t> roundStart;
+
+    // Create the main bracket up to and including the semi finals
+    auto player = mPlayers.begin();
+    for (size_t round = 0; round + 1 < rounds; ++round) {
+        roundStart.push_back(nodes.size());
+        const size_t count = firstRoundCount >> round;
+        for (size_t i = 0; i < count; ++i) {
+            Node node;
+            node.type = MatchType::ELIMINATION;
+            node.title = roundTitle(rounds - 1 - round);
+
+            if (round == 0) {
+                node.sources[0].kind = Source::Kind::PLAYER;
+                node.sources[0].player = *(player++);
+                if (!hasBye[i]) {
+                    node.sources[1].kind = Source::Kind::PLAYER;
+                    node.sources[1].player = *(player++);
+                }
+            }
+            else {
+                node.sources[0] = winnerOf(roundStart[round - 1] + 2 * i);
+                node.sources[1] = winnerOf(roundStart[round - 1] + 2 * i + 1);
+            }
+
+            if (rounds == 2) // No repechage for brackets of four
+                node.loserRank = 3;
+
+            nodes.push_back(std::move(node));
+        }
+    }
+
+    // Add repechage and bronze matches. Losers of the quarter finals meet in
+    // the repechage and the winners face the semi final losers from the other half
+    if (rounds >= 3) {
+        const size_t quarterFinals = roundStart[rounds - 3];
+        const size_t semiFinals = roundStart[rounds - 2];
+
+        const size_t firstRepechage = nodes.size();
+        for (size_t i = 0; i < 2; ++i) {
+            Node node;
+            node.type = MatchType::FINAL;
+            node.title = "Repechage";
+            node.sources[0] = loserOf(quarterFinals + 2 * i);
+            node.sources[1] = loserOf(quarterFinals + 2 * i + 1);
+            node.loserRank = 7;
+            nodes.push_back(std::move(node));
+        }
+
+        for (size_t i = 0; i < 2; ++i) {
+            Node node;
+            node.type = MatchType::FINAL;
+            node.title = "Bronze";
+            node.sources[0] = winnerOf(firstRepechage + i);
+            node.sources[1] = loserOf(semiFinals + 1 - i);
+            node.winnerRank = 3;
+            node.loserRank = 5;
+            nodes.push_back(std::move(node));
+        }
+    }
+
+    {
+        Node node;
+        node.type = MatchType::FINAL;
+        node.title = "Final";
+        if (rounds == 1) {
+            node.sources[0].kind = Source::Kind::PLAYER;
+            node.sources[0].player = mPlayers[0];
+            node.sources[1].kind = Source::Kind::PLAYER;
+            node.sources[1].player = mPlayers[1];
+        }
+        else {
+            node.sources[0] = winnerOf(roundStart[rounds - 2]);
+            node.sources[1] = winnerOf(roundStart[rounds - 2] + 1);
+        }
+        node.winnerRank = 1;
+        node.loserRank = 2;
+        nodes.push_back(std::move(node));
+    }
+
+    // Create matches for nodes with two possible contestants. Nodes with only
+    // one contestant are skipped and the contestant is passed straight through
+    MatchId::Generator generator(seed);
+    std::vector<std::optional<size_t>> matchIndices(nodes.size());
+    std::vector<Source> passThrough(nodes.size());
+
+    auto resolve = [&](const Source &source) {
+        if (source.kind != Source::Kind::WINNER && source.kind != Source::Kind::LOSER)
+            return source;
+
+        const auto &matchIndex = matchIndices[source.index];
+        if (!matchIndex)
+            return (source.kind == Source::Kind::WINNER ? passThrough[source.index] : Source());
+
+        Source res = source;
+        res.index = *matchIndex;
+        return res;
+    };
+
+    auto getOutlet = [&](const Source &source) -> Outlet & {
+        auto &match = mMatches[source.index];
+        return (source.kind == Source::Kind::WINNER ? match.winner : match.loser);
+    };
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const auto &node = nodes[i];
+        std::array<Source, 2> sources = {resolve(node.sources[0]), resolve(node.sources[1])};
+
+        if (sources[0].kind == Source::Kind::NONE || sources[1].kind == Source::Kind::NONE) {
+            const auto &source = (sources[0].kind == Source::Kind::NONE ? sources[1] : sources[0]);
+            passThrough[i] = source;
+            if (node.winnerRank && (source.kind == Source::Kind::WINNER || source.kind == Source::Kind::LOSER))
+                getOutlet(source).rank = node.winnerRank;
+            continue;
+        }
+
+        if (sources[0].kind == Source::Kind::PLAYER && sources[1].kind == Source::Kind::PLAYER) {
+            if (tournament.getPlayer(*(sources[0].player)).getBlueJudogiHint()) // Try to satisfy blue judogi hints
+                std::swap(sources[0], sources[1]);
+        }
+
+        const size_t matchIndex = mMatches.size();
+        matchIndices[i] = matchIndex;
+
+        BracketMatch match;
+        match.id = MatchId::generate(category, generator);
+        match.winner.rank = node.winnerRank;
+        match.loser.rank = node.loserRank;
+        mMatches.push_back(match);
+
+        const std::array<MatchStore::PlayerIndex, 2> playerIndices = {MatchStore::PlayerIndex::WHITE, MatchStore::PlayerIndex::BLUE};
+        for (size_t j = 0; j < 2; ++j) {
+            if (sources[j].kind == Source::Kind::WINNER || sources[j].kind == Source::Kind::LOSER)
+                getOutlet(sources[j]).slot = std::make_pair(matchIndex, playerIndices[j]);
+        }
+
+        actions.push_back(std::make_unique<AddMatchAction>(CombinedId(category.getId(), match.id), node.type, node.title, false, sources[0].player, sources[1].player));
+    }
+
+    return actions;
+}
+
+std::vector<std::unique_ptr<Action>> KnockoutDrawSystem::updateCategory(const TournamentStore &tournament, const CategoryStore &category) const {
+    if (mMatches.empty())
+        return {};
+
+    auto actions = (mInvalidated ? updateBracket(category) : updateOutlets(category));
+    mInvalidated = false;
+    mChangedMatches.clear();
+    return actions;
+}
+
+std::pair<std::optional<PlayerId>, std::optional<PlayerId>> KnockoutDrawSystem::getAdvancingPlayers(const CategoryStore &category, const MatchStore &match, const SlotPlayers &players) {
+    if (match.getStatus() != MatchStatus::FINISHED)
+        return {std::nullopt, std::nullopt};
+
+    std::optional<MatchStore::PlayerIndex> winnerIndex;
+    if (!players[0].has_value())
+        winnerIndex = MatchStore::PlayerIndex::BLUE;
+    else if (!players[1].has_value())
+        winnerIndex = MatchStore::PlayerIndex::WHITE;
+    else
+        winnerIndex = category.getRuleset().getWinner(match);
+
+    if (!winnerIndex)
+        return {std::nullopt, std::nullopt};
+
+    const bool isWhiteWinner = (*winnerIndex == MatchStore::PlayerIndex::WHITE);
+    return {players[isWhiteWinner ? 0 : 1], players[isWhiteWinner ? 1 : 0]};
+}
+
+std::vector<std::unique_ptr<Action>> KnockoutDrawSystem::updateBracket(const CategoryStore &category) const {
+    std::vector<std::unique_ptr<Action>> actions;
+
+    // Players of every bracket match as they should be given the results so
+    // far. Slots fed by an earlier match are filled by the propagation below
+    // while the remaining slots keep the players set when the bracket was drawn
+    std::vector<SlotPlayers> players(mMatches.size());
+    std::vector<std::array<bool, 2>> isFed(mMatches.size(), {false, false});
+    for (const auto &bracketMatch : mMatches) {
+        for (const Outlet *outlet : {&bracketMatch.winner, &bracketMatch.loser}) {
+            if (outlet->slot)
+                isFed[outlet->slot->first][static_cast<size_t>(outlet->slot->second)] = true;
+        }
+    }
+
+    auto advance = [&](const Outlet &outlet, const std::optional<PlayerId> &playerId) {
+        if (outlet.slot)
+            players[outlet.slot->first][static_cast<size_t>(outlet.slot->second)] = playerId;
+    };
+
+    // Outlets always point to later matches, so every slot is final once its match is reached
+    for (size_t index = 0; index < mMatches.size(); ++index) {
+        const auto &bracketMatch = mMatches[index];
+        const auto &match = category.getMatch(bracketMatch.id);
+        auto &current = players[index];
+
+        if (!isFed[index][0])
+            current[0] = match.getWhitePlayer();
+        if (!isFed[index][1])
+            current[1] = match.getBluePlayer();
+
+        const auto [winner, loser] = getAdvancingPlayers(category, match, current);
+        advance(bracketMatch.winner, winner);
+        advance(bracketMatch.loser, loser);
+
+        if (match.getWhitePlayer() != current[0])
+            actions.push_back(std::make_unique<SetMatchPlayerAction>(match.getCombinedId(), MatchStore::PlayerIndex::WHITE, current[0]));
+        if (match.getBluePlayer() != current[1])
+            actions.push_back(std::make_unique<SetMatchPlayerAction>(match.getCombinedId(), MatchStore::PlayerIndex::BLUE, current[1]));
+    }
+
+    return actions;
+}
+
+std::vector<std::unique_ptr<Action>> KnockoutDrawSystem::updateOutlets(const CategoryStore &category) const {
+    std::vector<std::unique_ptr<Action>> actions;
+
+    // Slots changed by this update. Every other slot already matches the category
+    std::map<size_t, SlotPlayers> players;
+    auto getPlayers = [&](size_t index) -> SlotPlayers & {
+        auto it = players.find(index);
+        if (it == players.end()) {
+            const auto &match = category.getMatch(mMatches[index].id);
+            it = players.emplace(index, SlotPlayers{match.getWhitePlayer(), match.getBluePlayer()}).first;
+        }
+        return it->second;
+    };
+
+    // Outlets always point to later matches, so visiting in index order
+    // recomputes a match only after all of its changed sources
+    std::set<size_t> pending = mChangedMatches;
+    while (!pending.empty()) {
+        const size_t index = *(pending.begin());
+        pending.erase(pending.begin());
+
+        const auto &bracketMatch = mMatches[index];
+        const auto [winner, loser] = getAdvancingPlayers(category, category.getMatch(bracketMatch.id), getPlayers(index));
+
+        for (const auto &[outlet, playerId] : {std::make_pair(&bracketMatch.winner, winner), std::make_pair(&bracketMatch.loser, loser)}) {
+            if (!outlet->slot)
+                continue;
+
+            const size_t target = outlet->slot->first;
+            auto &slot = getPlayers(target)[static_cast<size_t>(outlet->slot->second)];
+            if (slot == playerId)
+                continue;
+
+            slot = playerId;
+
+            // The players advancing from an already finished match change with it
+            if (category.getMatch(mMatches[target].id).getStatus() == MatchStatus::FINISHED)
+                pending.insert(target);
+        }
+    }
+
+    for (const auto &[index, current] : players) {
+        const auto &match = category.getMatch(mMatches[index].id);
+        if (match.getWhitePlayer() != current[0])
+            actions.push_back(std::make_unique<SetMatchPlayerAction>(match.getCombinedId(), MatchStore::PlayerIndex::WHITE, current[0]));
+        if (match.getBluePlayer() != current[1])
+            actions.push_back(std::make_unique<SetMatchPlayerAction>(match.getCombinedId(), MatchStore::PlayerIndex::BLUE, current[1]));
+    }
+
+    return actions;
+}
+
+void KnockoutDrawSystem::updateMatchResult(const CategoryStore &category, const MatchStore &match) {
+    if (mMatchIndices.size() != mMatches.size()) {
+        mMatchIndices.clear();
+        for (size_t i = 0; i < mMatches.size(); ++i)
+            mMatchIndices[mMatches[i].id] = i;
+    }
+
+    auto it = mMatchIndices.find(match.getId());
+    if (it != mMatchIndices.end())
+        mChangedMatches.insert(it->second);
+}
+
+void KnockoutDrawSystem::invalidateResults() {
+    // Winners may have changed wholesale (e.g. new ruleset)
+    mInvalidated = true;
+}
+
+DrawSystem::ResultList KnockoutDrawSystem::getResults(const TournamentStore &tournament, const CategoryStore &category) const {
+    ResultList results;
+
+    if (mMatches.empty())
+        return results;
+
+    const auto &status = category.getStatus(MatchType::ELIMINATION) + category.getStatus(MatchType::FINAL);
+    if (!status.isFinished()) // not finished
+        return results;
+
+    const auto &ruleset = category.getRuleset();
+    std::unordered_set<PlayerId> ranked;
+
+    for (const auto &bracketMatch : mMatches) {
+        if (!bracketMatch.winner.rank && !bracketMatch.loser.rank)
+            continue;
+
+        const auto &match = category.getMatch(bracketMatch.id);
+        const auto winnerIndex = ruleset.getWinner(match).value();
+        const auto loserIndex = (winnerIndex == MatchStore::PlayerIndex::WHITE ? MatchStore::PlayerIndex::BLUE : MatchStore::PlayerIndex::WHITE);
+
+        const auto winner = match.getPlayer(winnerIndex);
+        if (bracketMatch.winner.rank && winner) {
+            results.emplace_back(*winner, bracketMatch.winner.rank);
+            ranked.insert(*winner);
+        }
+
+        const auto loser = match.getPlayer(loserIndex);
+        if (bracketMatch.loser.rank && loser) {
+            results.emplace_back(*loser, bracketMatch.loser.rank);
+            ranked.insert(*loser);
+        }
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const auto &a, const auto &b) { return a.second < b.second; });
+
+    for (auto playerId : mPlayers) {
+        if (ranked.find(playerId) != ranked.end())
+            continue;
+        results.emplace_back(playerId, std::nullopt);
+    }
+
+    return results;
+}
+
+bool KnockoutDrawSystem::hasFinalBlock() const {
+    return true;
+}
+
+DrawSystemIdentifier KnockoutDrawSystem::getIdentifier() const {
+    return DrawSystemIdentifier::KNOCKOUT;
+}
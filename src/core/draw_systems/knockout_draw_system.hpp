@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <set>
+#include <unordered_map>
+
+#include "core/draw_systems/draw_system.hpp"
+#include "core/stores/match_store.hpp"
+#include "core/serialize.hpp"
+
+// Single elimination bracket with repechage for the losers of the quarter finals.
+// Every bracket match knows where its winner and loser advance to. Slots are always
+// derived from the category state: a finished match only recomputes its two outlet
+// slots, while invalidated results re-propagate the whole bracket in a single pass.
+class KnockoutDrawSystem : public DrawSystem {
+public:
+    KnockoutDrawSystem() {}
+    KnockoutDrawSystem(const KnockoutDrawSystem &) = default;
+    virtual ~KnockoutDrawSystem() {};
+
+    std::unique_ptr<DrawSystem> clone() const override;
+    std::string getName() const override;
+    bool hasFinalBlock() const override;
+    DrawSystemIdentifier getIdentifier() const override;
+
+    std::vector<std::unique_ptr<AddMatchAction>> initCategory(const TournamentStore &tournament, const CategoryStore &category, const std::vector<PlayerId> &playerIds, unsigned int seed) override;
+    std::vector<std::unique_ptr<Action>> updateCategory(const TournamentStore &tournament, const CategoryStore &category) const override;
+    ResultList getResults(const TournamentStore &tournament, const CategoryStore &category) const override;
+
+    void updateMatchResult(const CategoryStore &category, const MatchStore &match) override;
+    void invalidateResults() override;
+
+    // Where a player goes after winning or losing a bracket match. Either a
+    // slot in a later match or a final placement (or neither when eliminated)
+    struct Outlet {
+        std::optional<std::pair<size_t, MatchStore::PlayerIndex>> slot;
+        std::optional<unsigned int> rank;
+
+        template<typename Archive>
+        void serialize(Archive& ar, uint32_t const version) {
+            ar(slot, rank);
+        }
+    };
+
+    struct BracketMatch {
+        MatchId id;
+        Outlet winner;
+        Outlet loser;
+
+        template<typename Archive>
+        void serialize(Archive& ar, uint32_t const version) {
+            ar(id, winner, loser);
+        }
+    };
+
+    template<typename Archive>
+    void serialize(Archive& ar, uint32_t const version) {
+        ar(mMatches, mPlayers);
+    }
+
+private:
+    typedef std::array<std::optional<PlayerId>, 2> SlotPlayers; // White and blue
+
+    // Winner and loser of a finished match given its players. Both are empty while it is not finished
+    static std::pair<std::optional<PlayerId>, std::optional<PlayerId>> getAdvancingPlayers(const CategoryStore &category, const MatchStore &match, const SlotPlayers &players);
+
+    std::vector<std::unique_ptr<Action>> updateBracket(const CategoryStore &category) const;
+    std::vector<std::unique_ptr<Action>> updateOutlets(const CategoryStore &category) const;
+
+    std::vector<BracketMatch> mMatches;
+    std::vector<PlayerId> mPlayers;
+    std::unordered_map<MatchId, size_t> mMatchIndices; // Bracket index by match id. Rebuilt on demand after deserialization
+
+    // Which slots the next update recomputes. The slots themselves are derived
+    // from the category state, so stale entries only cause redundant work
+    mutable std::set<size_t> mChangedMatches;
+    mutable bool mInvalidated = true;
+};
+
+CEREAL_REGISTER_TYPE(KnockoutDrawSystem)
+CEREAL_REGISTER_POLYMORPHIC_RELATION(DrawSystem, KnockoutDrawSystem)
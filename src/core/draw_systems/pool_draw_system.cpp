@@ -1,5 +1,3 @@
-#include <cmath>
-
 #include "core/actions/add_match_action.hpp"
 #include "core/draw_systems/pool_draw_system.hpp"
 #include "core/rulesets/ruleset.hpp"
@@ -105,6 +103,7 @@ std::vector<std::unique_ptr<AddMatchAction>> PoolDrawSystem::initCategory(const
     // Assign player ids
     mPlayers = playerIds;
     mMatches.clear();
+    invalidateResults();
     if (mPlayers.size() <= 1)
         return {};
 
@@ -133,115 +132,6 @@ std::vector<std::unique_ptr<Action>> PoolDrawSystem::updateCategory(const Tourna
     return {};
 }
 
-// Rank a list of player by the number of won matches. Only mutual matches (fought between players both in the list) are counted.
-void PoolDrawSystem::orderByWinsWithinGroup(const CategoryStore &category, ResultList &results, const size_t begin, const size_t end) const {
-    if (end - begin < 2)
-        return; // Nothing to do
-
-    const Ruleset &ruleset = category.getRuleset();
-
-    std::unordered_set<PlayerId> playerIds;
-    for (size_t i = begin; i != end; ++i) {
-        playerIds.insert(results[i].first);
-    }
-
-    // Find number of mutual won matches
-    std::unordered_map<PlayerId,unsigned int> wonMatchesByPlayerId;
-    for (auto matchId : mMatches) {
-        const auto &match = category.getMatch(matchId);
-
-        const bool isMutualMatch = playerIds.find(match.getWhitePlayer().value()) != playerIds.end()
-            && playerIds.find(match.getBluePlayer().value()) != playerIds.end();
-        if (!isMutualMatch)
-            continue;
-
-        const MatchStore::PlayerIndex winnerIndex = ruleset.getWinner(match).value();
-        const PlayerId winningPlayer = match.getPlayer(winnerIndex).value();
-        wonMatchesByPlayerId[winningPlayer]++;
-    }
-
-    // Rank by mutual won matches
-    sort(results.begin() + begin, results.begin() + end, [&](const auto &a, const auto &b) {
-        return wonMatchesByPlayerId[a.first] > wonMatchesByPlayerId[b.first];
-    });
-
-    results[begin].second = begin+1;
-    for (size_t i = begin+1; i != end; ++i) {
-        const bool tiedWithPrevious = wonMatchesByPlayerId[results[i].first] == wonMatchesByPlayerId[results[i-1].first];
-        results[i].second = tiedWithPrevious
-            ? results[i-1].second.value()
-            : i+1;
-    }
-}
-
-void PoolDrawSystem::orderByRemainingCriteria(const TournamentStore &tournament, const CategoryStore &category, ResultList &results, size_t begin, size_t end) const {
-    if (end - begin < 2)
-        return; // Nothing to do
-
-    std::unordered_set<PlayerId> playerIds;
-    for (size_t i = begin; i != end; ++i) {
-        playerIds.insert(results[i].first);
-    }
-
-    bool allPlayersHaveWeight = true;
-    std::unordered_map<PlayerId, float> playerWeights;
-    for (const auto playerId : playerIds) {
-        const auto weight = tournament.getPlayer(playerId).getWeight();
-        if (!weight.has_value()) {
-            allPlayersHaveWeight = false;
-            break;
-        }
-
-        playerWeights[playerId] = weight.value().toFloat();
-    }
-
-    const Ruleset &ruleset = category.getRuleset();
-    std::unordered_map<PlayerId, std::chrono::milliseconds> winDuration;
-    std::unordered_map<PlayerId, unsigned int> ippons;
-    std::unordered_map<PlayerId, unsigned int> wazaris;
-    for (auto matchId : mMatches) {
-        const MatchStore &match = category.getMatch(matchId);
-        const MatchStore::PlayerIndex winner = ruleset.getWinner(match).value();
-        const PlayerId winningPlayerId = match.getPlayer(winner).value();
-
-        winDuration[winningPlayerId] += match.getDuration();
-
-        const auto &winnerScore = match.getScore(winner);
-        if (winnerScore.ippon)
-            ippons[winningPlayerId] += 1;
-        else
-            wazaris[winningPlayerId] += 1;
-    }
-
-    const auto comp = [&](const auto &a, const auto &b) {
-        const PlayerId first = a.first;
-        const PlayerId second = b.first;
-        if (ippons[first] != ippons[second])
-            return ippons[first] > ippons[second];
-        if (wazaris[first] != wazaris[second])
-            return wazaris[first] > wazaris[second];
-        if (winDuration[first] != winDuration[second])
-            return winDuration[first] < winDuration[second];
-
-        if (allPlayersHaveWeight) {
-            // Only compare by weight if all players have weight registered
-            const auto playerWeightsEqual = std::fabs(playerWeights[first] - playerWeights[second]) < 0.005;
-            if (!playerWeightsEqual) {
-                return playerWeights[first] < playerWeights[second];
-            }
-        }
-
-        return first < second;
-    };
-
-    std::sort(results.begin() + begin, results.begin() + end, comp);
-
-    size_t rank = begin+1;
-    for (auto it = results.begin() + begin; it != results.begin() + end; ++it, ++rank) {
-        it->second = rank;
-    }
-}
-
 DrawSystem::ResultList PoolDrawSystem::getResults(const TournamentStore &tournament, const CategoryStore &category) const {
     if (mPlayers.size() <= 1)
         return {};
@@ -250,46 +140,26 @@ DrawSystem::ResultList PoolDrawSystem::getResults(const TournamentStore &tournam
     if (!status.isFinished())
         return {};
 
-    ResultList results;
-    for (size_t i = 0; i < mPlayers.size(); ++i) {
-        const auto playerId = mPlayers[i];
-        results.emplace_back(playerId, i+1);
+    if (!mResults.has_value()) {
+        if (!mStandings.has_value())
+            mStandings.emplace(category, mPlayers, mMatches);
+        mResults = mStandings->rank(tournament);
     }
 
-    // First order by number of won matches
-    orderByWinsWithinGroup(category, results, 0, results.size());
-
-    // Find ties and order by number of mutual won matches within each tied group
-    {
-        size_t i = 0;
-        for (size_t j = 1; j <= results.size(); ++j) {
-            if (j != results.size() && results[j].second == results[j-1].second)
-                continue;
-
-            // There is a tie for indices [i:j)
-            orderByWinsWithinGroup(category, results, i, j);
-
-            // Start new group
-            i = j;
-        }
-    }
-
-    // Find ties and order by remaining criteria
-    {
-        size_t i = 0;
-        for (size_t j = 1; j <= results.size(); ++j) {
-            if (j != results.size() && results[j].second == results[j-1].second)
-                continue;
+    return *mResults;
+}
 
-            // There is a tie for indices [i:j)
-            orderByRemainingCriteria(tournament, category, results, i, j);
+void PoolDrawSystem::updateMatchResult(const CategoryStore &category, const MatchStore &match) {
+    mResults.reset();
 
-            // Start new group
-            i = j;
-        }
-    }
+    // Standings that have not been built yet are built from scratch once needed
+    if (mStandings.has_value())
+        mStandings->updateMatch(category, match);
+}
 
-    return results;
+void PoolDrawSystem::invalidateResults() {
+    mStandings.reset();
+    mResults.reset();
 }
 
 bool PoolDrawSystem::hasFinalBlock() const {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/draw_systems/draw_system.hpp"
+#include "core/draw_systems/pool_standings.hpp"
 #include "core/rulesets/ruleset.hpp"
 #include "core/serialize.hpp"
 
@@ -19,6 +20,8 @@ public:
     std::vector<std::unique_ptr<Action>> updateCategory(const TournamentStore &tournament, const CategoryStore &category) const override;
 
     ResultList getResults(const TournamentStore &tournament, const CategoryStore &category) const override;
+    void updateMatchResult(const CategoryStore &category, const MatchStore &match) override;
+    void invalidateResults() override;
 
     template<typename Archive>
     void serialize(Archive& ar, uint32_t const version) {
@@ -31,12 +34,13 @@ protected:
     std::vector<std::pair<PlayerId, PlayerId>> createMatchOrderForOddNumber(const std::vector<PlayerId> &playerIds);
 
 private:
-    void orderByWinsWithinGroup(const CategoryStore &category, ResultList &results, size_t begin, size_t end) const;
-    void orderByRemainingCriteria(const TournamentStore &tournament, const CategoryStore &category, ResultList &results, size_t begin, size_t end) const;
-
     std::vector<MatchId> mMatches;
     std::vector<PlayerId> mPlayers;
     bool mComposited;
+
+    // Cached results. These are not serialized and are built lazily on the first call to getResults
+    mutable std::optional<PoolStandings> mStandings;
+    mutable std::optional<ResultList> mResults;
 };
 
 CEREAL_REGISTER_TYPE(PoolDrawSystem)
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "core/draw_systems/pool_standings.hpp"
+#include "core/rulesets/ruleset.hpp"
+#include "core/stores/category_store.hpp"
+#include "core/stores/match_store.hpp"
+#include "core/stores/player_store.hpp"
+#include "core/stores/tournament_store.hpp"
+
+PoolStandings::PlayerStanding::PlayerStanding()
+    : wins(0)
+    , ippons(0)
+    , wazaris(0)
+    , winDuration(0)
+{}
+
+PoolStandings::PoolStandings(const CategoryStore &category, const std::vector<PlayerId> &playerIds, const std::vector<MatchId> &matchIds)
+    : mPlayerIds(playerIds)
+    , mOutcomes(matchIds.size())
+    , mStandings(playerIds.size())
+    , mMutualWins(playerIds.size() * playerIds.size(), 0)
+{
+    for (size_t i = 0; i < mPlayerIds.size(); ++i)
+        mPlayerIndices[mPlayerIds[i]] = i;
+
+    for (size_t i = 0; i < matchIds.size(); ++i)
+        mMatchIndices[matchIds[i]] = i;
+
+    for (auto matchId : matchIds)
+        updateMatch(category, category.getMatch(matchId));
+}
+
+void PoolStandings::updateMatch(const CategoryStore &category, const MatchStore &match) {
+    auto matchIt = mMatchIndices.find(match.getId());
+    if (matchIt == mMatchIndices.end())
+        return;
+
+    auto &outcome = mOutcomes[matchIt->second];
+    if (outcome.has_value()) {
+        removeOutcome(*outcome);
+        outcome.reset();
+    }
+
+    if (match.getStatus() != MatchStatus::FINISHED)
+        return;
+
+    const auto winner = category.getRuleset().getWinner(match);
+    if (!winner.has_value())
+        return;
+
+    const auto loser = (*winner == MatchStore::PlayerIndex::WHITE ? MatchStore::PlayerIndex::BLUE : MatchStore::PlayerIndex::WHITE);
+    const auto winningPlayer = match.getPlayer(*winner);
+    const auto losingPlayer = match.getPlayer(loser);
+    if (!winningPlayer.has_value() || !losingPlayer.has_value())
+        return;
+
+    auto winnerIt = mPlayerIndices.find(*winningPlayer);
+    auto loserIt = mPlayerIndices.find(*losingPlayer);
+    if (winnerIt == mPlayerIndices.end() || loserIt == mPlayerIndices.end())
+        return;
+
+    outcome = MatchOutcome{winnerIt->second, loserIt->second, match.getScore(*winner).ippon, match.getDuration()};
+    addOutcome(*outcome);
+}
+
+void PoolStandings::addOutcome(const MatchOutcome &outcome) {
+    auto &standing = mStandings[outcome.winner];
+
+    ++(standing.wins);
+    if (outcome.ippon)
+        ++(standing.ippons);
+    else
+        ++(standing.wazaris);
+    standing.winDuration += outcome.duration;
+
+    ++(mMutualWins[outcome.winner * mPlayerIds.size() + outcome.loser]);
+}
+
+void PoolStandings::removeOutcome(const MatchOutcome &outcome) {
+    auto &standing = mStandings[outcome.winner];
+
+    --(standing.wins);
+    if (outcome.ippon)
+        --(standing.ippons);
+    else
+        --(standing.wazaris);
+    standing.winDuration -= outcome.duration;
+
+    --(mMutualWins[outcome.winner * mPlayerIds.size() + outcome.loser]);
+}
+
+// Order players in [begin:end) by the given number of wins and assign shared ranks to ties
+void PoolStandings::orderByWins(std::vector<size_t> &order, std::vector<unsigned int> &ranks, const std::vector<unsigned int> &wins, size_t begin, size_t end) const {
+    if (end - begin < 2)
+        return; // Nothing to do
+
+    std::sort(order.begin() + begin, order.begin() + end, [&](size_t a, size_t b) {
+        return wins[a] > wins[b];
+    });
+
+    ranks[begin] = begin+1;
+    for (size_t i = begin+1; i != end; ++i) {
+        const bool tiedWithPrevious = wins[order[i]] == wins[order[i-1]];
+        ranks[i] = tiedWithPrevious ? ranks[i-1] : i+1;
+    }
+}
+
+void PoolStandings::orderByRemainingCriteria(const TournamentStore &tournament, std::vector<size_t> &order, std::vector<unsigned int> &ranks, size_t begin, size_t end) const {
+    if (end - begin < 2)
+        return; // Nothing to do
+
+    bool allPlayersHaveWeight = true;
+    std::vector<float> playerWeights(mPlayerIds.size(), 0);
+    for (size_t i = begin; i != end; ++i) {
+        const auto playerId = mPlayerIds[order[i]];
+        if (!tournament.containsPlayer(playerId) || !tournament.getPlayer(playerId).getWeight().has_value()) {
+            allPlayersHaveWeight = false;
+            break;
+        }
+
+        playerWeights[order[i]] = tournament.getPlayer(playerId).getWeight()->toFloat();
+    }
+
+    const auto comp = [&](size_t first, size_t second) {
+        const auto &a = mStandings[first];
+        const auto &b = mStandings[second];
+        if (a.ippons != b.ippons)
+            return a.ippons > b.ippons;
+        if (a.wazaris != b.wazaris)
+            return a.wazaris > b.wazaris;
+        if (a.winDuration != b.winDuration)
+            return a.winDuration < b.winDuration;
+
+        if (allPlayersHaveWeight) {
+            // Only compare by weight if all players have weight registered
+            const auto playerWeightsEqual = std::fabs(playerWeights[first] - playerWeights[second]) < 0.005;
+            if (!playerWeightsEqual)
+                return playerWeights[first] < playerWeights[second];
+        }
+
+        return mPlayerIds[first] < mPlayerIds[second];
+    };
+
+    std::sort(order.begin() + begin, order.begin() + end, comp);
+
+    for (size_t i = begin; i != end; ++i)
+        ranks[i] = i+1;
+}
+
+DrawSystem::ResultList PoolStandings::rank(const TournamentStore &tournament) const {
+    const size_t n = mPlayerIds.size();
+
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<unsigned int> ranks(n);
+    for (size_t i = 0; i < n; ++i)
+        ranks[i] = i+1;
+
+    // First order by number of won matches
+    std::vector<unsigned int> wins(n);
+    for (size_t i = 0; i < n; ++i)
+        wins[i] = mStandings[i].wins;
+    orderByWins(order, ranks, wins, 0, n);
+
+    // Find ties and order by number of mutual won matches within each tied group
+    for (size_t i = 0, j = 1; j <= n; ++j) {
+        if (j != n && ranks[j] == ranks[j-1])
+            continue;
+
+        // There is a tie for indices [i:j)
+        if (j - i > 1) {
+            for (size_t k = i; k != j; ++k) {
+                wins[order[k]] = 0;
+                for (size_t l = i; l != j; ++l)
+                    wins[order[k]] += mMutualWins[order[k] * n + order[l]];
+            }
+
+            orderByWins(order, ranks, wins, i, j);
+        }
+
+        // Start new group
+        i = j;
+    }
+
+    // Find ties and order by remaining criteria
+    for (size_t i = 0, j = 1; j <= n; ++j) {
+        if (j != n && ranks[j] == ranks[j-1])
+            continue;
+
+        // There is a tie for indices [i:j)
+        orderByRemainingCriteria(tournament, order, ranks, i, j);
+
+        // Start new group
+        i = j;
+    }
+
+    DrawSystem::ResultList results;
+    results.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        results.emplace_back(mPlayerIds[order[i]], ranks[i]);
+
+    return results;
+}
+
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "core/core.hpp"
+#include "core/draw_systems/draw_system.hpp"
+#include "core/id.hpp"
+
+class CategoryStore;
+class MatchStore;
+class TournamentStore;
+
+// Accumulated standings of a pool. Kept up to date by feeding it the matches
+// whose results change, such that ranking the pool never rescans its matches.
+class PoolStandings {
+public:
+    PoolStandings(const CategoryStore &category, const std::vector<PlayerId> &playerIds, const std::vector<MatchId> &matchIds);
+
+    // Recompute the contribution of a single match. Matches outside the pool are ignored
+    void updateMatch(const CategoryStore &category, const MatchStore &match);
+
+    // Rank the players. Assumes that all pool matches are finished
+    DrawSystem::ResultList rank(const TournamentStore &tournament) const;
+
+private:
+    struct MatchOutcome {
+        size_t winner;
+        size_t loser;
+        bool ippon;
+        std::chrono::milliseconds duration;
+    };
+
+    struct PlayerStanding {
+        PlayerStanding();
+
+        unsigned int wins;
+        unsigned int ippons;
+        unsigned int wazaris;
+        std::chrono::milliseconds winDuration;
+    };
+
+    void addOutcome(const MatchOutcome &outcome);
+    void removeOutcome(const MatchOutcome &outcome);
+    void orderByWins(std::vector<size_t> &order, std::vector<unsigned int> &ranks, const std::vector<unsigned int> &wins, size_t begin, size_t end) const;
+    void orderByRemainingCriteria(const TournamentStore &tournament, std::vector<size_t> &order, std::vector<unsigned int> &ranks, size_t begin, size_t end) const;
+
+    std::vector<PlayerId> mPlayerIds;
+    std::unordered_map<PlayerId, size_t> mPlayerIndices;
+    std::unordered_map<MatchId, size_t> mMatchIndices;
+    std::vector<std::optional<MatchOutcome>> mOutcomes;
+    std::vector<PlayerStanding> mStandings;
+    std::vector<unsigned int> mMutualWins; // mMutualWins[i * n + j] is the number of wins of player i over player j
+};
+
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#include "core/misc/auto_categorizer.hpp"
+#include "core/misc/thread_pool.hpp"
+#include "core/stores/player_store.hpp"
+#include "core/stores/tournament_store.hpp"
+
+AutoCategorizer::AutoCategorizer(float maxDifference, size_t maxSize, unsigned int ageBandWidth)
+    : mMaxDifference(maxDifference)
+    , mMaxSize(std::max<size_t>(1, maxSize))
+    , mAgeBandWidth(ageBandWidth)
+{}
+
+std::vector<AutoCategorizer::Entry> AutoCategorizer::getEntries(const TournamentStore &tournament, const std::vector<PlayerId> &playerIds) {
+    std::vector<Entry> entries;
+    entries.reserve(playerIds.size());
+
+    for (auto playerId : playerIds) {
+        if (!tournament.containsPlayer(playerId))
+            continue;
+        const PlayerStore &player = tournament.getPlayer(playerId);
+        if (!player.getWeight())
+            continue;
+
+        entries.push_back({playerId, player.getWeight()->toFloat(), player.getSex(), player.getAge()});
+    }
+
+    return entries;
+}
+
+std::optional<AutoCategorizer::Groups> AutoCategorizer::run(std::vector<Entry> entries, const std::atomic<bool> *cancelled, const ProgressCallback &progress) const {
+    // Partition by sex and age band. Players with unknown sex or age form their own partitions.
+    // The map keeps the partitions in a deterministic order
+    std::map<std::pair<int, int>, std::vector<Entry>> partitionMap;
+    for (const Entry &entry : entries) {
+        const int sex = (entry.sex ? entry.sex->toInt() : -1);
+        const int ageBand = ((mAgeBandWidth > 0 && entry.age) ? entry.age->toInt() / static_cast<int>(mAgeBandWidth) : -1);
+        partitionMap[{sex, ageBand}].push_back(entry);
+    }
+
+    std::vector<std::vector<Entry>> partitions;
+    partitions.reserve(partitionMap.size());
+    for (auto &pair : partitionMap)
+        partitions.push_back(std::move(pair.second));
+
+    const size_t total = entries.size();
+    std::mutex progressMutex;
+    size_t processed = 0;
+    auto advance = [&](size_t count) {
+        if (!progress)
+            return;
+        std::lock_guard<std::mutex> lock(progressMutex);
+        processed += count;
+        progress(processed, total);
+    };
+
+    std::vector<Groups> partitionGroups(partitions.size());
+    std::vector<char> solved(partitions.size(), false);
+    ThreadPool::getInstance().parallelFor(partitions.size(), [&](size_t i) {
+        solved[i] = solvePartition(partitions[i], partitionGroups[i], cancelled, advance);
+    });
+
+    if (std::find(solved.begin(), solved.end(), false) != solved.end())
+        return std::nullopt;
+
+    Groups groups;
+    for (Groups &partition : partitionGroups) {
+        for (auto &group : partition)
+            groups.push_back(std::move(group));
+    }
+
+    return groups;
+}
+
+bool AutoCategorizer::solvePartition(std::vector<Entry> &entries, Groups &groups, const std::atomic<bool> *cancelled, const std::function<void(size_t)> &advance) const {
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        if (a.weight != b.weight)
+            return a.weight < b.weight;
+        return a.playerId < b.playerId;
+    });
+
+    const size_t n = entries.size();
+    const size_t maxSize = std::min(mMaxSize, n);
+    const size_t stride = maxSize + 1;
+
+    // The best solution for the suffix starting at i is summarized by a histogram
+    // of its category sizes, stored in one flat buffer. Solutions are compared by
+    // their sorted sizes, where the one with the larger smallest category wins.
+    // This equals comparing the histograms from the smallest size upwards. As in
+    // the original solver, a solution whose sizes are a prefix of the other's
+    // does not win, so the candidate with the smaller first category is kept.
+    std::vector<uint32_t> histograms(stride * (n + 1), 0);
+    std::vector<size_t> next(n + 1, n);
+
+    auto count = [&](size_t suffix, size_t extraSize, size_t size) {
+        return histograms[suffix * stride + size] + (size == extraSize ? 1 : 0);
+    };
+
+    auto isBetter = [&](size_t sizeA, size_t suffixA, size_t sizeB, size_t suffixB) {
+        for (size_t size = 1; size <= maxSize; ++size) {
+            const auto a = count(suffixA, sizeA, size);
+            const auto b = count(suffixB, sizeB, size);
+            if (a == b)
+                continue;
+            if (a > b)
+                return false;
+
+            // A only wins if it has larger categories where B ran out of smaller ones
+            for (size_t larger = size + 1; larger <= maxSize; ++larger) {
+                if (count(suffixA, sizeA, larger) > 0)
+                    return true;
+            }
+            return false;
+        }
+        return false;
+    };
+
+    constexpr size_t PROGRESS_INTERVAL = 256;
+    for (size_t k = n; k > 0; --k) {
+        const size_t i = k - 1;
+
+        if (cancelled != nullptr && cancelled->load(std::memory_order_relaxed))
+            return false;
+
+        // A category of a single player is always valid, so a solution always exists
+        size_t bestSize = 1;
+        for (size_t j = i + 1; j < n; ++j) {
+            const size_t size = j - i + 1;
+            if (size > maxSize)
+                break;
+
+            const double diff = 100.0 * (entries[j].weight - entries[i].weight) / entries[j].weight;
+            if (diff > mMaxDifference)
+                break;
+
+            if (isBetter(size, j + 1, bestSize, i + bestSize))
+                bestSize = size;
+        }
+
+        next[i] = i + bestSize;
+        std::copy_n(histograms.begin() + next[i] * stride, stride, histograms.begin() + i * stride);
+        ++histograms[i * stride + bestSize];
+
+        if ((n - i) % PROGRESS_INTERVAL == 0)
+            advance(PROGRESS_INTERVAL);
+    }
+
+    advance(n % PROGRESS_INTERVAL);
+
+    for (size_t i = 0; i < n; i = next[i]) {
+        std::vector<PlayerId> group;
+        group.reserve(next[i] - i);
+        for (size_t j = i; j < next[i]; ++j)
+            group.push_back(entries[j].playerId);
+        groups.push_back(std::move(group));
+    }
+
+    return true;
+}
+
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "core/id.hpp"
+#include "core/stores/player_age.hpp"
+#include "core/stores/player_sex.hpp"
+
+class TournamentStore;
+
+// Groups players into weight categories. Players are first partitioned by sex
+// and age band. Each partition is then split into consecutive weight ranges
+// such that the smallest categories are as large as possible, subject to the
+// maximum weight difference and category size. Partitions are solved in parallel.
+class AutoCategorizer {
+public:
+    struct Entry {
+        PlayerId playerId;
+        float weight;
+        std::optional<PlayerSex> sex;
+        std::optional<PlayerAge> age;
+    };
+
+    typedef std::vector<std::vector<PlayerId>> Groups;
+    typedef std::function<void(size_t processed, size_t total)> ProgressCallback;
+
+    // An age band width of zero disables partitioning by age
+    AutoCategorizer(float maxDifference, size_t maxSize, unsigned int ageBandWidth = 0);
+
+    // Snapshot the fields used for grouping. Players without a weight are skipped
+    static std::vector<Entry> getEntries(const TournamentStore &tournament, const std::vector<PlayerId> &playerIds);
+
+    // Returns std::nullopt if cancelled before completion. The progress callback
+    // may be invoked from any thread and must be thread-safe
+    std::optional<Groups> run(std::vector<Entry> entries, const std::atomic<bool> *cancelled = nullptr, const ProgressCallback &progress = ProgressCallback()) const;
+
+private:
+    bool solvePartition(std::vector<Entry> &entries, Groups &groups, const std::atomic<bool> *cancelled, const std::function<void(size_t)> &advance) const;
+
+    float mMaxDifference;
+    size_t mMaxSize;
+    unsigned int mAgeBandWidth;
+};
+
@@ -0,0 +1,35 @@
+#include <mutex>
+#include <unordered_set>
+
+#include "core/misc/interned_string.hpp"
+
+InternedString::InternedString()
+    : mValue(intern(std::string()))
+{}
+
+InternedString::InternedString(const std::string &str)
+    : mValue(intern(str))
+{}
+
+const std::string & InternedString::get() const {
+    return *mValue;
+}
+
+bool InternedString::operator==(const InternedString &other) const {
+    return mValue == other.mValue;
+}
+
+bool InternedString::operator!=(const InternedString &other) const {
+    return mValue != other.mValue;
+}
+
+const std::string * InternedString::intern(const std::string &str) {
+    // Elements of an unordered_set are never relocated, so pointers into the pool stay valid
+    static std::unordered_set<std::string> pool;
+    static std::mutex mutex;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = pool.insert(str).first;
+    return &(*it);
+}
+
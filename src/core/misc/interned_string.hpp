@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+
+#include "core/serialize.hpp"
+
+// Immutable string whose contents are shared through a process-wide pool.
+// Copies are pointer copies. Intended for small sets of recurring strings such as match titles.
+class InternedString {
+public:
+    InternedString();
+    InternedString(const std::string &str);
+
+    const std::string & get() const;
+
+    bool operator==(const InternedString &other) const;
+    bool operator!=(const InternedString &other) const;
+
+    template<typename Archive>
+    void save(Archive& ar) const {
+        ar(*mValue);
+    }
+
+    template<typename Archive>
+    void load(Archive& ar) {
+        std::string str;
+        ar(str);
+        mValue = intern(str);
+    }
+
+private:
+    static const std::string * intern(const std::string &str);
+
+    const std::string *mValue;
+};
+
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "core/serialize.hpp"
+
+// Vector-like container storing up to N elements inline before falling back to the heap.
+// Only trivially copyable element types are supported.
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector only supports trivially copyable types");
+public:
+    typedef T value_type;
+    typedef T * iterator;
+    typedef const T * const_iterator;
+
+    SmallVector()
+        : mSize(0)
+        , mCapacity(N)
+    {}
+
+    SmallVector(const SmallVector &other)
+        : SmallVector()
+    {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector &&other) noexcept
+        : SmallVector()
+    {
+        *this = std::move(other);
+    }
+
+    SmallVector & operator=(const SmallVector &other) {
+        if (this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+
+    SmallVector & operator=(SmallVector &&other) noexcept {
+        if (this == &other)
+            return *this;
+
+        if (other.mHeap) {
+            mHeap = std::move(other.mHeap);
+            mCapacity = other.mCapacity;
+        }
+        else {
+            mHeap.reset();
+            mCapacity = N;
+            std::copy(other.mInline, other.mInline + other.mSize, mInline);
+        }
+
+        mSize = other.mSize;
+        other.mSize = 0;
+        other.mCapacity = N;
+        return *this;
+    }
+
+    template <typename Iterator>
+    void assign(Iterator first, Iterator last) {
+        clear();
+        reserve(static_cast<size_t>(std::distance(first, last)));
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity <= mCapacity)
+            return;
+
+        auto heap = std::make_unique<T[]>(capacity);
+        std::copy(begin(), end(), heap.get());
+        mHeap = std::move(heap);
+        mCapacity = capacity;
+    }
+
+    void push_back(const T &value) {
+        if (mSize == mCapacity)
+            reserve(2 * mCapacity);
+        data()[mSize++] = value;
+    }
+
+    void pop_back() {
+        assert(mSize > 0);
+        --mSize;
+    }
+
+    void clear() {
+        mSize = 0;
+    }
+
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+    size_t capacity() const { return mCapacity; }
+
+    T * data() { return mHeap ? mHeap.get() : mInline; }
+    const T * data() const { return mHeap ? mHeap.get() : mInline; }
+
+    T & operator[](size_t index) { return data()[index]; }
+    const T & operator[](size_t index) const { return data()[index]; }
+
+    T & back() { return data()[mSize - 1]; }
+    const T & back() const { return data()[mSize - 1]; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + mSize; }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + mSize; }
+
+private:
+    T mInline[N];
+    std::unique_ptr<T[]> mHeap;
+    size_t mSize;
+    size_t mCapacity;
+};
+
+namespace cereal {
+    // Serialized in the same layout as std::vector<T> so the two are interchangeable on disk
+    template <class Archive, typename T, size_t N> inline
+    void CEREAL_SAVE_FUNCTION_NAME(Archive& ar, const SmallVector<T, N>& vector)
+    {
+        ar(make_size_tag(static_cast<size_type>(vector.size())));
+        for (const T &element : vector)
+            ar(element);
+    }
+
+    template <class Archive, typename T, size_t N> inline
+    void CEREAL_LOAD_FUNCTION_NAME(Archive& ar, SmallVector<T, N>& vector)
+    {
+        size_type size;
+        ar(make_size_tag(size));
+
+        vector.clear();
+        vector.reserve(static_cast<size_t>(size));
+        for (size_type i = 0; i < size; ++i) {
+            T element;
+            ar(element);
+            vector.push_back(element);
+        }
+    }
+} // namespace cereal
+
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+#include "core/misc/thread_pool.hpp"
+
+ThreadPool::ThreadPool(size_t workerCount)
+    : mStopping(false)
+{
+    for (size_t i = 0; i < workerCount; ++i)
+        mWorkers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+
+    mCondition.notify_all();
+    for (std::thread &worker : mWorkers)
+        worker.join();
+}
+
+size_t ThreadPool::getWorkerCount() const {
+    return mWorkers.size();
+}
+
+ThreadPool & ThreadPool::getInstance() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void ThreadPool::work() {
+    while (true) {
+        std::function<void()> job;
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return mStopping || !mJobs.empty(); });
+
+            if (mJobs.empty()) // stopping
+                return;
+
+            job = std::move(mJobs.front());
+            mJobs.pop();
+        }
+
+        job();
+    }
+}
+
+namespace {
+    // State shared between the caller and the helpers of a single parallelFor call.
+    // Helpers may start after the call has returned, in which case they find no work left
+    struct ParallelForState {
+        ParallelForState(size_t count, const std::function<void(size_t)> &task)
+            : count(count)
+            , task(task)
+            , next(0)
+            , finished(0)
+        {}
+
+        const size_t count;
+        const std::function<void(size_t)> task;
+        std::atomic<size_t> next;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t finished;
+        std::exception_ptr exception;
+
+        void run() {
+            while (true) {
+                const size_t index = next++;
+                if (index >= count)
+                    return;
+
+                std::exception_ptr caught;
+                try {
+                    task(index);
+                }
+                catch (...) {
+                    caught = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (caught && !exception)
+                    exception = caught;
+                if (++finished == count)
+                    condition.notify_all();
+            }
+        }
+    };
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &task) {
+    if (count == 0)
+        return;
+
+    if (count == 1 || mWorkers.empty()) {
+        for (size_t i = 0; i < count; ++i)
+            task(i);
+        return;
+    }
+
+    auto state = std::make_shared<ParallelForState>(count, task);
+
+    const size_t helperCount = std::min(count - 1, mWorkers.size());
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (size_t i = 0; i < helperCount; ++i)
+            mJobs.push([state]() { state->run(); });
+    }
+    mCondition.notify_all();
+
+    state->run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&state]() { return state->finished == state->count; });
+
+    if (state->exception)
+        std::rethrow_exception(state->exception);
+}
+
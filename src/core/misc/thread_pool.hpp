@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for short-lived, CPU-bound jobs such as drawing
+// categories. The calling thread takes part in the work, so parallelFor may be
+// called from within a job without deadlocking.
+class ThreadPool {
+public:
+    ThreadPool(size_t workerCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool & operator=(const ThreadPool &) = delete;
+
+    // Run task(i) for every i in [0, count) and block until all have finished.
+    // The first exception thrown by a task is rethrown on the calling thread
+    void parallelFor(size_t count, const std::function<void(size_t)> &task);
+
+    size_t getWorkerCount() const;
+
+    // Process-wide pool sized after the hardware concurrency
+    static ThreadPool & getInstance();
+
+private:
+    void work();
+
+    std::vector<std::thread> mWorkers;
+    std::queue<std::function<void()>> mJobs;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStopping;
+};
+
@@ -322,6 +322,10 @@ std::ostream &operator<<(std::ostream &o, NetworkMessage::Type type) {
         return o << "CLOCK_SYNC";
     if (type == NetworkMessage::Type::CLOCK_SYNC_REQUEST)
         return o << "CLOCK_SYNC_REQUEST";
+    if (type == NetworkMessage::Type::WEB_ACTION_LIST)
+        return o << "WEB_ACTION_LIST";
+    if (type == NetworkMessage::Type::WEB_RESUME)
+        return o << "WEB_RESUME";
     return o << "INVALID";
 }
 
@@ -344,3 +348,21 @@ void NetworkMessage::encodeClockSyncRequest() {
     encodeHeader();
 }
 
+void NetworkMessage::encodeWebActionList(const std::vector<ClientActionId> &actionIds) {
+    mType = Type::WEB_ACTION_LIST;
+    std::tie(mBody, mUncompressedSize) = serializeAndCompress(actionIds);
+
+    encodeHeader();
+}
+
+bool NetworkMessage::decodeWebActionList(std::vector<ClientActionId> &actionIds) {
+    return deserializeAndCompress(mUncompressedSize, mBody, actionIds);
+}
+
+void NetworkMessage::encodeWebResume() {
+    mType = Type::WEB_RESUME;
+    mBody.clear();
+    mUncompressedSize = 0;
+
+    encodeHeader();
+}
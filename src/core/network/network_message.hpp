@@ -5,6 +5,7 @@
 #include <optional>
 #include <sstream>
 #include <variant>
+#include <vector>
 
 #include <boost/asio/buffer.hpp>
 
@@ -39,6 +40,8 @@ public:
         REGISTER_WEB_NAME_RESPONSE,
         CHECK_WEB_NAME,
         CHECK_WEB_NAME_RESPONSE,
+        WEB_ACTION_LIST, // The web server's applied actions. Sent before the upload starts
+        WEB_RESUME, // The upload continues from the web server's actions instead of syncing
     };
 
     NetworkMessage();
@@ -99,6 +102,11 @@ public:
 
     void encodeClockSyncRequest();
 
+    void encodeWebActionList(const std::vector<ClientActionId> &actionIds);
+    bool decodeWebActionList(std::vector<ClientActionId> &actionIds);
+
+    void encodeWebResume();
+
     void encodeClockSync(const std::chrono::milliseconds &time);
     bool decodeClockSync(std::chrono::milliseconds &time);
 
@@ -19,6 +19,7 @@ CategoryStore::CategoryStore(const CategoryStore &other)
     : mId(other.mId)
     , mName(other.mName)
     , mPlayers(other.mPlayers)
+    , mMatches(other.mMatches)
     , mMatchMap(other.mMatchMap)
     , mMatchCount(other.mMatchCount)
     , mStatus(other.mStatus)
@@ -26,10 +27,7 @@ CategoryStore::CategoryStore(const CategoryStore &other)
     , mRuleset(other.mRuleset->clone())
     , mDrawSystem(other.mDrawSystem->clone())
     , mMatchesHidden(other.mMatchesHidden)
-{
-    for (const auto & match : other.mMatches)
-        mMatches.push_back(std::make_unique<MatchStore>(*match));
-}
+{}
 
 const std::unordered_set<PlayerId> & CategoryStore::getPlayers() const {
     return mPlayers;
@@ -61,6 +59,8 @@ const CategoryId & CategoryStore::getId() const {
 std::unique_ptr<Ruleset> CategoryStore::setRuleset(std::unique_ptr<Ruleset> ptr) {
     auto old = std::move(mRuleset);
     mRuleset = std::move(ptr);
+    if (mDrawSystem)
+        mDrawSystem->invalidateResults(); // Winners are decided by the ruleset
     return old;
 }
 
@@ -75,6 +75,7 @@ const Ruleset & CategoryStore::getRuleset() const {
 std::unique_ptr<DrawSystem> CategoryStore::setDrawSystem(std::unique_ptr<DrawSystem> ptr) {
     auto old = std::move(mDrawSystem);
     mDrawSystem = std::move(ptr);
+    mDrawSystem->invalidateResults();
     return old;
 }
 
@@ -101,13 +102,13 @@ CategoryStore::MatchList & CategoryStore::getMatches() {
 MatchStore & CategoryStore::getMatch(MatchId id) {
     auto it = mMatchMap.find(id);
     assert(it != mMatchMap.end());
-    return *(mMatches[it->second]);
+    return mMatches[it->second];
 }
 
 const MatchStore & CategoryStore::getMatch(MatchId id) const {
     auto it = mMatchMap.find(id);
     assert(it != mMatchMap.end());
-    return *(mMatches[it->second]);
+    return mMatches[it->second];
 }
 
 size_t CategoryStore::getMatchPosition(MatchId id) const {
@@ -116,23 +117,28 @@ size_t CategoryStore::getMatchPosition(MatchId id) const {
     return it->second;
 }
 
-void CategoryStore::pushMatch(std::unique_ptr<MatchStore> match) {
-    MatchId id = match->getId();
+void CategoryStore::reserveMatches(size_t count) {
+    mMatches.reserve(count);
+    mMatchMap.reserve(count);
+}
+
+void CategoryStore::pushMatch(MatchStore match) {
+    MatchId id = match.getId();
 
-    if (!match->isPermanentBye())
-        ++(mMatchCount[static_cast<int>(match->getType())]);
+    if (!match.isPermanentBye())
+        ++(mMatchCount[static_cast<int>(match.getType())]);
 
     mMatches.push_back(std::move(match));
     assert(mMatchMap.find(id) == mMatchMap.end());
     mMatchMap[id] = mMatches.size() - 1;
 }
 
-std::unique_ptr<MatchStore> CategoryStore::popMatch() {
-    std::unique_ptr<MatchStore> match = std::move(mMatches.back());
+MatchStore CategoryStore::popMatch() {
+    MatchStore match = std::move(mMatches.back());
     mMatches.pop_back();
 
-    mMatchMap.erase(match->getId());
-    --(mMatchCount[static_cast<int>(match->getType())]);
+    mMatchMap.erase(match.getId());
+    --(mMatchCount[static_cast<int>(match.getType())]);
 
     return match;
 }
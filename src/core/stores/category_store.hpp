@@ -8,14 +8,12 @@
 #include "core/core.hpp"
 #include "core/id.hpp"
 #include "core/serialize.hpp"
+#include "core/stores/match_store.hpp"
 #include "core/stores/tatami/location.hpp"
 
 class DrawSystem;
-class MatchStore;
 class Ruleset;
 
-enum class MatchType;
-
 struct CategoryStatus {
     CategoryStatus()
         : notStartedMatches(0)
@@ -41,7 +39,7 @@ CategoryStatus operator+(const CategoryStatus &a, const CategoryStatus &b);
 
 class CategoryStore {
 public:
-    typedef std::vector<std::unique_ptr<MatchStore>> MatchList;
+    typedef std::vector<MatchStore> MatchList; // matches are stored contiguously per category
     static constexpr std::chrono::milliseconds MIN_EXPECTED_DURATION = std::chrono::minutes(6); // TODO: Have a more robust way drawing very short categories
 
     CategoryStore() {}
@@ -58,8 +56,9 @@ public:
     MatchStore & getMatch(MatchId id);
     const MatchStore & getMatch(MatchId id) const;
     size_t getMatchPosition(MatchId id) const;
-    void pushMatch(std::unique_ptr<MatchStore> match);
-    std::unique_ptr<MatchStore> popMatch();
+    void pushMatch(MatchStore match);
+    void reserveMatches(size_t count);
+    MatchStore popMatch();
     bool containsMatch(MatchId id) const;
     MatchList clearMatches();
 
@@ -87,8 +86,36 @@ public:
     void setStatus(MatchType type, const CategoryStatus &status);
 
     template<typename Archive>
-    void serialize(Archive& ar, uint32_t const version) {
-        ar(mId, mName, mPlayers, mMatches, mMatchMap, mMatchCount, mStatus, mLocation, mRuleset, mDrawSystem, mMatchesHidden);
+    void save(Archive& ar, uint32_t const version) const {
+        ar(mId, mName, mPlayers);
+
+        // Matches are written in the layout of the former std::vector<std::unique_ptr<MatchStore>>
+        // in order to stay compatible with existing save files
+        ar(cereal::make_size_tag(static_cast<cereal::size_type>(mMatches.size())));
+        for (const MatchStore &match : mMatches)
+            ar(uint8_t(1), match);
+
+        ar(mMatchMap, mMatchCount, mStatus, mLocation, mRuleset, mDrawSystem, mMatchesHidden);
+    }
+
+    template<typename Archive>
+    void load(Archive& ar, uint32_t const version) {
+        ar(mId, mName, mPlayers);
+
+        cereal::size_type size;
+        ar(cereal::make_size_tag(size));
+        mMatches.clear();
+        mMatches.reserve(static_cast<size_t>(size));
+        for (cereal::size_type i = 0; i < size; ++i) {
+            uint8_t valid;
+            ar(valid);
+            if (!valid)
+                throw cereal::Exception("Unexpected null match in category");
+            mMatches.emplace_back();
+            ar(mMatches.back());
+        }
+
+        ar(mMatchMap, mMatchCount, mStatus, mLocation, mRuleset, mDrawSystem, mMatchesHidden);
     }
 
     std::chrono::milliseconds expectedDuration(MatchType type) const;
@@ -22,17 +22,6 @@ MatchStore::MatchStore(const CombinedId &combinedId, MatchType type, const std::
     mPlayers[static_cast<size_t>(PlayerIndex::BLUE)] = bluePlayer;
 }
 
-MatchStore::MatchStore(const MatchStore &other)
-    : mCombinedId(other.mCombinedId)
-    , mType(other.mType)
-    , mTitle(other.mTitle)
-    , mPermanentBye(other.mPermanentBye)
-    , mBye(other.mBye)
-    , mPlayers(other.mPlayers)
-    , mState(other.mState)
-    , mEvents(other.mEvents)
-{}
-
 bool MatchStore::isGoldenScore() const {
     return mState.goldenScore;
 }
@@ -45,7 +34,7 @@ std::optional<PlayerId> MatchStore::getPlayer(PlayerIndex index) const {
     return mPlayers[static_cast<size_t>(index)];
 }
 
-void MatchStore::pushEvent(const MatchEvent & event) {
+void MatchStore::pushEvent(const Event & event) {
     mEvents.push_back(event);
 }
 
@@ -53,11 +42,11 @@ void MatchStore::popEvent() {
     mEvents.pop_back();
 }
 
-const std::vector<MatchEvent>& MatchStore::getEvents() const {
+const MatchStore::EventList& MatchStore::getEvents() const {
     return mEvents;
 }
 
-std::vector<MatchEvent>& MatchStore::getEvents() {
+MatchStore::EventList& MatchStore::getEvents() {
     return mEvents;
 }
 
@@ -151,7 +140,7 @@ void MatchStore::setStatus(MatchStatus status) {
 }
 
 const std::string & MatchStore::getTitle() const {
-    return mTitle;
+    return mTitle.get();
 }
 
 void MatchStore::setDuration(std::chrono::milliseconds duration) {
@@ -219,8 +208,8 @@ void MatchStore::clearEvents() {
     mEvents.clear();
 }
 
-void MatchStore::setEvents(const std::vector<MatchEvent> &events) {
-    mEvents = events;
+void MatchStore::setEvents(EventList events) {
+    mEvents = std::move(events);
 }
 
 void MatchStore::clearState() {
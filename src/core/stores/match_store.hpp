@@ -6,6 +6,8 @@
 
 #include "core/core.hpp"
 #include "core/id.hpp"
+#include "core/misc/interned_string.hpp"
+#include "core/misc/small_vector.hpp"
 #include "core/serialize.hpp"
 
 class MatchStore;
@@ -19,7 +21,10 @@ enum class MatchStatus {
     NOT_STARTED, PAUSED, UNPAUSED, FINISHED
 };
 
-struct MatchEvent;
+enum class MatchEventType {
+    IPPON, WAZARI, SHIDO, HANSOKU_MAKE, IPPON_OSAEKOMI, WAZARI_OSAEKOMI,
+    CANCEL_IPPON, CANCEL_WAZARI, CANCEL_SHIDO, CANCEL_HANSOKU_MAKE,
+};
 
 class MatchStore {
 public:
@@ -27,6 +32,20 @@ public:
         WHITE, BLUE
     };
 
+    struct Event {
+        MatchEventType type;
+        PlayerIndex playerIndex;
+        std::chrono::milliseconds duration; // match duration at the time of the event
+
+        template<typename Archive>
+        void serialize(Archive& ar, uint32_t const version) {
+            ar(type, playerIndex, duration);
+        }
+    };
+
+    // Most matches only see a handful of events, so these are kept inline to avoid heap allocations
+    typedef SmallVector<Event, 8> EventList;
+
     struct Score {
         Score();
 
@@ -63,7 +82,10 @@ public:
     };
 
     MatchStore() {}
-    MatchStore(const MatchStore &other);
+    MatchStore(const MatchStore &other) = default;
+    MatchStore(MatchStore &&other) = default;
+    MatchStore & operator=(const MatchStore &other) = default;
+    MatchStore & operator=(MatchStore &&other) = default;
     MatchStore(const CombinedId &combinedId, MatchType type, const std::string &title, bool permanentBye, std::optional<PlayerId> whitePlayer, std::optional<PlayerId> bluePlayer);
 
     std::optional<PlayerId> getPlayer(PlayerIndex index) const;
@@ -88,12 +110,12 @@ public:
     bool isBye() const;
     void setBye(bool bye);
 
-    void pushEvent(const MatchEvent & event);
+    void pushEvent(const Event & event);
     void popEvent();
     void clearEvents();
-    const std::vector<MatchEvent>& getEvents() const;
-    std::vector<MatchEvent>& getEvents();
-    void setEvents(const std::vector<MatchEvent> &events);
+    const EventList& getEvents() const;
+    EventList& getEvents();
+    void setEvents(EventList events);
 
     void finish();
     bool isGoldenScore() const;
@@ -134,29 +156,15 @@ public:
 private:
     CombinedId mCombinedId;
     MatchType mType;
-    std::string mTitle;
+    InternedString mTitle; // titles are shared between most matches, e.g. "Pool" or "Final"
     bool mPermanentBye;
     bool mBye;
     std::array<std::optional<PlayerId>,2> mPlayers;
     State mState;
-    std::vector<MatchEvent> mEvents;
+    EventList mEvents;
 };
 
-enum class MatchEventType {
-    IPPON, WAZARI, SHIDO, HANSOKU_MAKE, IPPON_OSAEKOMI, WAZARI_OSAEKOMI,
-    CANCEL_IPPON, CANCEL_WAZARI, CANCEL_SHIDO, CANCEL_HANSOKU_MAKE,
-};
-
-struct MatchEvent {
-    MatchEventType type;
-    MatchStore::PlayerIndex playerIndex;
-    std::chrono::milliseconds duration; // match duration at the time of the event
-
-    template<typename Archive>
-    void serialize(Archive& ar, uint32_t const version) {
-        ar(type, playerIndex, duration);
-    }
-};
+typedef MatchStore::Event MatchEvent;
 
 std::ostream &operator<<(std::ostream &out, const MatchType &matchType);
 
@@ -14,6 +14,7 @@ PreferencesStore::PreferencesStore() {
     mPreferredDrawSystems.emplace_back(1, DrawSystemIdentifier::BEST_OF_THREE);
     mPreferredDrawSystems.emplace_back(3, DrawSystemIdentifier::POOL);
     mPreferredDrawSystems.emplace_back(6, DrawSystemIdentifier::DOUBLE_POOL);
+    mPreferredDrawSystems.emplace_back(9, DrawSystemIdentifier::KNOCKOUT);
     mScoreboardStyle = ScoreboardStylePreference::NATIONAL;
     mMatchCardStyle = MatchCardStylePreference::NATIONAL;
 }
@@ -15,7 +15,7 @@ ConstMatchIterator & ConstMatchIterator::operator++() {
 
 CombinedId ConstMatchIterator::operator*() {
     assert(mCurrentCategory != nullptr);
-    const auto matchId = mCurrentCategory->getMatches()[mCurrentMatch]->getId();
+    const auto matchId = mCurrentCategory->getMatches()[mCurrentMatch].getId();
     return CombinedId(mCurrentCategory->getId(), matchId);
 }
 
@@ -55,7 +55,7 @@ void ConstMatchIterator::loadMatch() {
             continue;
         }
 
-        const auto &match = *(mCurrentCategory->getMatches()[mCurrentMatch]);
+        const auto &match = mCurrentCategory->getMatches()[mCurrentMatch];
         if (match.isPermanentBye()) {
             ++mCurrentMatch;
             continue;
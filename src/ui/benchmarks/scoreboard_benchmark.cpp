@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QImage>
+
+#include "core/actions/add_category_action.hpp"
+#include "core/actions/add_category_with_players_action.hpp"
+#include "core/actions/add_players_action.hpp"
+#include "core/actions/add_players_to_category_action.hpp"
+#include "core/actions/change_scoreboard_style_preference_action.hpp"
+#include "core/actions/draw_categories_action.hpp"
+#include "core/actions/resume_match_action.hpp"
+#include "core/draw_systems/draw_system.hpp"
+#include "core/rulesets/ruleset.hpp"
+#include "core/stores/category_store.hpp"
+#include "ui/store_managers/client_store_manager.hpp"
+#include "ui/stores/qtournament_store.hpp"
+#include "ui/widgets/score_display_widget.hpp"
+
+// Renders the scoreboard of a running match offscreen with both painters.
+// Full frames rebuild the static layer like a match or player change does,
+// while dynamic frames only repaint the region invalidated by clock ticks
+
+class ProfiledDisplayWidget : public ScoreDisplayWidget {
+public:
+    using ScoreDisplayWidget::ScoreDisplayWidget;
+
+    const QRegion & getDynamicRegion() const {
+        return mScoreboardPainter->getDynamicRegion();
+    }
+};
+
+struct FrameTimes {
+    std::chrono::microseconds mean;
+    std::chrono::microseconds median;
+    std::chrono::microseconds worst;
+};
+
+template <typename Function>
+FrameTimes measureFrames(size_t frames, Function function) {
+    std::vector<std::chrono::microseconds> times;
+    for (size_t i = 0; i < frames; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+    }
+
+    std::sort(times.begin(), times.end());
+
+    std::chrono::microseconds total(0);
+    for (auto time : times)
+        total += time;
+
+    return {total / frames, times[frames / 2], times.back()};
+}
+
+void printFrameTimes(const std::string &painter, const std::string &frame, const FrameTimes &times) {
+    std::cout << std::left << std::setw(16) << painter << std::setw(10) << frame << std::right
+              << std::setw(12) << times.mean.count()
+              << std::setw(12) << times.median.count()
+              << std::setw(12) << times.worst.count()
+              << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    // Render without a display unless a platform was requested
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    app.setApplicationName("JudoAssistant Scoreboard Benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times offscreen rendering of the scoreboard");
+    parser.addHelpOption();
+    QCommandLineOption framesOption("frames", "Number of frames to render of each kind", "count", "500");
+    QCommandLineOption widthOption("width", "Width of the scoreboard", "pixels", "1920");
+    QCommandLineOption heightOption("height", "Height of the scoreboard", "pixels", "1080");
+    parser.addOption(framesOption);
+    parser.addOption(widthOption);
+    parser.addOption(heightOption);
+    parser.process(app);
+
+    bool framesOk = true, widthOk = true, heightOk = true;
+    const size_t frames = parser.value(framesOption).toUInt(&framesOk);
+    const int width = parser.value(widthOption).toInt(&widthOk);
+    const int height = parser.value(heightOption).toInt(&heightOk);
+    if (!framesOk || !widthOk || !heightOk || frames == 0 || width <= 0 || height <= 0) {
+        std::cerr << "Failed converting arguments to positive integers" << std::endl;
+        return 1;
+    }
+
+    // A single pool of two players gives the one match shown
+    ClientStoreManager storeManager;
+    auto &tournament = storeManager.getTournament();
+
+    std::vector<PlayerFields> fields(2);
+    fields[0].firstName = "Anna";
+    fields[0].lastName = "Jensen";
+    fields[0].club = "Odense Judo Klub";
+    fields[1].firstName = "Sara";
+    fields[1].lastName = "Hansen";
+    fields[1].club = "Aarhus Judo";
+    storeManager.dispatch(std::make_unique<AddPlayersAction>(tournament, fields));
+
+    std::vector<PlayerId> playerIds;
+    for (const auto &p : tournament.getPlayers())
+        playerIds.push_back(p.first);
+    storeManager.dispatch(std::make_unique<AddCategoryWithPlayersAction>(tournament, "U21 -63 kg", RulesetIdentifier::TWENTY_EIGHTEEN, DrawSystemIdentifier::POOL, playerIds));
+
+    const CategoryStore &category = *(tournament.getCategories().begin()->second);
+    const CombinedId combinedId = category.getMatches().front().getCombinedId();
+    storeManager.dispatch(std::make_unique<ResumeMatchAction>(combinedId, storeManager.masterTime()));
+
+    ProfiledDisplayWidget widget(storeManager);
+    widget.setAttribute(Qt::WA_DontShowOnScreen);
+    widget.resize(width, height);
+    widget.show();
+    widget.setMatch(combinedId, false);
+
+    QImage target(widget.size(), QImage::Format_ARGB32_Premultiplied);
+
+    std::cout << std::left << std::setw(16) << "painter" << std::setw(10) << "frame" << std::right
+              << std::setw(12) << "mean us"
+              << std::setw(12) << "median us"
+              << std::setw(12) << "max us"
+              << std::endl;
+
+    const std::vector<std::pair<ScoreboardStylePreference, std::string>> styles = {
+        {ScoreboardStylePreference::NATIONAL, "national"},
+        {ScoreboardStylePreference::INTERNATIONAL, "international"},
+    };
+
+    for (const auto &style : styles) {
+        storeManager.dispatch(std::make_unique<ChangeScoreboardStylePreferenceAction>(style.first));
+        app.processEvents();
+
+        const FrameTimes fullTimes = measureFrames(frames, [&]() {
+            widget.setState(ScoreDisplayState::NORMAL); // Drops the cached static layer
+            widget.render(&target);
+        });
+
+        widget.render(&target); // Rebuild the static layer before ticking
+        const FrameTimes dynamicTimes = measureFrames(frames, [&]() {
+            widget.render(&target, QPoint(), widget.getDynamicRegion());
+        });
+
+        printFrameTimes(style.second, "full", fullTimes);
+        printFrameTimes(style.second, "dynamic", dynamicTimes);
+    }
+
+    return 0;
+}
+
@@ -0,0 +1,116 @@
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+#include "core/actions/add_players_action.hpp"
+#include "core/stores/player_store.hpp"
+#include "ui/models/player_search_index.hpp"
+#include "ui/store_managers/client_store_manager.hpp"
+#include "ui/stores/qtournament_store.hpp"
+
+// Times the player search index over a generated tournament. Each query is
+// typed one character at a time and every keystroke is timed, next to the
+// linear scan over all players that the filter used before the index
+
+static const std::vector<std::string> FIRST_NAMES = {"Anders", "Anna", "Emil", "Freja", "Ida", "Jonas", "Karin", "Lars", "Mads", "Maria", "Mikkel", "Nanna", "Oliver", "Sara", "Søren", "Thomas"};
+static const std::vector<std::string> LAST_NAMES = {"Andersen", "Christensen", "Hansen", "Jensen", "Jørgensen", "Larsen", "Madsen", "Nielsen", "Olsen", "Pedersen", "Petersen", "Rasmussen", "Sørensen", "Thomsen"};
+static const std::vector<std::string> CLUBS = {"Aarhus Judo", "Esbjerg Judo Klub", "Fredericia Judo", "Holte Judo", "Judo Kolding", "Odense Judo Klub", "Randers Judo", "Vejle Judo", "Viborg Judo", "Aalborg Judo"};
+static const std::vector<QString> QUERIES = {"jensen", "Mikkel Hansen", "odense judo", "sen", "xyz"};
+
+std::vector<PlayerFields> generatePlayers(size_t count) {
+    std::mt19937 generator(0);
+    std::vector<PlayerFields> players(count);
+    for (PlayerFields &fields : players) {
+        fields.firstName = FIRST_NAMES[generator() % FIRST_NAMES.size()];
+        fields.lastName = LAST_NAMES[generator() % LAST_NAMES.size()];
+        fields.club = CLUBS[generator() % CLUBS.size()];
+    }
+
+    return players;
+}
+
+// The name and club match of the filter before the search index was added
+size_t scanPlayers(const QTournamentStore &tournament, const QString &text) {
+    size_t count = 0;
+    for (const auto &p : tournament.getPlayers()) {
+        const PlayerStore &player = *(p.second);
+        QString name = QString::fromStdString(player.getFirstName()) + " " + QString::fromStdString(player.getLastName());
+        if (name.contains(text, Qt::CaseInsensitive) || QString::fromStdString(player.getClub()).contains(text, Qt::CaseInsensitive))
+            ++count;
+    }
+
+    return count;
+}
+
+template <typename Function>
+std::chrono::microseconds measure(Function function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("JudoAssistant Search Benchmark");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times the player search index");
+    parser.addHelpOption();
+    QCommandLineOption playersOption("players", "Number of players to generate", "count", "20000");
+    parser.addOption(playersOption);
+    parser.process(app);
+
+    bool ok = true;
+    const size_t playerCount = parser.value(playersOption).toUInt(&ok);
+    if (!ok) {
+        std::cerr << "Failed converting players argument to int" << std::endl;
+        return 1;
+    }
+
+    ClientStoreManager storeManager;
+    storeManager.dispatch(std::make_unique<AddPlayersAction>(storeManager.getTournament(), generatePlayers(playerCount)));
+
+    std::unique_ptr<PlayerSearchIndex> index;
+    const auto buildTime = measure([&]() { index = std::make_unique<PlayerSearchIndex>(storeManager, nullptr); });
+    std::cout << "Indexed " << playerCount << " players in " << buildTime.count() << " us" << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(20) << "query" << std::right
+              << std::setw(10) << "matches"
+              << std::setw(12) << "index us"
+              << std::setw(12) << "scan us"
+              << std::endl;
+
+    const auto &tournament = storeManager.getTournament();
+    for (const QString &query : QUERIES) {
+        index->setQuery(QString());
+
+        for (int length = 1; length <= query.size(); ++length) {
+            const QString text = query.left(length);
+            const auto indexTime = measure([&]() { index->setQuery(text); });
+
+            size_t scanCount = 0;
+            const auto scanTime = measure([&]() { scanCount = scanPlayers(tournament, text); });
+
+            size_t count = 0;
+            for (const auto &p : tournament.getPlayers()) {
+                if (index->matches(p.first))
+                    ++count;
+            }
+
+            if (count != scanCount)
+                std::cerr << "Index and scan disagree on \"" << text.toStdString() << "\"" << std::endl;
+
+            std::cout << std::left << std::setw(20) << ("\"" + text.toStdString() + "\"") << std::right
+                      << std::setw(10) << count
+                      << std::setw(12) << indexTime.count()
+                      << std::setw(12) << scanTime.count()
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
+
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 namespace Constants {
     constexpr unsigned int WEB_PORT = 9000;
     constexpr char WEB_HOST[] = "live.judoassistant.com";
+    constexpr size_t MAX_UPLOAD_LOG_SIZE = 1000; // Actions and undos kept for resuming an interrupted upload
 }
 
@@ -2,10 +2,10 @@
 
 #include <QColor>
 #include <QBrush>
-#include <QTimer>
 
 #include "ui/delegates/match_delegate.hpp"
 #include "ui/models/category_matches_model.hpp"
+#include "ui/store_managers/match_ticker.hpp"
 #include "ui/store_managers/store_manager.hpp"
 #include "ui/stores/qtournament_store.hpp"
 
@@ -19,10 +19,7 @@ CategoryMatchesModel::CategoryMatchesModel(StoreManager &storeManager, QObject *
 
     connect(&mStoreManager, &StoreManager::tournamentAboutToBeReset, this, &CategoryMatchesModel::beginResetTournament);
     connect(&mStoreManager, &StoreManager::tournamentReset, this, &CategoryMatchesModel::endResetTournament);
-
-    auto timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, &CategoryMatchesModel::timerHit);
-    timer->start(TIMER_INTERVAL);
+    connect(&mStoreManager.getTicker(), &MatchTicker::secondTicked, this, &CategoryMatchesModel::secondTick);
 }
 
 void CategoryMatchesModel::beginResetMatches() {
@@ -36,16 +33,18 @@ void CategoryMatchesModel::beginResetMatches() {
     mPlayers.clear();
     mMatchPlayerMap.clear();
     mUnpausedMatches.clear();
+    mStoreManager.getTicker().unwatchMatches(this);
 }
 
 void CategoryMatchesModel::endResetMatches() {
     const auto &tournament = mStoreManager.getTournament();
+    auto &ticker = mStoreManager.getTicker();
     if (mCategoryId && tournament.containsCategory(*mCategoryId)) {
         const auto &category = tournament.getCategory(*mCategoryId);
 
-    for (auto & matchPtr : category.getMatches()) {
-            const auto &match = *matchPtr;
+        for (const auto &match : category.getMatches()) {
             auto matchId = match.getId();
+            ticker.watchMatch(this, match.getCombinedId(), TickRate::SECOND);
 
             mMatchesMap[matchId] = mMatches.size();
             mMatches.push_back(matchId);
@@ -221,7 +220,7 @@ void CategoryMatchesModel::changeMatches(CategoryId categoryId, const std::vecto
     }
 }
 
-void CategoryMatchesModel::timerHit() {
+void CategoryMatchesModel::secondTick() {
     for (MatchId matchId : mUnpausedMatches) {
         auto row = getRow(matchId);
         emit dataChanged(createIndex(row, 0), createIndex(row,0));
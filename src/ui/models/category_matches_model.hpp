@@ -21,7 +21,6 @@ class CategoryMatchesModel : public QAbstractTableModel {
     Q_OBJECT
 private:
     static const int COLUMN_COUNT = 1;
-    static constexpr auto TIMER_INTERVAL = std::chrono::milliseconds(1000);
 public:
     CategoryMatchesModel(StoreManager &storeManager, QObject *parent);
     void setCategory(std::optional<CategoryId> categoryId);
@@ -47,7 +46,7 @@ private:
     void beginResetMatches();
     void endResetMatches();
 
-    void timerHit();
+    void secondTick();
 
     StoreManager & mStoreManager;
     std::optional<CategoryId> mCategoryId;
@@ -0,0 +1,174 @@
+#include "core/stores/player_store.hpp"
+#include "ui/models/player_search_index.hpp"
+#include "ui/store_managers/store_manager.hpp"
+#include "ui/stores/qtournament_store.hpp"
+
+PlayerSearchIndex::PlayerSearchIndex(StoreManager &storeManager, QObject *parent)
+    : QObject(parent)
+    , mStoreManager(storeManager)
+{
+    tournamentAboutToBeReset();
+    tournamentReset();
+
+    connect(&mStoreManager, &StoreManager::tournamentAboutToBeReset, this, &PlayerSearchIndex::tournamentAboutToBeReset);
+    connect(&mStoreManager, &StoreManager::tournamentReset, this, &PlayerSearchIndex::tournamentReset);
+}
+
+void PlayerSearchIndex::setQuery(const QString &text) {
+    QString query = text.toCaseFolded();
+    if (query == mQuery)
+        return;
+
+    mQuery = query;
+    updateMatches();
+}
+
+bool PlayerSearchIndex::matches(PlayerId playerId) const {
+    return mMatches.find(playerId) != mMatches.end();
+}
+
+void PlayerSearchIndex::tournamentAboutToBeReset() {
+    while (!mConnections.empty()) {
+        disconnect(mConnections.top());
+        mConnections.pop();
+    }
+}
+
+void PlayerSearchIndex::tournamentReset() {
+    QTournamentStore & tournament = mStoreManager.getTournament();
+
+    mConnections.push(connect(&tournament, &QTournamentStore::playersAdded, this, &PlayerSearchIndex::playersAdded));
+    mConnections.push(connect(&tournament, &QTournamentStore::playersChanged, this, &PlayerSearchIndex::playersChanged));
+    mConnections.push(connect(&tournament, &QTournamentStore::playersAboutToBeErased, this, &PlayerSearchIndex::playersAboutToBeErased));
+    mConnections.push(connect(&tournament, &QTournamentStore::playersReset, this, &PlayerSearchIndex::playersReset));
+
+    loadPlayers();
+}
+
+void PlayerSearchIndex::playersAdded(const std::vector<PlayerId> &playerIds) {
+    for (auto playerId : playerIds) {
+        indexPlayer(playerId);
+        updateMatch(playerId);
+    }
+}
+
+void PlayerSearchIndex::playersChanged(const std::vector<PlayerId> &playerIds) {
+    for (auto playerId : playerIds) {
+        unindexPlayer(playerId);
+        indexPlayer(playerId);
+        updateMatch(playerId);
+    }
+}
+
+void PlayerSearchIndex::playersAboutToBeErased(const std::vector<PlayerId> &playerIds) {
+    for (auto playerId : playerIds) {
+        unindexPlayer(playerId);
+        mMatches.erase(playerId);
+    }
+}
+
+void PlayerSearchIndex::playersReset() {
+    loadPlayers();
+}
+
+void PlayerSearchIndex::loadPlayers() {
+    mEntries.clear();
+    mTrigrams.clear();
+
+    for (const auto & p : mStoreManager.getTournament().getPlayers())
+        indexPlayer(p.first);
+
+    updateMatches();
+}
+
+void PlayerSearchIndex::indexPlayer(PlayerId playerId) {
+    const PlayerStore &player = mStoreManager.getTournament().getPlayer(playerId);
+
+    Entry entry;
+    entry.name = (QString::fromStdString(player.getFirstName()) + " " + QString::fromStdString(player.getLastName())).toCaseFolded();
+    entry.club = QString::fromStdString(player.getClub()).toCaseFolded();
+
+    for (Trigram trigram : getTrigrams(entry))
+        mTrigrams[trigram].insert(playerId);
+
+    mEntries[playerId] = std::move(entry);
+}
+
+void PlayerSearchIndex::unindexPlayer(PlayerId playerId) {
+    auto it = mEntries.find(playerId);
+    if (it == mEntries.end())
+        return;
+
+    for (Trigram trigram : getTrigrams(it->second)) {
+        auto trigramIt = mTrigrams.find(trigram);
+        trigramIt->second.erase(playerId);
+        if (trigramIt->second.empty())
+            mTrigrams.erase(trigramIt);
+    }
+
+    mEntries.erase(it);
+}
+
+void PlayerSearchIndex::updateMatches() {
+    mMatches.clear();
+    if (mQuery.isEmpty())
+        return;
+
+    if (mQuery.size() < 3) {
+        // Too short to be indexed
+        for (const auto &it : mEntries) {
+            if (matchesQuery(it.second))
+                mMatches.insert(it.first);
+        }
+
+        return;
+    }
+
+    // Every match contains all trigrams of the query, so only the players
+    // containing the rarest one need to be checked
+    std::unordered_set<Trigram> trigrams;
+    addTrigrams(mQuery, trigrams);
+
+    const std::unordered_set<PlayerId> *candidates = nullptr;
+    for (Trigram trigram : trigrams) {
+        auto it = mTrigrams.find(trigram);
+        if (it == mTrigrams.end())
+            return;
+
+        if (candidates == nullptr || it->second.size() < candidates->size())
+            candidates = &(it->second);
+    }
+
+    for (PlayerId playerId : *candidates) {
+        if (matchesQuery(mEntries.at(playerId)))
+            mMatches.insert(playerId);
+    }
+}
+
+void PlayerSearchIndex::updateMatch(PlayerId playerId) {
+    if (!mQuery.isEmpty() && matchesQuery(mEntries.at(playerId)))
+        mMatches.insert(playerId);
+    else
+        mMatches.erase(playerId);
+}
+
+bool PlayerSearchIndex::matchesQuery(const Entry &entry) const {
+    return entry.name.contains(mQuery) || entry.club.contains(mQuery);
+}
+
+std::unordered_set<PlayerSearchIndex::Trigram> PlayerSearchIndex::getTrigrams(const Entry &entry) {
+    std::unordered_set<Trigram> trigrams;
+    addTrigrams(entry.name, trigrams);
+    addTrigrams(entry.club, trigrams);
+    return trigrams;
+}
+
+void PlayerSearchIndex::addTrigrams(const QString &text, std::unordered_set<Trigram> &trigrams) {
+    for (int i = 0; i + 3 <= text.size(); ++i) {
+        Trigram trigram = (static_cast<Trigram>(text[i].unicode()) << 32)
+                        | (static_cast<Trigram>(text[i+1].unicode()) << 16)
+                        | static_cast<Trigram>(text[i+2].unicode());
+        trigrams.insert(trigram);
+    }
+}
+
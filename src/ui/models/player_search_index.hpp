@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stack>
+#include <unordered_map>
+#include <unordered_set>
+#include <QMetaObject>
+#include <QObject>
+#include <QString>
+
+#include "core/id.hpp"
+
+class StoreManager;
+class PlayerStore;
+
+// Trigram index over case folded player names and clubs. The index is kept up
+// to date from the player signals of the tournament, together with the set of
+// players matching the current query, so typing only looks at candidates
+// sharing the query's rarest trigram
+class PlayerSearchIndex : public QObject {
+    Q_OBJECT
+public:
+    PlayerSearchIndex(StoreManager &storeManager, QObject *parent);
+
+    void setQuery(const QString &text);
+    bool matches(PlayerId playerId) const; // Whether the player's name or club contains the query
+
+private:
+    typedef uint64_t Trigram; // Three UTF-16 code units
+
+    struct Entry {
+        QString name; // "First Last"
+        QString club;
+    };
+
+    void tournamentAboutToBeReset();
+    void tournamentReset();
+    void playersAdded(const std::vector<PlayerId> &playerIds);
+    void playersChanged(const std::vector<PlayerId> &playerIds);
+    void playersAboutToBeErased(const std::vector<PlayerId> &playerIds);
+    void playersReset();
+
+    void loadPlayers();
+    void indexPlayer(PlayerId playerId);
+    void unindexPlayer(PlayerId playerId);
+    void updateMatches();
+    void updateMatch(PlayerId playerId);
+    bool matchesQuery(const Entry &entry) const;
+
+    static std::unordered_set<Trigram> getTrigrams(const Entry &entry);
+    static void addTrigrams(const QString &text, std::unordered_set<Trigram> &trigrams);
+
+    StoreManager &mStoreManager;
+    std::unordered_map<PlayerId, Entry> mEntries;
+    std::unordered_map<Trigram, std::unordered_set<PlayerId>> mTrigrams; // Players by trigram of their name or club
+    QString mQuery; // Case folded
+    std::unordered_set<PlayerId> mMatches;
+    std::stack<QMetaObject::Connection> mConnections;
+};
+
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include <QBrush>
 #include <QColor>
 
@@ -8,6 +10,7 @@
 #include "core/stores/match_store.hpp"
 #include "core/stores/player_store.hpp"
 #include "ui/misc/numerical_string_comparator.hpp"
+#include "ui/models/player_search_index.hpp"
 #include "ui/models/players_model.hpp"
 #include "ui/store_managers/store_manager.hpp"
 #include "ui/stores/qplayer_country.hpp"
@@ -27,7 +30,7 @@ PlayersModel::PlayersModel(StoreManager & storeManager, QObject * parent)
 }
 
 int PlayersModel::rowCount(const QModelIndex &parent) const {
-    return mStoreManager.getTournament().getPlayers().size();
+    return mIds.size();
 }
 
 int PlayersModel::columnCount(const QModelIndex &parent) const {
@@ -111,21 +114,31 @@ std::vector<PlayerId> PlayersModel::getPlayers(const QItemSelection &selection)
 }
 
 PlayerId PlayersModel::getPlayer(int row) const {
-    auto it = mIds.begin();
-    std::advance(it, row);
-    return *it;
+    return mIds[row];
 }
 
 int PlayersModel::getRow(PlayerId playerId) const {
-    return std::distance(mIds.begin(), mIds.lower_bound(playerId));
+    return std::distance(mIds.begin(), std::lower_bound(mIds.begin(), mIds.end(), playerId));
 }
 
 void PlayersModel::playersAdded(const std::vector<PlayerId> &playerIds) {
-    for (auto playerId : playerIds) {
-        int row = getRow(playerId);
-        beginInsertRows(QModelIndex(), row, row);
-        mIds.insert(playerId);
+    std::vector<PlayerId> ids(playerIds);
+    std::sort(ids.begin(), ids.end());
+
+    // Insert runs of players that end up on consecutive rows together
+    size_t i = 0;
+    while (i < ids.size()) {
+        auto pos = std::lower_bound(mIds.begin(), mIds.end(), ids[i]);
+        size_t j = i + 1;
+        while (j < ids.size() && (pos == mIds.end() || ids[j] < *pos))
+            ++j;
+
+        int row = std::distance(mIds.begin(), pos);
+        beginInsertRows(QModelIndex(), row, row + static_cast<int>(j - i) - 1);
+        mIds.insert(pos, ids.begin() + i, ids.begin() + j);
         endInsertRows();
+
+        i = j;
     }
 }
 
@@ -137,11 +150,24 @@ void PlayersModel::playersChanged(const std::vector<PlayerId> &playerIds) {
 }
 
 void PlayersModel::playersAboutToBeErased(const std::vector<PlayerId> &playerIds) {
-    for (auto playerId : playerIds) {
-        int row = getRow(playerId);
-        beginRemoveRows(QModelIndex(), row, row);
-        mIds.erase(playerId);
+    std::vector<int> rows;
+    rows.reserve(playerIds.size());
+    for (auto playerId : playerIds)
+        rows.push_back(getRow(playerId));
+    std::sort(rows.begin(), rows.end());
+
+    // Remove runs of consecutive rows, starting from the back so earlier rows stay valid
+    size_t j = rows.size();
+    while (j > 0) {
+        size_t i = j - 1;
+        while (i > 0 && rows[i-1] + 1 == rows[i])
+            --i;
+
+        beginRemoveRows(QModelIndex(), rows[i], rows[j-1]);
+        mIds.erase(mIds.begin() + rows[i], mIds.begin() + rows[j-1] + 1);
         endRemoveRows();
+
+        j = i;
     }
 }
 
@@ -151,11 +177,20 @@ void PlayersModel::playersAboutToBeReset() {
 }
 
 void PlayersModel::playersReset() {
-    for (const auto & p : mStoreManager.getTournament().getPlayers())
-        mIds.insert(p.first);
+    loadPlayers();
     endResetModel();
 }
 
+void PlayersModel::loadPlayers() {
+    const auto &players = mStoreManager.getTournament().getPlayers();
+
+    mIds.clear();
+    mIds.reserve(players.size());
+    for (const auto & p : players)
+        mIds.push_back(p.first);
+    std::sort(mIds.begin(), mIds.end());
+}
+
 void PlayersModel::tournamentAboutToBeReset() {
     beginResetModel();
 
@@ -168,9 +203,7 @@ void PlayersModel::tournamentAboutToBeReset() {
 void PlayersModel::tournamentReset() {
     QTournamentStore & tournament = mStoreManager.getTournament();
 
-    mIds.clear();
-    for (const auto & p : tournament.getPlayers())
-        mIds.insert(p.first);
+    loadPlayers();
 
     mConnections.push(connect(&tournament, &QTournamentStore::playersAdded, this, &PlayersModel::playersAdded));
     mConnections.push(connect(&tournament, &QTournamentStore::playersChanged, this, &PlayersModel::playersChanged));
@@ -241,10 +274,55 @@ PlayersProxyModel::PlayersProxyModel(StoreManager &storeManager, QObject *parent
     , mShowMale(true)
     , mShowFemale(true)
 {
+    // The index is created first so it is updated before the model signals player changes
+    mSearchIndex = new PlayerSearchIndex(storeManager, this);
     mModel = new PlayersModel(storeManager, this);
 
     setSourceModel(mModel);
     setSortRole(Qt::UserRole);
+
+    tournamentAboutToBeReset();
+    tournamentReset();
+
+    connect(&mStoreManager, &StoreManager::tournamentAboutToBeReset, this, &PlayersProxyModel::tournamentAboutToBeReset);
+    connect(&mStoreManager, &StoreManager::tournamentReset, this, &PlayersProxyModel::tournamentReset);
+}
+
+void PlayersProxyModel::tournamentAboutToBeReset() {
+    while (!mConnections.empty()) {
+        disconnect(mConnections.top());
+        mConnections.pop();
+    }
+}
+
+void PlayersProxyModel::tournamentReset() {
+    QTournamentStore & tournament = mStoreManager.getTournament();
+
+    mConnections.push(connect(&tournament, &QTournamentStore::categoriesAdded, this, &PlayersProxyModel::categoriesChanged));
+    mConnections.push(connect(&tournament, &QTournamentStore::categoriesChanged, this, &PlayersProxyModel::categoriesChanged));
+    mConnections.push(connect(&tournament, &QTournamentStore::categoriesErased, this, &PlayersProxyModel::categoriesChanged));
+    mConnections.push(connect(&tournament, &QTournamentStore::categoriesReset, this, &PlayersProxyModel::categoriesChanged));
+
+    categoriesChanged();
+}
+
+void PlayersProxyModel::categoriesChanged() {
+    if (mTextFilter.isEmpty())
+        return;
+
+    updateTextFilterCategories();
+    invalidateFilter();
+}
+
+void PlayersProxyModel::updateTextFilterCategories() {
+    mTextFilterCategories.clear();
+    if (mTextFilter.isEmpty())
+        return;
+
+    for (const auto &it : mStoreManager.getTournament().getCategories()) {
+        if (QString::fromStdString(it.second->getName()).contains(mTextFilter, Qt::CaseInsensitive))
+            mTextFilterCategories.insert(it.first);
+    }
 }
 
 std::vector<PlayerId> PlayersProxyModel::getPlayers(const QItemSelection &selection) const {
@@ -275,21 +353,13 @@ bool PlayersProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourc
     }
 
     if (!mTextFilter.isEmpty()) { // Text search overrides other filters
-        // Try to match name
-        auto fullName = QString::fromStdString(player.getFirstName()) + " " + QString::fromStdString(player.getLastName());
-        if (fullName.contains(mTextFilter, Qt::CaseInsensitive))
-            return true;
-
-        // Try to match club
-        auto club = QString::fromStdString(player.getClub());
-        if (club.contains(mTextFilter, Qt::CaseInsensitive))
+        // Try to match name and club
+        if (mSearchIndex->matches(playerId))
             return true;
 
         // Try to match categories
         for (auto categoryId : player.getCategories()) {
-            const auto &category = tournament.getCategory(categoryId);
-            auto categoryName = QString::fromStdString(category.getName());
-            if (categoryName.contains(mTextFilter, Qt::CaseInsensitive))
+            if (mTextFilterCategories.find(categoryId) != mTextFilterCategories.end())
                 return true;
         }
 
@@ -374,6 +444,9 @@ void PlayersProxyModel::setTextFilter(const QString &text) {
         return;
 
     mTextFilter = text;
+    mSearchIndex->setQuery(text);
+    updateTextFilterCategories();
+
     invalidateFilter();
 }
 
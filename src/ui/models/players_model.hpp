@@ -1,9 +1,9 @@
 #pragma once
 
 #include <optional>
-#include <set>
 #include <stack>
 #include <unordered_set>
+#include <vector>
 #include <QMetaObject>
 #include <QAbstractTableModel>
 #include <QItemSelection>
@@ -13,6 +13,7 @@
 
 class StoreManager;
 class PlayerStore;
+class PlayerSearchIndex;
 
 class PlayersModel : public QAbstractTableModel {
     Q_OBJECT
@@ -43,9 +44,10 @@ protected:
 
 private:
     QString listPlayerCategories(const PlayerStore &player) const;
+    void loadPlayers();
     const int COLUMN_COUNT = 9;
     StoreManager & mStoreManager;
-    std::set<PlayerId> mIds;
+    std::vector<PlayerId> mIds; // Sorted. The index of a player is its row
     std::unordered_set<PlayerId> mAffectedPlayers; // Used when receiving a categoriesAboutToBeErased signal
     std::stack<QMetaObject::Connection> mConnections;
 };
@@ -69,7 +71,13 @@ public:
     void setTextFilter(const QString &text);
 
 private:
+    void tournamentAboutToBeReset();
+    void tournamentReset();
+    void categoriesChanged(); // Categories added, renamed, erased or reset
+    void updateTextFilterCategories();
+
     StoreManager & mStoreManager;
+    PlayerSearchIndex *mSearchIndex;
     PlayersModel *mModel;
     std::optional<CategoryId> mCategoryId;
     bool mHidden;
@@ -81,5 +89,7 @@ private:
     bool mShowMale;
     bool mShowFemale;
     QString mTextFilter;
+    std::unordered_set<CategoryId> mTextFilterCategories; // Categories whose name contains the text filter
+    std::stack<QMetaObject::Connection> mConnections;
 };
 
@@ -1,7 +1,10 @@
+#include <algorithm>
+
 #include "core/log.hpp"
 #include "core/network/network_connection.hpp"
 #include "core/network/network_message.hpp"
 #include "core/network/plain_socket.hpp"
+#include "ui/constants/web.hpp"
 #include "ui/network/network_participant.hpp"
 #include "ui/network/network_server.hpp"
 #include "ui/stores/qtournament_store.hpp"
@@ -90,6 +93,7 @@ void NetworkServer::postSync(std::unique_ptr<TournamentStore> tournament) {
         mTournament = std::move(ptr);
         mActionStack.clear();
         mActionMap.clear();
+        mUploadLog.clear();
 
         auto message = std::make_shared<NetworkMessage>();
         message->encodeSync(*mTournament, mActionStack);
@@ -117,9 +121,10 @@ void NetworkServer::postAction(ClientActionId actionId, std::unique_ptr<Action>
             mActionStack.pop_front();
         }
 
-        auto message = std::make_unique<NetworkMessage>();
+        auto message = std::make_shared<NetworkMessage>();
         message->encodeAction(actionId, std::move(sharedAction));
 
+        appendUploadLog(actionId, false, message);
         deliver(std::move(message));
 
         emit actionConfirmReceived(actionId);
@@ -134,9 +139,10 @@ void NetworkServer::postUndo(ClientActionId actionId) {
             mActionStack.erase(it->second);
             mActionMap.erase(it);
 
-            auto message = std::make_unique<NetworkMessage>();
+            auto message = std::make_shared<NetworkMessage>();
             message->encodeUndo(actionId);
 
+            appendUploadLog(actionId, true, message);
             deliver(std::move(message));
         }
 
@@ -187,6 +193,7 @@ void NetworkServer::deliverAction(std::shared_ptr<NetworkMessage> message, std::
         participant->deliver(message);
     }
 
+    appendUploadLog(actionId, false, message);
     mWebClient.deliver(message);
 }
 
@@ -196,3 +203,39 @@ void NetworkServer::deliver(std::shared_ptr<NetworkMessage> message) {
     mWebClient.deliver(message);
 }
 
+void NetworkServer::appendUploadLog(ClientActionId actionId, bool isUndo, std::shared_ptr<NetworkMessage> message) {
+    mUploadLog.push_back({actionId, isUndo, std::move(message)});
+    if (mUploadLog.size() > Constants::MAX_UPLOAD_LOG_SIZE)
+        mUploadLog.pop_front();
+}
+
+std::optional<std::vector<std::shared_ptr<NetworkMessage>>> NetworkServer::getUploadDelta(const std::vector<ClientActionId> &actionIds) const {
+    if (actionIds.empty())
+        return std::nullopt;
+
+    // The web server has applied a prefix of the log. Resume right after its
+    // most recent action that is still applied
+    auto it = std::find_if(mUploadLog.rbegin(), mUploadLog.rend(), [&](const UploadLogEntry &entry) {
+        return !entry.isUndo && entry.actionId == actionIds.back();
+    });
+
+    if (it == mUploadLog.rend())
+        return std::nullopt;
+
+    // Entries between that action and the end of the prefix can only be undos
+    // or actions undone again later. Replaying those actions is harmless and
+    // undos are skipped unless their action is applied on the web server
+    std::unordered_set<ClientActionId> appliedIds(actionIds.begin(), actionIds.end());
+    std::vector<std::shared_ptr<NetworkMessage>> messages;
+    for (auto entryIt = it.base(); entryIt != mUploadLog.end(); ++entryIt) {
+        if (entryIt->isUndo) {
+            if (appliedIds.erase(entryIt->actionId) > 0)
+                messages.push_back(entryIt->message);
+        }
+        else if (appliedIds.insert(entryIt->actionId).second) {
+            messages.push_back(entryIt->message);
+        }
+    }
+
+    return messages;
+}
@@ -3,6 +3,7 @@
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
+#include <list>
 #include <map>
 #include <set>
 #include <queue>
@@ -48,6 +49,10 @@ private:
     const std::shared_ptr<TournamentStore> & getTournament() const;
     const SharedActionList & getActionStack() const;
 
+    // Messages bringing a web server with the given applied actions up to
+    // date. Empty when the web server has to be sent a full sync instead
+    std::optional<std::vector<std::shared_ptr<NetworkMessage>>> getUploadDelta(const std::vector<ClientActionId> &actionIds) const;
+
 protected:
     void postQuit();
     void accept();
@@ -61,6 +66,16 @@ private:
     SharedActionList mActionStack;
     std::unordered_map<ClientActionId, SharedActionList::iterator> mActionMap;
 
+    // Actions and undos since the last sync in the order they were delivered to the web client
+    struct UploadLogEntry {
+        ClientActionId actionId;
+        bool isUndo;
+        std::shared_ptr<NetworkMessage> message;
+    };
+
+    void appendUploadLog(ClientActionId actionId, bool isUndo, std::shared_ptr<NetworkMessage> message);
+    std::list<UploadLogEntry> mUploadLog;
+
     WebClient &mWebClient;
 
     friend class NetworkParticipant;
@@ -0,0 +1,227 @@
+#include "core/stores/category_store.hpp"
+#include "ui/store_managers/match_ticker.hpp"
+#include "ui/store_managers/store_manager.hpp"
+#include "ui/stores/qtournament_store.hpp"
+
+MatchTicker::MatchTicker(StoreManager &storeManager)
+    : mStoreManager(storeManager)
+    , mFrameRate(false)
+{
+    connect(&mTimer, &QTimer::timeout, this, &MatchTicker::timerHit);
+
+    connect(&mStoreManager, &StoreManager::tournamentAboutToBeReset, this, &MatchTicker::beginResetTournament);
+    connect(&mStoreManager, &StoreManager::tournamentReset, this, &MatchTicker::endResetTournament);
+
+    endResetTournament();
+}
+
+void MatchTicker::watchMatch(const QObject *consumer, CombinedId combinedId, TickRate rate) {
+    auto consumerIt = mConsumers.find(consumer);
+    if (consumerIt == mConsumers.end()) {
+        consumerIt = mConsumers.emplace(consumer, std::unordered_map<CombinedId, TickRate>()).first;
+        connect(consumer, &QObject::destroyed, this, [this, consumer]() {
+            unwatchMatches(consumer);
+            mConsumers.erase(consumer);
+        });
+    }
+
+    auto &matches = consumerIt->second;
+    auto it = matches.find(combinedId);
+    if (it != matches.end()) {
+        if (it->second == rate)
+            return;
+        eraseRegistration(combinedId, it->second);
+        it->second = rate;
+    }
+    else {
+        matches.emplace(combinedId, rate);
+    }
+
+    addRegistration(combinedId, rate);
+    updateMatch(combinedId);
+}
+
+void MatchTicker::unwatchMatch(const QObject *consumer, CombinedId combinedId) {
+    auto consumerIt = mConsumers.find(consumer);
+    if (consumerIt == mConsumers.end())
+        return;
+
+    auto &matches = consumerIt->second;
+    auto it = matches.find(combinedId);
+    if (it == matches.end())
+        return;
+
+    eraseRegistration(combinedId, it->second);
+    matches.erase(it);
+    updateMatch(combinedId);
+}
+
+void MatchTicker::unwatchMatches(const QObject *consumer) {
+    auto consumerIt = mConsumers.find(consumer);
+    if (consumerIt == mConsumers.end())
+        return;
+
+    for (const auto &it : consumerIt->second) {
+        eraseRegistration(it.first, it.second);
+        if (mRegistrations.find(it.first) == mRegistrations.end())
+            mRunningMatches.erase(it.first);
+    }
+
+    // The consumer is kept until destroyed since its destroyed connection remains
+    consumerIt->second.clear();
+    updateTimer();
+}
+
+void MatchTicker::addRegistration(CombinedId combinedId, TickRate rate) {
+    auto &registration = mRegistrations[combinedId];
+    if (rate == TickRate::FRAME)
+        ++registration.frameCount;
+    else
+        ++registration.secondCount;
+}
+
+void MatchTicker::eraseRegistration(CombinedId combinedId, TickRate rate) {
+    auto it = mRegistrations.find(combinedId);
+    assert(it != mRegistrations.end());
+
+    auto &registration = it->second;
+    if (rate == TickRate::FRAME) {
+        assert(registration.frameCount > 0);
+        --registration.frameCount;
+    }
+    else {
+        assert(registration.secondCount > 0);
+        --registration.secondCount;
+    }
+
+    if (registration.frameCount == 0 && registration.secondCount == 0)
+        mRegistrations.erase(it);
+}
+
+void MatchTicker::beginResetTournament() {
+    while (!mConnections.empty()) {
+        disconnect(mConnections.top());
+        mConnections.pop();
+    }
+}
+
+void MatchTicker::endResetTournament() {
+    const QTournamentStore &tournament = mStoreManager.getTournament();
+    mConnections.push(connect(&tournament, &QTournamentStore::matchesChanged, this, &MatchTicker::changeMatches));
+    mConnections.push(connect(&tournament, &QTournamentStore::matchesReset, this, &MatchTicker::resetMatches));
+    mConnections.push(connect(&tournament, &QTournamentStore::categoriesErased, this, &MatchTicker::eraseCategories));
+
+    mRunningMatches.clear();
+    for (const auto &it : mRegistrations) {
+        if (isRunning(it.first))
+            mRunningMatches.insert(it.first);
+    }
+
+    updateTimer();
+}
+
+void MatchTicker::changeMatches(CategoryId categoryId, const std::vector<MatchId> &matchIds) {
+    bool changed = false;
+    for (MatchId matchId : matchIds) {
+        CombinedId combinedId(categoryId, matchId);
+        if (mRegistrations.find(combinedId) == mRegistrations.end())
+            continue;
+
+        if (isRunning(combinedId))
+            changed |= mRunningMatches.insert(combinedId).second;
+        else
+            changed |= (mRunningMatches.erase(combinedId) > 0);
+    }
+
+    if (changed)
+        updateTimer();
+}
+
+void MatchTicker::resetMatches(const std::vector<CategoryId> &categoryIds) {
+    std::unordered_set<CategoryId> categories(categoryIds.begin(), categoryIds.end());
+
+    for (const auto &it : mRegistrations) {
+        if (categories.find(it.first.getCategoryId()) == categories.end())
+            continue;
+
+        if (isRunning(it.first))
+            mRunningMatches.insert(it.first);
+        else
+            mRunningMatches.erase(it.first);
+    }
+
+    updateTimer();
+}
+
+void MatchTicker::eraseCategories(const std::vector<CategoryId> &categoryIds) {
+    std::unordered_set<CategoryId> categories(categoryIds.begin(), categoryIds.end());
+
+    for (auto it = mRunningMatches.begin(); it != mRunningMatches.end();) {
+        if (categories.find(it->getCategoryId()) != categories.end())
+            it = mRunningMatches.erase(it);
+        else
+            ++it;
+    }
+
+    updateTimer();
+}
+
+bool MatchTicker::isRunning(CombinedId combinedId) const {
+    const auto &tournament = mStoreManager.getTournament();
+    if (!tournament.containsCategory(combinedId.getCategoryId()))
+        return false;
+
+    const auto &category = tournament.getCategory(combinedId.getCategoryId());
+    if (!category.containsMatch(combinedId.getMatchId()))
+        return false;
+
+    const auto &match = category.getMatch(combinedId.getMatchId());
+    return match.getStatus() == MatchStatus::UNPAUSED || match.getOsaekomi().has_value();
+}
+
+void MatchTicker::updateMatch(CombinedId combinedId) {
+    if (mRegistrations.find(combinedId) != mRegistrations.end() && isRunning(combinedId))
+        mRunningMatches.insert(combinedId);
+    else
+        mRunningMatches.erase(combinedId);
+
+    updateTimer();
+}
+
+void MatchTicker::updateTimer() {
+    if (mRunningMatches.empty()) {
+        mFrameRate = false;
+        mTimer.stop();
+        return;
+    }
+
+    mFrameRate = false;
+    for (CombinedId combinedId : mRunningMatches) {
+        if (mRegistrations.at(combinedId).frameCount > 0) {
+            mFrameRate = true;
+            break;
+        }
+    }
+
+    const auto interval = (mFrameRate ? FRAME_INTERVAL : SECOND_INTERVAL);
+    if (!mTimer.isActive()) {
+        mLastSecond = std::chrono::steady_clock::now();
+        mTimer.start(interval);
+    }
+    else if (mTimer.interval() != interval.count()) {
+        mTimer.start(interval);
+    }
+}
+
+void MatchTicker::timerHit() {
+    if (mFrameRate)
+        emit frameTicked();
+
+    // Allow for half a frame of timer jitter so second ticks stay aligned with frames
+    auto now = std::chrono::steady_clock::now();
+    if (now - mLastSecond >= SECOND_INTERVAL - FRAME_INTERVAL / 2) {
+        mLastSecond = now;
+        emit secondTicked();
+    }
+}
+
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <stack>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <QObject>
+#include <QTimer>
+
+#include "core/id.hpp"
+#include "core/stores/match_store.hpp"
+
+class StoreManager;
+
+enum class TickRate {
+    FRAME, // Clocks shown with sub-second effects such as blinking
+    SECOND, // Clocks only showing whole seconds
+};
+
+// Shared clock for everything that refreshes while matches are running.
+// Consumers register the matches they display and the ticker only runs while
+// one of them is unpaused or in osaekomi. All consumers are refreshed from the
+// same wakeup. Registrations are dropped when the consumer is destroyed
+class MatchTicker : public QObject {
+    Q_OBJECT
+public:
+    static constexpr auto FRAME_INTERVAL = std::chrono::milliseconds(100);
+    static constexpr auto SECOND_INTERVAL = std::chrono::milliseconds(1000);
+
+    MatchTicker(StoreManager &storeManager);
+
+    void watchMatch(const QObject *consumer, CombinedId combinedId, TickRate rate);
+    void unwatchMatch(const QObject *consumer, CombinedId combinedId);
+    void unwatchMatches(const QObject *consumer);
+
+signals:
+    void frameTicked();
+    void secondTicked();
+
+private:
+    struct Registration {
+        size_t frameCount = 0;
+        size_t secondCount = 0;
+    };
+
+    void beginResetTournament();
+    void endResetTournament();
+    void changeMatches(CategoryId categoryId, const std::vector<MatchId> &matchIds);
+    void resetMatches(const std::vector<CategoryId> &categoryIds);
+    void eraseCategories(const std::vector<CategoryId> &categoryIds);
+
+    bool isRunning(CombinedId combinedId) const;
+    void addRegistration(CombinedId combinedId, TickRate rate);
+    void eraseRegistration(CombinedId combinedId, TickRate rate);
+    void updateMatch(CombinedId combinedId);
+    void updateTimer();
+    void timerHit();
+
+    StoreManager &mStoreManager;
+    std::stack<QMetaObject::Connection> mConnections;
+    QTimer mTimer;
+    std::chrono::steady_clock::time_point mLastSecond;
+
+    std::unordered_map<const QObject *, std::unordered_map<CombinedId, TickRate>> mConsumers;
+    std::unordered_map<CombinedId, Registration> mRegistrations; // Consumer counts by match
+    std::unordered_set<CombinedId> mRunningMatches; // Registered matches that are unpaused or in osaekomi
+    bool mFrameRate; // Whether a running match is watched at frame rate
+};
+
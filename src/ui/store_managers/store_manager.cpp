@@ -1,6 +1,7 @@
 #include "core/constants/actions.hpp"
 #include "core/log.hpp"
 #include "ui/network/network_interface.hpp"
+#include "ui/store_managers/match_ticker.hpp"
 #include "ui/store_managers/store_manager.hpp"
 #include "ui/stores/qtournament_store.hpp"
 
@@ -12,6 +13,7 @@ StoreManager::StoreManager()
 {
     mThread.start();
     mTournament->setId(TournamentId::generate());
+    mTicker = std::make_unique<MatchTicker>(*this);
 }
 
 StoreManager::~StoreManager() {
@@ -42,6 +44,14 @@ const QTournamentStore & StoreManager::getTournament() const {
     return *mTournament;
 }
 
+MatchTicker & StoreManager::getTicker() {
+    return *mTicker;
+}
+
+const MatchTicker & StoreManager::getTicker() const {
+    return *mTicker;
+}
+
 void StoreManager::sync(std::unique_ptr<QTournamentStore> tournament) {
     mSyncing += 1;
 
@@ -12,6 +12,7 @@
 #include "ui/network/network_interface.hpp"
 #include "ui/store_managers/worker_thread.hpp"
 
+class MatchTicker;
 class QTournamentStore;
 class StoreManager;
 
@@ -46,6 +47,8 @@ public:
 
     QTournamentStore & getTournament();
     const QTournamentStore & getTournament() const;
+    MatchTicker & getTicker();
+    const MatchTicker & getTicker() const;
 
     virtual void dispatch(std::unique_ptr<Action> action);
     virtual bool canUndo();
@@ -100,6 +103,7 @@ private:
 
     ClientId mId;
     std::unique_ptr<QTournamentStore> mTournament;
+    std::unique_ptr<MatchTicker> mTicker;
 
     UniqueActionList mConfirmedActionList;
     std::unordered_map<ClientActionId, UniqueActionList::iterator> mConfirmedActionMap;
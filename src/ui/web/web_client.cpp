@@ -16,6 +16,7 @@ WebClient::WebClient(MasterStoreManager &storeManager, boost::asio::io_context &
     : mStoreManager(storeManager)
     , mContext(context)
     , mState(WebClientState::NOT_CONNECTED)
+    , mUploading(false)
 {
     qRegisterMetaType<WebToken>("WebToken");
     qRegisterMetaType<UserRegistrationResponse>("UserRegistrationResponse");
@@ -275,17 +276,55 @@ void WebClient::enterClockSync() {
         auto message = std::make_shared<NetworkMessage>();
         auto p1 = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
         message->encodeClockSync(p1);
-        deliver(std::move(message));
+        queueMessage(std::move(message));
 
         enterConfigured();
     });
 }
 
 void WebClient::enterConfigured() {
-    auto message = std::make_shared<NetworkMessage>();
-    message->encodeSync(*mNetworkServer->getTournament(), mNetworkServer->getActionStack());
-    deliver(std::move(message));
+    // The web server tells which actions it already has so that only the
+    // missing ones are uploaded after reconnecting
+    auto responseMessage = std::make_shared<NetworkMessage>();
+    mConnection->asyncRead(*responseMessage, [this, responseMessage](boost::system::error_code ec) {
+        if (mDisconnecting) {
+            killConnection();
+            return;
+        }
 
+        if (ec) {
+            log_error().field("message", ec.message()).msg("Encountered error reading web server action list message. Failing");
+            killConnection();
+            return;
+        }
+
+        std::vector<ClientActionId> actionIds;
+        if (responseMessage->getType() != NetworkMessage::Type::WEB_ACTION_LIST || !responseMessage->decodeWebActionList(actionIds)) {
+            log_error().msg("Did not receive action list from web server. Failing");
+            killConnection();
+            return;
+        }
+
+        auto delta = mNetworkServer->getUploadDelta(actionIds);
+        auto message = std::make_shared<NetworkMessage>();
+        if (delta) {
+            log_info().field("actionCount", delta->size()).msg("Resuming upload to web server");
+            message->encodeWebResume();
+            queueMessage(std::move(message));
+            for (auto &deltaMessage : *delta)
+                queueMessage(std::move(deltaMessage));
+        }
+        else {
+            message->encodeSync(*mNetworkServer->getTournament(), mNetworkServer->getActionStack());
+            queueMessage(std::move(message));
+        }
+
+        mUploading = true;
+        enterUploading();
+    });
+}
+
+void WebClient::enterUploading() {
     auto responseMessage = std::make_shared<NetworkMessage>();
     mConnection->asyncRead(*responseMessage, [this, responseMessage](boost::system::error_code ec) {
         if (mDisconnecting) {
@@ -316,15 +355,21 @@ void WebClient::killConnection() {
     mSocket.reset();
     mState = WebClientState::NOT_CONNECTED;
     mDisconnecting = false;
+    mUploading = false;
     emit stateChanged(mState);
     while (!mWriteQueue.empty())
         mWriteQueue.pop();
 }
 
 void WebClient::deliver(std::shared_ptr<NetworkMessage> message) {
-    if (mState != WebClientState::CONFIGURED || mDisconnecting)
+    // Messages delivered before the upload starts are covered by the sync or resume
+    if (mState != WebClientState::CONFIGURED || mDisconnecting || !mUploading)
         return;
 
+    queueMessage(std::move(message));
+}
+
+void WebClient::queueMessage(std::shared_ptr<NetworkMessage> message) {
     bool empty = mWriteQueue.empty();
     mWriteQueue.push(std::move(message));
 
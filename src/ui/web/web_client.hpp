@@ -45,9 +45,11 @@ private:
     typedef std::function<void(boost::system::error_code)> ConnectionHandler;
     void createConnection(ConnectionHandler handler);
 
+    void queueMessage(std::shared_ptr<NetworkMessage> message);
     void writeMessage();
     void enterClockSync();
     void enterConfigured();
+    void enterUploading();
 
 signals:
     // TODO: Setup signals when losing connection
@@ -70,6 +72,7 @@ private:
     std::unique_ptr<NetworkSocket> mSocket;
     std::shared_ptr<NetworkConnection> mConnection;
     bool mDisconnecting;
+    bool mUploading; // Whether the tournament has been synced or resumed, i.e. whether actions can be delivered
     std::queue<std::shared_ptr<NetworkMessage>> mWriteQueue;
     std::shared_ptr<NetworkServer> mNetworkServer;
 };
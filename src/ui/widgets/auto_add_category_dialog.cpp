@@ -1,4 +1,3 @@
-#include <QLabel>
 #include <QPushButton>
 #include <QDialogButtonBox>
 #include <QGridLayout>
@@ -13,7 +12,9 @@
 AutoAddCategoryDialog::AutoAddCategoryDialog(StoreManager & storeManager, const std::vector<PlayerId> &playerIds, QWidget *parent)
     : QDialog(parent)
     , mStoreManager(storeManager)
-    , mPlayerIds(playerIds)
+    , mEntries(AutoCategorizer::getEntries(storeManager.getTournament(), playerIds))
+    , mPreviewCancelled(false)
+    , mPreviewGeneration(0)
 {
     mBaseNameContent = new QLineEdit;
     mBaseNameContent->setMinimumWidth(300);
@@ -25,17 +26,31 @@ AutoAddCategoryDialog::AutoAddCategoryDialog(StoreManager & storeManager, const
 
     mMaxSizeContent = new QSpinBox;
     mMaxSizeContent->setMinimum(2);
-    mMaxSizeContent->setMaximum(mPlayerIds.size());
+    mMaxSizeContent->setMaximum(std::max<int>(playerIds.size(), 2));
     // mMaxSizeContent->setSpecialValueText(tr("Unlimited"));
-    mMaxSizeContent->setValue(std::min<int>(mPlayerIds.size(), 8));
+    mMaxSizeContent->setValue(std::min<int>(playerIds.size(), 8));
+
+    mAgeBandContent = new QSpinBox;
+    mAgeBandContent->setRange(0, 100);
+    mAgeBandContent->setSuffix(tr(" years"));
+    mAgeBandContent->setSpecialValueText(tr("Ignore age"));
+    mAgeBandContent->setValue(0);
+
+    mProgressBar = new QProgressBar;
+    mProgressBar->setRange(0, 100);
+
+    mPreviewLabel = new QLabel;
 
     QFormLayout *formLayout = new QFormLayout;
     formLayout->addRow(tr("Base Name"), mBaseNameContent);
     formLayout->addRow(tr("Maximum Weight Difference"), mMaxDifferenceContent);
     formLayout->addRow(tr("Maximum Category Size"), mMaxSizeContent);
+    formLayout->addRow(tr("Age Groups"), mAgeBandContent);
+    formLayout->addRow(tr("Preview"), mPreviewLabel);
+    formLayout->addRow(QString(), mProgressBar);
 
     QDialogButtonBox *buttonBox = new QDialogButtonBox;
-    buttonBox->addButton(tr("OK"), QDialogButtonBox::AcceptRole);
+    mOkButton = buttonBox->addButton(tr("OK"), QDialogButtonBox::AcceptRole);
     buttonBox->addButton(tr("Cancel"), QDialogButtonBox::RejectRole);
 
     QVBoxLayout *mainLayout = new QVBoxLayout;
@@ -46,14 +61,93 @@ AutoAddCategoryDialog::AutoAddCategoryDialog(StoreManager & storeManager, const
 
     connect(buttonBox, &QDialogButtonBox::accepted, this, &AutoAddCategoryDialog::acceptClick);
     connect(buttonBox, &QDialogButtonBox::rejected, this, &AutoAddCategoryDialog::cancelClick);
+
+    connect(mMaxDifferenceContent, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &AutoAddCategoryDialog::startPreview);
+    connect(mMaxSizeContent, QOverload<int>::of(&QSpinBox::valueChanged), this, &AutoAddCategoryDialog::startPreview);
+    connect(mAgeBandContent, QOverload<int>::of(&QSpinBox::valueChanged), this, &AutoAddCategoryDialog::startPreview);
+
+    // The signals are emitted from the preview thread and queued onto the GUI thread
+    connect(this, &AutoAddCategoryDialog::previewProgress, this, &AutoAddCategoryDialog::updatePreviewProgress, Qt::QueuedConnection);
+    connect(this, &AutoAddCategoryDialog::previewFinished, this, &AutoAddCategoryDialog::showPreview, Qt::QueuedConnection);
+
+    startPreview();
+}
+
+AutoAddCategoryDialog::~AutoAddCategoryDialog() {
+    stopPreview();
+}
+
+void AutoAddCategoryDialog::startPreview() {
+    stopPreview();
+
+    const unsigned int generation = ++mPreviewGeneration;
+    mPreviewCancelled = false;
+    mPreview.reset();
+
+    mOkButton->setEnabled(false);
+    mProgressBar->setValue(0);
+    mPreviewLabel->setText(tr("Computing..."));
+
+    AutoCategorizer categorizer(mMaxDifferenceContent->value(), mMaxSizeContent->value(), mAgeBandContent->value());
+    mPreviewThread = std::thread([this, generation, categorizer]() {
+        auto progress = [this, generation](size_t processed, size_t total) {
+            emit previewProgress(generation, static_cast<int>(100 * processed / std::max<size_t>(total, 1)));
+        };
+
+        auto groups = categorizer.run(mEntries, &mPreviewCancelled, progress);
+        if (!groups)
+            return;
+
+        mPreview = std::move(groups);
+        emit previewFinished(generation);
+    });
+}
+
+void AutoAddCategoryDialog::stopPreview() {
+    if (!mPreviewThread.joinable())
+        return;
+
+    mPreviewCancelled = true;
+    mPreviewThread.join();
+}
+
+void AutoAddCategoryDialog::updatePreviewProgress(unsigned int generation, int percent) {
+    if (generation != mPreviewGeneration)
+        return;
+
+    mProgressBar->setValue(percent);
+}
+
+void AutoAddCategoryDialog::showPreview(unsigned int generation) {
+    if (generation != mPreviewGeneration)
+        return;
+
+    if (mPreviewThread.joinable())
+        mPreviewThread.join();
+
+    if (!mPreview)
+        return;
+
+    size_t smallest = 0;
+    for (const auto &group : *mPreview) {
+        if (smallest == 0 || group.size() < smallest)
+            smallest = group.size();
+    }
+
+    mProgressBar->setValue(100);
+    mPreviewLabel->setText(tr("%1 categories, the smallest with %2 players").arg(mPreview->size()).arg(smallest));
+    mOkButton->setEnabled(!mPreview->empty());
 }
 
 void AutoAddCategoryDialog::acceptClick() {
-    mStoreManager.dispatch(std::make_unique<AutoAddCategoriesAction>(mStoreManager.getTournament(), mPlayerIds, mBaseNameContent->text().toStdString(), mMaxDifferenceContent->value(), mMaxSizeContent->value()));
+    if (mPreviewThread.joinable() || !mPreview) // Preview still being computed
+        return;
+
+    mStoreManager.dispatch(std::make_unique<AutoAddCategoriesAction>(mStoreManager.getTournament(), std::move(*mPreview), mBaseNameContent->text().toStdString()));
     accept();
 }
 
 void AutoAddCategoryDialog::cancelClick() {
+    stopPreview();
     reject();
 }
-
@@ -2,11 +2,18 @@
 
 #include "core/core.hpp"
 #include "core/id.hpp"
+#include "core/misc/auto_categorizer.hpp"
+
+#include <atomic>
+#include <thread>
 
 #include <QDialog>
 #include <QSpinBox>
 #include <QDoubleSpinBox>
+#include <QLabel>
 #include <QLineEdit>
+#include <QProgressBar>
+#include <QPushButton>
 
 class StoreManager;
 
@@ -14,14 +21,38 @@ class AutoAddCategoryDialog : public QDialog {
     Q_OBJECT
 public:
     AutoAddCategoryDialog(StoreManager & storeManager, const std::vector<PlayerId> &playerIds, QWidget *parent = nullptr);
+    ~AutoAddCategoryDialog();
+
+signals:
+    // Emitted from the preview thread
+    void previewProgress(unsigned int generation, int percent);
+    void previewFinished(unsigned int generation);
 
 public slots:
     void acceptClick();
     void cancelClick();
+
+private slots:
+    void updatePreviewProgress(unsigned int generation, int percent);
+    void showPreview(unsigned int generation);
+
 private:
+    // Recompute the categories off the GUI thread, cancelling any running computation
+    void startPreview();
+    void stopPreview();
+
     StoreManager & mStoreManager;
-    std::vector<PlayerId> mPlayerIds;
+    std::vector<AutoCategorizer::Entry> mEntries;
     QLineEdit *mBaseNameContent;
     QDoubleSpinBox *mMaxDifferenceContent;
     QSpinBox *mMaxSizeContent;
+    QSpinBox *mAgeBandContent;
+    QProgressBar *mProgressBar;
+    QLabel *mPreviewLabel;
+    QPushButton *mOkButton;
+
+    std::thread mPreviewThread;
+    std::atomic<bool> mPreviewCancelled;
+    unsigned int mPreviewGeneration;
+    std::optional<AutoCategorizer::Groups> mPreview; // Written by the preview thread. Only read after joining it
 };
@@ -3,6 +3,7 @@
 
 #include "core/stores/category_store.hpp"
 #include "core/stores/match_store.hpp"
+#include "ui/store_managers/match_ticker.hpp"
 #include "ui/store_managers/store_manager.hpp"
 #include "ui/stores/qtournament_store.hpp"
 #include "ui/widgets/graphics_items/tatami_text_graphics_item.hpp"
@@ -108,15 +109,12 @@ MatchesGraphicsManager::MatchesGraphicsManager(StoreManager &storeManager, const
     , mResettingMatches(false)
 {
     auto &tournament = mStoreManager.getTournament();
-    connect(&mTimer, &QTimer::timeout, this, &MatchesGraphicsManager::timerHit);
+    connect(&mStoreManager.getTicker(), &MatchTicker::secondTicked, this, &MatchesGraphicsManager::secondTick);
     connect(&tournament, &QTournamentStore::matchesChanged, this, &MatchesGraphicsManager::changeMatches);
     connect(&tournament, &QTournamentStore::tatamisChanged, this, &MatchesGraphicsManager::changeTatamis);
     connect(&tournament, &QTournamentStore::playersChanged, this, &MatchesGraphicsManager::changePlayers);
     connect(&tournament, &QTournamentStore::matchesAboutToBeReset, this, &MatchesGraphicsManager::beginResetCategoryMatches);
 
-
-    mTimer.start(TIMER_INTERVAL);
-
     beginResetMatches();
     endResetMatches();
 }
@@ -429,7 +427,7 @@ void MatchesGraphicsManager::beginResetCategoryMatches(const std::vector<Categor
     for (auto categoryId : categoryIds) {
         const auto &category = tournament.getCategory(categoryId);
         for (const auto &match : category.getMatches()) {
-            if (mLoadedMatches.find(match->getCombinedId()) != mLoadedMatches.end()) {
+            if (mLoadedMatches.find(match.getCombinedId()) != mLoadedMatches.end()) {
                 beginResetMatches(); // Let the tatamiChanged call endResetMatches()
                 return;
             }
@@ -437,7 +435,7 @@ void MatchesGraphicsManager::beginResetCategoryMatches(const std::vector<Categor
     }
 }
 
-void MatchesGraphicsManager::timerHit() {
+void MatchesGraphicsManager::secondTick() {
     for (auto combinedId : mUnpausedMatches) {
         auto it = mItems.find(combinedId);
         if (it != mItems.end()) {
@@ -456,6 +454,9 @@ void MatchesGraphicsManager::reloadItems() {
 
     mItems.clear();
 
+    auto &ticker = mStoreManager.getTicker();
+    ticker.unwatchMatches(this);
+
     int x = mX;
     int y = mY;
 
@@ -467,6 +468,7 @@ void MatchesGraphicsManager::reloadItems() {
         auto item = new MatchGraphicsItem(mStoreManager, combinedId, rect);
         mScene->addItem(item);
         mItems[combinedId] = item;
+        ticker.watchMatch(this, combinedId, TickRate::SECOND);
         y += MatchesGridGraphicsManager::GRID_HEIGHT;
     }
 }
@@ -3,7 +3,6 @@
 #include <stack>
 #include <vector>
 #include <QWidget>
-#include <QTimer>
 
 #include "core/id.hpp"
 #include "core/stores/tatami/location.hpp"
@@ -35,7 +34,6 @@ private:
 class MatchesGraphicsManager : public QObject {
     Q_OBJECT
 public:
-    static constexpr auto TIMER_INTERVAL = std::chrono::milliseconds(1000);
     static constexpr auto ROW_CAP = 10;
 
     MatchesGraphicsManager(StoreManager &storeManager, const QPalette &palette, QGraphicsScene *scene, TatamiLocation location, int x, int y);
@@ -44,7 +42,7 @@ protected:
     void changeMatches(CategoryId categoryId, const std::vector<MatchId> &matchIds);
     void changeTatamis(const std::vector<BlockLocation> &locations, const std::vector<std::pair<CategoryId, MatchType>> &blocks);
     void changePlayers(const std::vector<PlayerId> &playerIds);
-    void timerHit();
+    void secondTick();
     void beginResetCategoryMatches(const std::vector<CategoryId> &categoryIds);
 
     void beginResetMatches();
@@ -61,7 +59,6 @@ private:
     QGraphicsScene *mScene;
 
     bool mResettingMatches;
-    QTimer mTimer;
     std::unordered_map<CombinedId, size_t> mLoadedMatches; // Matches loaded and loading time
     std::unordered_set<PositionId> mLoadedGroups; // Blocks loaded
 
@@ -4,12 +4,13 @@
 #include "core/log.hpp"
 #include "core/stores/category_store.hpp"
 #include "core/stores/player_store.hpp"
+#include "ui/store_managers/match_ticker.hpp"
 #include "ui/stores/qtournament_store.hpp"
 #include "ui/widgets/score_display_widget.hpp"
 #include "ui/widgets/scoreboard_painters/international_scoreboard_painter.hpp"
 #include "ui/widgets/scoreboard_painters/national_scoreboard_painter.hpp"
 
-ScoreDisplayWidget::ScoreDisplayWidget(const StoreManager &storeManager, QWidget *parent)
+ScoreDisplayWidget::ScoreDisplayWidget(StoreManager &storeManager, QWidget *parent)
     : QWidget(parent)
     , mState(ScoreDisplayState::INTRODUCTION)
     , mStoreManager(storeManager)
@@ -18,11 +19,10 @@ ScoreDisplayWidget::ScoreDisplayWidget(const StoreManager &storeManager, QWidget
 
     mIntroTimer.setSingleShot(true);
     mWinnerTimer.setSingleShot(true);
-    mDurationTimer.start(DURATION_INTERVAL);
 
     connect(&mIntroTimer, &QTimer::timeout, [this](){ setState(ScoreDisplayState::NORMAL); });
     connect(&mWinnerTimer, &QTimer::timeout, [this](){ setState(ScoreDisplayState::WINNER); });
-    connect(&mDurationTimer, &QTimer::timeout, this, &ScoreDisplayWidget::durationTimerHit);
+    connect(&mStoreManager.getTicker(), &MatchTicker::frameTicked, this, &ScoreDisplayWidget::frameTick);
 
     connect(&mStoreManager, &StoreManager::tournamentAboutToBeReset, this, &ScoreDisplayWidget::beginResetTournament);
     connect(&mStoreManager, &StoreManager::tournamentReset, this, &ScoreDisplayWidget::endResetTournament);
@@ -73,7 +73,19 @@ void ScoreDisplayWidget::paintEvent(QPaintEvent *event) {
         mScoreboardPainter->paintIntroduction(painter, rect, params);
     }
     else if (mState == ScoreDisplayState::NORMAL) {
-        mScoreboardPainter->paintNormal(painter, rect, params);
+        // Only the dynamic region is repainted on ticks. The rest is copied
+        // from the cached static layer, which is rebuilt after changes
+        if (mStaticLayer.isNull()) {
+            const qreal ratio = devicePixelRatioF();
+            mStaticLayer = QPixmap(size() * ratio);
+            mStaticLayer.setDevicePixelRatio(ratio);
+
+            QPainter layerPainter(&mStaticLayer);
+            mScoreboardPainter->paintNormalStatic(layerPainter, rect, params);
+        }
+
+        painter.drawPixmap(0, 0, mStaticLayer);
+        mScoreboardPainter->paintNormalDynamic(painter, rect, params);
     }
     else {
         assert(mState == ScoreDisplayState::WINNER);
@@ -82,6 +94,12 @@ void ScoreDisplayWidget::paintEvent(QPaintEvent *event) {
 }
 
 void ScoreDisplayWidget::setMatch(std::optional<CombinedId> combinedId, bool showIntro) {
+    auto &ticker = mStoreManager.getTicker();
+    if (mCombinedId)
+        ticker.unwatchMatch(this, *mCombinedId);
+    if (combinedId)
+        ticker.watchMatch(this, *combinedId, TickRate::FRAME);
+
     mCombinedId = combinedId;
     if (showIntro) {
         mState = ScoreDisplayState::INTRODUCTION;
@@ -91,12 +109,12 @@ void ScoreDisplayWidget::setMatch(std::optional<CombinedId> combinedId, bool sho
         mState = ScoreDisplayState::NORMAL;
     }
 
-    update(0, 0, width(), height());
+    invalidateStaticLayer();
 }
 
 void ScoreDisplayWidget::setState(ScoreDisplayState state) {
     mState = state;
-    update(0, 0, width(), height());
+    invalidateStaticLayer();
 }
 
 void ScoreDisplayWidget::beginResetTournament() {
@@ -115,6 +133,7 @@ void ScoreDisplayWidget::endResetTournament() {
     mConnections.push(connect(&tournament, &QTournamentStore::preferencesChanged, this, &ScoreDisplayWidget::loadPainter));
 
     loadPainter();
+    invalidateStaticLayer();
 }
 
 void ScoreDisplayWidget::changeMatches(CategoryId categoryId, std::vector<MatchId> matchIds) {
@@ -125,7 +144,7 @@ void ScoreDisplayWidget::changeMatches(CategoryId categoryId, std::vector<MatchI
         if (mCombinedId->getMatchId() == matchId) {
             if (mState == ScoreDisplayState::INTRODUCTION)
                 mState = ScoreDisplayState::NORMAL;
-            update(0, 0, width(), height());
+            invalidateStaticLayer();
             return;
         }
     }
@@ -148,7 +167,7 @@ void ScoreDisplayWidget::changePlayers(std::vector<PlayerId> playerIds) {
 
     for (auto playerId : playerIds) {
         if (match.getWhitePlayer() == playerId || match.getBluePlayer() == playerId) {
-            update(0, 0, width(), height());
+            invalidateStaticLayer();
             return;
         }
     }
@@ -160,7 +179,7 @@ void ScoreDisplayWidget::resetMatches(const std::vector<CategoryId> &categoryIds
 
     for (auto categoryId : categoryIds) {
         if (mCombinedId->getCategoryId() == categoryId) {
-            update(0, 0, width(), height());
+            invalidateStaticLayer();
             return;
         }
     }
@@ -169,20 +188,18 @@ void ScoreDisplayWidget::resetMatches(const std::vector<CategoryId> &categoryIds
 void ScoreDisplayWidget::changeCategories(std::vector<CategoryId> categoryIds) {
     for (auto categoryId : categoryIds) {
         if (mCombinedId && mCombinedId->getCategoryId() == categoryId) {
-            update(0, 0, width(), height());
+            invalidateStaticLayer();
             return;
         }
     }
 }
 
-void ScoreDisplayWidget::durationTimerHit() {
+void ScoreDisplayWidget::frameTick() {
     if (!mCombinedId)
         return;
     if (mState != ScoreDisplayState::NORMAL)
         return;
-    // QRect lowerRect(0,2*(height()/3),width(), height() - 2*(height()/3));
-    // update(lowerRect);
-    update(rect());
+    update(mScoreboardPainter->getDynamicRegion());
 }
 
 void ScoreDisplayWidget::loadPainter() {
@@ -200,10 +217,16 @@ void ScoreDisplayWidget::loadPainter() {
 
     mScoreboardPainter->resizeEvent(rect());
 
-    update(0, 0, width(), height());
+    invalidateStaticLayer();
 }
 
 void ScoreDisplayWidget::resizeEvent(QResizeEvent *event) {
     mScoreboardPainter->resizeEvent(rect());
+    invalidateStaticLayer();
+}
+
+void ScoreDisplayWidget::invalidateStaticLayer() {
+    mStaticLayer = QPixmap();
+    update(0, 0, width(), height());
 }
 
@@ -2,6 +2,7 @@
 
 #include <stack>
 #include <QFont>
+#include <QPixmap>
 #include <QTimer>
 #include <QWidget>
 
@@ -21,7 +22,7 @@ enum class ScoreDisplayState {
 class ScoreDisplayWidget : public QWidget {
     Q_OBJECT
 public:
-    ScoreDisplayWidget(const StoreManager &storeManager, QWidget *parent = nullptr);
+    ScoreDisplayWidget(StoreManager &storeManager, QWidget *parent = nullptr);
 
     void setMatch(std::optional<CombinedId> combinedId, bool showIntro = true);
     void setState(ScoreDisplayState state);
@@ -38,9 +39,8 @@ protected:
 private:
     static constexpr auto INTRO_INTERVAL = std::chrono::milliseconds(4000);
     static constexpr auto WINNER_INTERVAL = std::chrono::milliseconds(4000);
-    static constexpr auto DURATION_INTERVAL = std::chrono::milliseconds(200);
 
-    void durationTimerHit();
+    void frameTick();
 
     void beginResetTournament();
     void endResetTournament();
@@ -50,11 +50,12 @@ private:
     void changeCategories(std::vector<CategoryId> categoryIds);
     void changePreferences();
     void loadPainter();
+    void invalidateStaticLayer();
 
-    const StoreManager &mStoreManager;
+    StoreManager &mStoreManager;
     std::stack<QMetaObject::Connection> mConnections;
     QTimer mIntroTimer;
     QTimer mWinnerTimer;
-    QTimer mDurationTimer;
+    QPixmap mStaticLayer; // Cached static layer of the normal state. Null when invalidated
 };
 
@@ -2,7 +2,7 @@
 #include "ui/widgets/score_display_widget.hpp"
 #include "ui/widgets/score_display_window.hpp"
 
-ScoreDisplayWindow::ScoreDisplayWindow(const StoreManager &storeManager)
+ScoreDisplayWindow::ScoreDisplayWindow(StoreManager &storeManager)
     : mStoreManager(storeManager)
 {
     mScoreWidget = new ScoreDisplayWidget(mStoreManager, this);
@@ -11,13 +11,13 @@ class ScoreDisplayWindow : public QMainWindow {
     Q_OBJECT
 
 public:
-    ScoreDisplayWindow(const StoreManager &storeManager);
+    ScoreDisplayWindow(StoreManager &storeManager);
 
     ScoreDisplayWidget& getDisplayWidget();
 
 private slots:
 private:
-    const StoreManager &mStoreManager;
+    StoreManager &mStoreManager;
     ScoreDisplayWidget *mScoreWidget;
 };
 
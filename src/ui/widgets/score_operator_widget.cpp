@@ -18,6 +18,7 @@
 #include "core/log.hpp"
 #include "core/stores/category_store.hpp"
 #include "core/stores/player_store.hpp"
+#include "ui/store_managers/match_ticker.hpp"
 #include "ui/stores/qtournament_store.hpp"
 #include "ui/widgets/colors.hpp"
 #include "ui/widgets/score_operator_widget.hpp"
@@ -27,8 +28,8 @@ ScoreOperatorWidget::ScoreOperatorWidget(StoreManager &storeManager, QWidget *pa
     , mStoreManager(storeManager)
     , mFont("Noto Sans Mono")
 {
-    connect(&mPausingTimer, &QTimer::timeout, this, &ScoreOperatorWidget::pausingTimerHit);
-    mPausingTimer.start(PAUSING_TIMER_INTERVAL);
+    // Osaekomi awards and stops are checked on every frame of the watched match
+    connect(&mStoreManager.getTicker(), &MatchTicker::frameTicked, this, &ScoreOperatorWidget::pausingTimerHit);
 
     // Shortcuts
     auto *timerShortcut = new QShortcut(QKeySequence(Qt::Key_Space), this);
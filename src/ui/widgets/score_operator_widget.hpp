@@ -29,10 +29,8 @@ private:
     void cancelWazari(ScoreboardPainterParams &params, MatchStore::PlayerIndex playerIndex);
     void cancelShido(ScoreboardPainterParams &params, MatchStore::PlayerIndex playerIndex);
     void cancelHansokuMake(ScoreboardPainterParams &params, MatchStore::PlayerIndex playerIndex);
-    static constexpr auto PAUSING_TIMER_INTERVAL = std::chrono::milliseconds(100);
 
     StoreManager &mStoreManager;
-    QTimer mPausingTimer;
     QFont mFont;
 };
 
@@ -32,7 +32,7 @@ void InternationalScoreboardPainter::paintIntroduction(QPainter &painter, const
     paintIntroductionLower(painter, lowerRect, params);
 }
 
-void InternationalScoreboardPainter::paintNormal(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) {
+void InternationalScoreboardPainter::paintNormalStatic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) {
     QRect upperRect(0,0,rect.width(), rect.height()/3);
     QRect middleRect(0,rect.height()/3,rect.width(), rect.height()/3);
     QRect lowerRect(0,2*(rect.height()/3),rect.width(), rect.height() - 2*(rect.height()/3));
@@ -42,6 +42,54 @@ void InternationalScoreboardPainter::paintNormal(QPainter &painter, const QRect
     paintNormalLower(painter, lowerRect, params);
 }
 
+void InternationalScoreboardPainter::paintNormalDynamic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) {
+    const auto &ruleset = params.category.getRuleset();
+
+    painter.save();
+    painter.translate(rect.x(), rect.y());
+
+    auto font = mFont;
+
+    // Paint time left
+    {
+        auto time = std::chrono::ceil<std::chrono::seconds>(std::chrono::abs(ruleset.getNormalTime() - params.match.currentDuration(params.masterTime)));
+        QString seconds = QString::number((time % std::chrono::minutes(1)).count()).rightJustified(2, '0');
+        QString minutes = QString::number(std::chrono::duration_cast<std::chrono::minutes>(time).count());
+
+        font.setPixelSize(mLowerRect.height()*6/8);
+        painter.setFont(font);
+
+        if (params.match.getStatus() == MatchStatus::UNPAUSED)
+            painter.setPen(COLOR_SCOREBOARD_TIME_UNPAUSED);
+        else
+            painter.setPen(COLOR_SCOREBOARD_TIME_PAUSED);
+        painter.drawText(mTimeRect, Qt::AlignVCenter | Qt::AlignRight, QString("%1:%2").arg(minutes, seconds));
+    }
+
+    auto osaekomi = params.match.getOsaekomi();
+    if (osaekomi.has_value()) {
+        // Paint osaekomi indicator
+        unsigned int seconds = std::chrono::floor<std::chrono::seconds>(params.match.currentOsaekomiTime(params.masterTime)).count();
+        QString secondsString = QString::number(seconds).rightJustified(2, '0');
+
+        font.setPixelSize(mLowerRect.height()*5/8);
+        painter.setFont(font);
+
+        painter.setPen(COLOR_SCOREBOARD_OSAEKOMI);
+        painter.drawText(mOsaekomiRect, Qt::AlignBottom | Qt::AlignRight, secondsString);
+    }
+    else if (params.match.isGoldenScore()) {
+        // Paint golden score indicator
+        font.setPixelSize(mLowerRect.height()*1/3);
+        painter.setFont(font);
+
+        painter.setPen(COLOR_SCOREBOARD_GOLDEN_SCORE);
+        painter.drawText(mOsaekomiRect, Qt::AlignVCenter | Qt::AlignLeft, "GS");
+    }
+
+    painter.restore();
+}
+
 void InternationalScoreboardPainter::paintWinner(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) {
     paintNormal(painter, rect, params);
 }
@@ -262,8 +310,6 @@ void InternationalScoreboardPainter::paintNormalLower(QPainter &painter, const Q
     const int columnThree = columnOne + (rect.width() - columnOne) * 3 / 4;
     const int columnTwo = columnOne + (columnThree - columnOne) / 3;
 
-    const auto &ruleset = params.category.getRuleset();
-
     painter.save();
     painter.translate(rect.x(), rect.y());
 
@@ -285,48 +331,6 @@ void InternationalScoreboardPainter::paintNormalLower(QPainter &painter, const Q
     painter.drawText(titleRect, Qt::AlignBottom | Qt::AlignLeft, QString::fromStdString(params.match.getTitle()));
     painter.drawText(categoryRect, Qt::AlignTop | Qt::AlignLeft, QString::fromStdString(params.category.getName()));
 
-    // Paint time left
-    {
-        QRect timeRect(columnTwo, PADDING, columnThree-columnTwo-PADDING, rect.height()-PADDING*2);
-        auto time = std::chrono::ceil<std::chrono::seconds>(std::chrono::abs(ruleset.getNormalTime() - params.match.currentDuration(params.masterTime)));
-        QString seconds = QString::number((time % std::chrono::minutes(1)).count()).rightJustified(2, '0');
-        QString minutes = QString::number(std::chrono::duration_cast<std::chrono::minutes>(time).count());
-
-        font.setPixelSize(rect.height()*6/8);
-        painter.setFont(font);
-
-        if (params.match.getStatus() == MatchStatus::UNPAUSED)
-            painter.setPen(COLOR_SCOREBOARD_TIME_UNPAUSED);
-        else
-            painter.setPen(COLOR_SCOREBOARD_TIME_PAUSED);
-        painter.drawText(timeRect, Qt::AlignVCenter | Qt::AlignRight, QString("%1:%2").arg(minutes, seconds));
-    }
-
-    auto osaekomi = params.match.getOsaekomi();
-    if (osaekomi.has_value()) {
-        // Paint osaekomi indicator
-        QRect osaekomiRect(columnThree, PADDING, rect.width() - columnThree - PADDING, rect.height()-PADDING*2);
-
-        unsigned int seconds = std::chrono::floor<std::chrono::seconds>(params.match.currentOsaekomiTime(params.masterTime)).count();
-        QString secondsString = QString::number(seconds).rightJustified(2, '0');
-
-        font.setPixelSize(rect.height()*5/8);
-        painter.setFont(font);
-
-        painter.setPen(COLOR_SCOREBOARD_OSAEKOMI);
-        painter.drawText(osaekomiRect, Qt::AlignBottom | Qt::AlignRight, secondsString);
-    }
-    else if (params.match.isGoldenScore()) {
-        // Paint golden score indicator
-        QRect goldenScoreRect(columnThree, PADDING, rect.width() - columnThree - PADDING, rect.height()-PADDING*2);
-
-        font.setPixelSize(rect.height()*1/3);
-        painter.setFont(font);
-
-        painter.setPen(COLOR_SCOREBOARD_GOLDEN_SCORE);
-        painter.drawText(goldenScoreRect, Qt::AlignVCenter | Qt::AlignLeft, "GS");
-    }
-
     painter.restore();
 }
 
@@ -347,6 +351,20 @@ void FlagImage::update(std::optional<PlayerCountry> country) {
 }
 
 void InternationalScoreboardPainter::resizeEvent(const QRect &rect) {
+    // Mirrors the layout of paintNormalLower
+    mLowerRect = QRect(0,2*(rect.height()/3),rect.width(), rect.height() - 2*(rect.height()/3));
+
+    const int flagHeight = (mLowerRect.height() - PADDING * 3) / 2;
+    const int flagWidth = flagHeight * 4 / 3;
+
+    const int columnOne = flagWidth + 2 * PADDING;
+    const int columnThree = columnOne + (mLowerRect.width() - columnOne) * 3 / 4;
+    const int columnTwo = columnOne + (columnThree - columnOne) / 3;
+
+    mTimeRect = QRect(columnTwo, mLowerRect.y() + PADDING, columnThree-columnTwo-PADDING, mLowerRect.height()-PADDING*2);
+    mOsaekomiRect = QRect(columnThree, mLowerRect.y() + PADDING, mLowerRect.width() - columnThree - PADDING, mLowerRect.height()-PADDING*2);
 
+    mDynamicRegion = QRegion(mTimeRect).united(mOsaekomiRect);
+    mDynamicRegion.translate(rect.topLeft());
 }
 
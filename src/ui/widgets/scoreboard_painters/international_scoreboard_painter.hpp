@@ -20,9 +20,11 @@ public:
 
     void paintEmpty(QPainter &painter, const QRect &rect) override;
     void paintIntroduction(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
-    void paintNormal(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
     void paintWinner(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
 
+    void paintNormalStatic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
+    void paintNormalDynamic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
+
     void resizeEvent(const QRect &rect) override;
 
 private:
@@ -36,5 +38,10 @@ private:
 
     QFont mFont;
     std::array<FlagImage,2> mFlags;
+
+    // Dynamic layer rectangles, relative to the painted rectangle
+    QRect mLowerRect;
+    QRect mTimeRect;
+    QRect mOsaekomiRect;
 };
 
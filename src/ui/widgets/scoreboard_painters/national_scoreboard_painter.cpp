@@ -28,7 +28,7 @@ void NationalScoreboardPainter::paintIntroduction(QPainter &painter, const QRect
     paintIntroductionLower(painter, params);
 }
 
-void NationalScoreboardPainter::paintNormal(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) {
+void NationalScoreboardPainter::paintNormalStatic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) {
     painter.save();
     painter.translate(rect.topLeft());
     paintNormalPlayer(painter, params, MatchStore::PlayerIndex::WHITE);
@@ -37,6 +37,70 @@ void NationalScoreboardPainter::paintNormal(QPainter &painter, const QRect &rect
     painter.restore();
 }
 
+void NationalScoreboardPainter::paintNormalDynamic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) {
+    const auto &ruleset = params.category.getRuleset();
+
+    painter.save();
+    painter.translate(rect.topLeft());
+
+    // Blink the score of the player about to be awarded an osaekomi wazari
+    auto osaekomi = params.match.getOsaekomi();
+    if (params.blink && osaekomi.has_value() && params.match.isOsaekomiWazari()) {
+        const bool isWhitePlayer = osaekomi->first == MatchStore::PlayerIndex::WHITE;
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(isWhitePlayer ? COLOR_SCOREBOARD_WHITE : COLOR_SCOREBOARD_BLUE);
+        painter.drawRect(isWhitePlayer ? mWhiteScoreRect : mBlueScoreRect);
+    }
+
+    auto font = mFont;
+
+    // Paint time left
+    {
+        auto time = std::chrono::ceil<std::chrono::seconds>(std::chrono::abs(ruleset.getNormalTime() - params.match.currentDuration(params.masterTime)));
+        QString seconds = QString::number((time % std::chrono::minutes(1)).count()).rightJustified(2, '0');
+        QString minutes = QString::number(std::chrono::duration_cast<std::chrono::minutes>(time).count());
+
+        font.setPixelSize(mDurationFontSize);
+        painter.setFont(font);
+
+        if (params.match.getStatus() == MatchStatus::UNPAUSED)
+            painter.setPen(COLOR_SCOREBOARD_TIME_UNPAUSED);
+        else
+            painter.setPen(COLOR_SCOREBOARD_TIME_PAUSED);
+
+        QString durationText;
+        if (params.blink)
+            durationText = QString("%1 %2").arg(minutes, seconds);
+        else
+            durationText = QString("%1:%2").arg(minutes, seconds);
+
+        painter.drawText(mDurationRect, Qt::AlignVCenter | Qt::AlignRight, durationText);
+    }
+
+    if (osaekomi.has_value()) {
+        // Paint osaekomi indicator
+        unsigned int seconds = std::chrono::floor<std::chrono::seconds>(params.match.currentOsaekomiTime(params.masterTime)).count();
+        QString secondsString = QString::number(seconds).rightJustified(2, '0');
+
+        font.setPixelSize(mOsaekomiFontSize);
+        painter.setFont(font);
+
+        painter.setPen(COLOR_SCOREBOARD_OSAEKOMI);
+        painter.drawText(mOsaekomiRect, Qt::AlignBottom | Qt::AlignRight, secondsString);
+    }
+
+    if (params.match.isGoldenScore()) {
+        // Paint golden score indicator
+        font.setPixelSize(mGoldenScoreFontSize);
+        painter.setFont(font);
+
+        painter.setPen(COLOR_SCOREBOARD_GOLDEN_SCORE);
+        painter.drawText(mGoldenScoreRect, Qt::AlignVCenter | Qt::AlignLeft, "GS");
+    }
+
+    painter.restore();
+}
+
 void NationalScoreboardPainter::paintWinner(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) {
     paintNormal(painter, rect, params);
 }
@@ -139,17 +203,8 @@ void NationalScoreboardPainter::paintNormalPlayer(QPainter &painter, const Score
     else
         scoreText = QString::number(score.wazari);
 
-    bool blinkScore = false;
-    if (params.blink) {
-        auto osaekomi = params.match.getOsaekomi();
-        if (osaekomi.has_value() && osaekomi->first == playerIndex && params.match.isOsaekomiWazari())
-            blinkScore = true;
-    }
-
-    if (!blinkScore) {
-        const auto scoreRect = (isWhitePlayer ? mWhiteScoreRect : mBlueScoreRect);
-        painter.drawText(scoreRect, Qt::AlignBottom | Qt::AlignRight, scoreText);
-    }
+    const auto scoreRect = (isWhitePlayer ? mWhiteScoreRect : mBlueScoreRect);
+    painter.drawText(scoreRect, Qt::AlignBottom | Qt::AlignRight, scoreText);
 
     // Penalties
     if (score.hansokuMake) {
@@ -169,8 +224,6 @@ void NationalScoreboardPainter::paintNormalPlayer(QPainter &painter, const Score
 }
 
 void NationalScoreboardPainter::paintNormalLower(QPainter &painter, const ScoreboardPainterParams &params) {
-    const auto &ruleset = params.category.getRuleset();
-
     // Paint background
     painter.setPen(Qt::NoPen);
     painter.setBrush(COLOR_SCOREBOARD_BLACK);
@@ -190,51 +243,6 @@ void NationalScoreboardPainter::paintNormalLower(QPainter &painter, const Scoreb
     painter.setFont(font);
 
     painter.drawText(mNormalCategoryRect, Qt::AlignTop | Qt::AlignLeft, QString::fromStdString(params.category.getName()));
-
-    // Paint time left
-    {
-        auto time = std::chrono::ceil<std::chrono::seconds>(std::chrono::abs(ruleset.getNormalTime() - params.match.currentDuration(params.masterTime)));
-        QString seconds = QString::number((time % std::chrono::minutes(1)).count()).rightJustified(2, '0');
-        QString minutes = QString::number(std::chrono::duration_cast<std::chrono::minutes>(time).count());
-
-        font.setPixelSize(mDurationFontSize);
-        painter.setFont(font);
-
-        if (params.match.getStatus() == MatchStatus::UNPAUSED)
-            painter.setPen(COLOR_SCOREBOARD_TIME_UNPAUSED);
-        else
-            painter.setPen(COLOR_SCOREBOARD_TIME_PAUSED);
-
-        QString durationText;
-        if (params.blink)
-            durationText = QString("%1 %2").arg(minutes, seconds);
-        else
-            durationText = QString("%1:%2").arg(minutes, seconds);
-
-        painter.drawText(mDurationRect, Qt::AlignVCenter | Qt::AlignRight, durationText);
-    }
-
-    auto osaekomi = params.match.getOsaekomi();
-    if (osaekomi.has_value()) {
-        // Paint osaekomi indicator
-        unsigned int seconds = std::chrono::floor<std::chrono::seconds>(params.match.currentOsaekomiTime(params.masterTime)).count();
-        QString secondsString = QString::number(seconds).rightJustified(2, '0');
-
-        font.setPixelSize(mOsaekomiFontSize);
-        painter.setFont(font);
-
-        painter.setPen(COLOR_SCOREBOARD_OSAEKOMI);
-        painter.drawText(mOsaekomiRect, Qt::AlignBottom | Qt::AlignRight, secondsString);
-    }
-
-    if (params.match.isGoldenScore()) {
-        // Paint golden score indicator
-        font.setPixelSize(mGoldenScoreFontSize);
-        painter.setFont(font);
-
-        painter.setPen(COLOR_SCOREBOARD_GOLDEN_SCORE);
-        painter.drawText(mGoldenScoreRect, Qt::AlignVCenter | Qt::AlignLeft, "GS");
-    }
 }
 
 void NationalScoreboardPainter::resizeEvent(const QRect &rect) {
@@ -339,5 +347,9 @@ void NationalScoreboardPainter::resizeEvent(const QRect &rect) {
     mOsaekomiRect = QRect(mColumnThree, osaekomiOffset, rect.width() - mColumnThree - PADDING, osaekomiHeight);
     mWhiteOsaekomiRect = QRect(mColumnThree, osaekomiOffset, rect.width() - mColumnThree - PADDING, osaekomiHeight/2);
     mBlueOsaekomiRect = QRect(mColumnThree, osaekomiOffset + PADDING + osaekomiHeight/2, rect.width() - mColumnThree - PADDING, osaekomiHeight - osaekomiHeight/2 - PADDING);
+
+    mDynamicRegion = QRegion(mDurationRect).united(mGoldenScoreRect).united(mOsaekomiRect);
+    mDynamicRegion = mDynamicRegion.united(mWhiteScoreRect).united(mBlueScoreRect);
+    mDynamicRegion.translate(rect.topLeft());
 }
 
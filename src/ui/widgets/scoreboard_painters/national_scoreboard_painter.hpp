@@ -12,9 +12,11 @@ public:
 
     void paintEmpty(QPainter &painter, const QRect &rect) override;
     void paintIntroduction(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
-    void paintNormal(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
     void paintWinner(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
 
+    void paintNormalStatic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
+    void paintNormalDynamic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) override;
+
     void resizeEvent(const QRect &rect) override;
 
 private:
@@ -3,6 +3,11 @@
 #include "ui/widgets/colors.hpp"
 #include "ui/widgets/scoreboard_painters/scoreboard_painter.hpp"
 
+void ScoreboardPainter::paintNormal(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) {
+    paintNormalStatic(painter, rect, params);
+    paintNormalDynamic(painter, rect, params);
+}
+
 const QRect& ScoreboardPainter::getDurationRect() const {
     return mDurationRect;
 }
@@ -47,3 +52,6 @@ const QRect& ScoreboardPainter::getBlueHansokuRect() const {
     return mBlueHansokuRect;
 }
 
+const QRegion& ScoreboardPainter::getDynamicRegion() const {
+    return mDynamicRegion;
+}
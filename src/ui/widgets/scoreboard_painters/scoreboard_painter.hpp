@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <QRect>
+#include <QRegion>
 #include "core/core.hpp"
 
 class QPainter;
@@ -26,9 +27,16 @@ public:
 
     virtual void paintEmpty(QPainter &painter, const QRect &rect) = 0;
     virtual void paintIntroduction(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) = 0;
-    virtual void paintNormal(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) = 0;
+    virtual void paintNormal(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params);
     virtual void paintWinner(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) = 0;
 
+    // The normal mode is painted in two layers. The static layer only depends
+    // on the match, players and category and may be cached between frames.
+    // The dynamic layer (clock and osaekomi) is painted on top of it and must
+    // stay within the dynamic region
+    virtual void paintNormalStatic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) = 0;
+    virtual void paintNormalDynamic(QPainter &painter, const QRect &rect, const ScoreboardPainterParams &params) = 0;
+
     virtual void resizeEvent(const QRect &rect) = 0;
 
     const QRect& getDurationRect() const;
@@ -42,6 +50,7 @@ public:
     const QRect& getWhiteHansokuRect() const;
     const QRect& getBlueShidoRect() const;
     const QRect& getBlueHansokuRect() const;
+    const QRegion& getDynamicRegion() const; // Area repainted on every tick. Computed on resize
 
 protected:
     QRect mDurationRect;
@@ -59,5 +68,7 @@ protected:
 
     QRect mBlueShidoRect;
     QRect mBlueHansokuRect;
+
+    QRegion mDynamicRegion;
 };
 
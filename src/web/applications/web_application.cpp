@@ -41,8 +41,13 @@ int main(int argc, char *argv[]) {
             ("port", po::value<unsigned int>(&configuration.port)->default_value(9000), "tcp server port")
             ("web-port", po::value<unsigned int>(&configuration.webPort)->default_value(9001), "web socket server port")
             ("postgres", po::value<std::string>(&configuration.postgres)->default_value(""), "postgres connection info")
+            ("database-connections", po::value<unsigned int>(&configuration.databaseConnections)->default_value(4), "number of postgres connections to open, each served by its own query thread")
             ("workers", po::value<unsigned int>(&configuration.workers)->default_value(std::thread::hardware_concurrency()), "name of worker threads to launch")
             ("data-dir", po::value<boost::filesystem::path>(&configuration.dataDirectory)->default_value("tournaments"), "directory to store tournament data")
+            ("tournament-memory", po::value<size_t>(&configuration.tournamentMemoryBudget)->default_value(1024), "megabytes of tournament data to keep loaded")
+            ("tournament-idle-timeout", po::value<unsigned int>(&configuration.tournamentIdleTimeout)->default_value(60), "minutes before an unused tournament is unloaded")
+            ("metrics-port", po::value<unsigned int>(&configuration.metricsPort)->default_value(0), "localhost port serving prometheus metrics (0 to disable)")
+            ("tournament-shards", po::value<unsigned int>(&configuration.tournamentShards)->default_value(0), "number of pinned threads to shard tournaments onto (0 to run them on the workers)")
             ;
 
         po::options_description cmdOptions;
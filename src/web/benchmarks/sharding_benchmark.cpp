@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <atomic>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context_strand.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include "core/actions/add_category_action.hpp"
+#include "core/actions/add_category_with_players_action.hpp"
+#include "core/actions/add_players_to_category_action.hpp"
+#include "core/actions/add_players_action.hpp"
+#include "core/actions/draw_categories_action.hpp"
+#include "core/actions/pause_match_action.hpp"
+#include "core/actions/resume_match_action.hpp"
+#include "core/draw_systems/draw_system.hpp"
+#include "core/log.hpp"
+#include "core/rulesets/ruleset.hpp"
+#include "core/stores/category_store.hpp"
+#include "core/stores/match_store.hpp"
+#include "web/config.hpp"
+#include "web/web_server.hpp"
+
+// Load generator comparing tournaments run on the worker pool against
+// tournaments pinned to shards. Every simulated hub syncs its own tournament
+// and then keeps a window of match clock actions in flight, each timed from
+// dispatch until its callback runs
+
+namespace po = boost::program_options;
+
+struct BenchmarkOptions {
+    unsigned int tournaments;
+    unsigned int players; // Players per tournament, drawn into pools
+    unsigned int categorySize;
+    unsigned int actions; // Actions dispatched per tournament
+    unsigned int window; // Actions each hub keeps in flight
+    unsigned int hubThreads;
+};
+
+struct BenchmarkResult {
+    std::chrono::steady_clock::duration duration;
+    std::vector<std::chrono::microseconds> latencies;
+    size_t rejected;
+};
+
+class Latch {
+public:
+    Latch(size_t count) : mCount(count) {}
+
+    void countDown() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (--mCount == 0)
+            mCondition.notify_all();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this]() { return mCount == 0; });
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    size_t mCount;
+};
+
+// State of a simulated hub. Only accessed on its strand once the tournament is synced
+struct Hub {
+    Hub(boost::asio::io_context &context) : strand(context), clientId(ClientId::generate()), sent(0), completed(0), rejected(0) {}
+
+    boost::asio::io_context::strand strand;
+    ClientId clientId;
+    std::shared_ptr<LoadedTournament> tournament;
+    std::vector<CombinedId> matches;
+    size_t sent;
+    size_t completed;
+    size_t rejected;
+    std::vector<std::chrono::microseconds> latencies;
+};
+
+std::unique_ptr<WebTournamentStore> createTournament(const BenchmarkOptions &options, std::vector<CombinedId> &matches) {
+    auto tournament = std::make_unique<WebTournamentStore>();
+
+    std::vector<PlayerFields> fields(options.players);
+    for (size_t i = 0; i < fields.size(); ++i) {
+        fields[i].firstName = "Player";
+        fields[i].lastName = std::to_string(i);
+        fields[i].club = "Club " + std::to_string(i % 16);
+    }
+    AddPlayersAction(*tournament, fields).redo(*tournament);
+
+    std::vector<PlayerId> playerIds;
+    for (const auto &p : tournament->getPlayers())
+        playerIds.push_back(p.first);
+
+    for (size_t i = 0; i < playerIds.size(); i += options.categorySize) {
+        std::vector<PlayerId> categoryPlayers(playerIds.begin() + i, playerIds.begin() + std::min<size_t>(i + options.categorySize, playerIds.size()));
+        AddCategoryWithPlayersAction(*tournament, "Category " + std::to_string(i / options.categorySize), RulesetIdentifier::TWENTY_EIGHTEEN, DrawSystemIdentifier::POOL, categoryPlayers).redo(*tournament);
+    }
+
+    for (const auto &p : tournament->getCategories()) {
+        for (const MatchStore &match : p.second->getMatches())
+            matches.push_back(match.getCombinedId());
+    }
+
+    tournament->clearChanges();
+    return tournament;
+}
+
+// Resumes and pauses the matches in turn. The master time advances a
+// millisecond per action so that no match runs out of time
+void dispatchNext(std::shared_ptr<Hub> hub, const BenchmarkOptions &options, Latch &latch) {
+    const size_t index = hub->sent++;
+    const CombinedId combinedId = hub->matches[(index / 2) % hub->matches.size()];
+    const std::chrono::milliseconds masterTime(index);
+
+    std::shared_ptr<Action> action;
+    if (index % 2 == 0)
+        action = std::make_shared<ResumeMatchAction>(combinedId, masterTime);
+    else
+        action = std::make_shared<PauseMatchAction>(combinedId, masterTime);
+
+    const auto dispatchTime = std::chrono::steady_clock::now();
+    hub->tournament->dispatch(ClientActionId(hub->clientId, ActionId::generate()), std::move(action), [hub, &options, &latch, dispatchTime](bool success) {
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - dispatchTime);
+
+        boost::asio::post(hub->strand, [hub, &options, &latch, latency, success]() {
+            hub->latencies.push_back(latency);
+            if (!success)
+                ++(hub->rejected);
+
+            if (hub->sent < options.actions)
+                dispatchNext(hub, options, latch);
+
+            if (++(hub->completed) == options.actions)
+                latch.countDown();
+        });
+    });
+}
+
+BenchmarkResult runBenchmark(const Config &config, const BenchmarkOptions &options, const std::string &prefix) {
+    WebServer server(config);
+    std::thread serverThread([&server]() { server.run(); });
+
+    boost::asio::io_context hubContext(options.hubThreads);
+    auto hubWork = boost::asio::make_work_guard(hubContext);
+    std::vector<std::thread> hubThreads;
+    for (size_t i = 0; i < options.hubThreads; ++i)
+        hubThreads.emplace_back([&hubContext]() { hubContext.run(); });
+
+    std::vector<std::shared_ptr<Hub>> hubs;
+    for (size_t i = 0; i < options.tournaments; ++i)
+        hubs.push_back(std::make_shared<Hub>(hubContext));
+
+    // Seed every tournament the way a hub does when it first connects
+    Latch syncLatch(hubs.size());
+    std::atomic<size_t> syncFailures(0);
+    for (size_t i = 0; i < hubs.size(); ++i) {
+        auto hub = hubs[i];
+        auto tournament = createTournament(options, hub->matches);
+
+        // Callbacks have to be copyable, so the store is handed over through a shared pointer
+        auto holder = std::make_shared<std::unique_ptr<WebTournamentStore>>(std::move(tournament));
+        server.acquireTournament(prefix + std::to_string(i), [hub, holder, &syncLatch, &syncFailures](std::shared_ptr<LoadedTournament> loadedTournament) {
+            hub->tournament = loadedTournament;
+            loadedTournament->sync(std::move(*holder), SharedActionList(), std::chrono::milliseconds(0), [&syncLatch, &syncFailures](bool success) {
+                if (!success)
+                    ++syncFailures;
+                syncLatch.countDown();
+            });
+        });
+    }
+    syncLatch.wait();
+
+    if (syncFailures > 0)
+        log_warning().field("count", syncFailures.load()).msg("Failed syncing tournaments");
+
+    Latch actionLatch(hubs.size());
+    const auto startTime = std::chrono::steady_clock::now();
+    for (auto &hub : hubs) {
+        boost::asio::post(hub->strand, [hub, &options, &actionLatch]() {
+            for (size_t i = 0; i < options.window && hub->sent < options.actions; ++i)
+                dispatchNext(hub, options, actionLatch);
+        });
+    }
+    actionLatch.wait();
+
+    BenchmarkResult result;
+    result.duration = std::chrono::steady_clock::now() - startTime;
+    result.rejected = 0;
+
+    server.quit();
+    hubWork.reset();
+    for (std::thread &thread : hubThreads)
+        thread.join();
+    serverThread.join();
+
+    for (const auto &hub : hubs) {
+        result.latencies.insert(result.latencies.end(), hub->latencies.begin(), hub->latencies.end());
+        result.rejected += hub->rejected;
+    }
+
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+std::chrono::microseconds getPercentile(const std::vector<std::chrono::microseconds> &latencies, double percentile) {
+    if (latencies.empty())
+        return std::chrono::microseconds(0);
+    const size_t index = std::min<size_t>(latencies.size() - 1, static_cast<size_t>(percentile / 100 * latencies.size()));
+    return latencies[index];
+}
+
+void printResult(const std::string &mode, const BenchmarkResult &result) {
+    const double seconds = std::chrono::duration<double>(result.duration).count();
+
+    std::cout << std::left << std::setw(10) << mode << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0) << (result.latencies.size() / seconds)
+              << std::setw(10) << getPercentile(result.latencies, 50).count()
+              << std::setw(10) << getPercentile(result.latencies, 99).count()
+              << std::setw(10) << getPercentile(result.latencies, 99.9).count()
+              << std::setw(10) << (result.latencies.empty() ? 0 : result.latencies.back().count())
+              << std::setw(10) << result.rejected
+              << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    try {
+        Config configuration;
+        BenchmarkOptions options;
+        unsigned int shards;
+
+        po::options_description description("Allowed options");
+        description.add_options()
+            ("help", "produce help message")
+            ("postgres", po::value<std::string>(&configuration.postgres)->default_value(""), "postgres connection info")
+            ("database-connections", po::value<unsigned int>(&configuration.databaseConnections)->default_value(4), "number of postgres connections to open")
+            ("workers", po::value<unsigned int>(&configuration.workers)->default_value(std::thread::hardware_concurrency()), "number of worker threads to launch")
+            ("tournament-shards", po::value<unsigned int>(&shards)->default_value(std::thread::hardware_concurrency()), "number of pinned threads to shard tournaments onto in the sharded run")
+            ("data-dir", po::value<boost::filesystem::path>(&configuration.dataDirectory)->default_value("benchmark-tournaments"), "directory to store tournament data")
+            ("tournaments", po::value<unsigned int>(&options.tournaments)->default_value(64), "number of tournaments, each driven by its own simulated hub")
+            ("players", po::value<unsigned int>(&options.players)->default_value(64), "number of players per tournament")
+            ("category-size", po::value<unsigned int>(&options.categorySize)->default_value(4), "number of players per pool")
+            ("actions", po::value<unsigned int>(&options.actions)->default_value(5000), "number of actions dispatched per tournament")
+            ("window", po::value<unsigned int>(&options.window)->default_value(4), "number of actions each hub keeps in flight")
+            ("hub-threads", po::value<unsigned int>(&options.hubThreads)->default_value(2), "number of threads running the simulated hubs")
+            ;
+
+        po::variables_map vm;
+        store(po::command_line_parser(argc, argv).options(description).run(), vm);
+        notify(vm);
+
+        if (vm.count("help")) {
+            std::cout << description << std::endl;
+            return 0;
+        }
+
+        if (options.categorySize < 2) {
+            log_error().field("categorySize", options.categorySize).msg("Pools need at least two players");
+            return 1;
+        }
+
+        if (options.players < options.categorySize) {
+            log_error().field("players", options.players).msg("Not enough players to fill a pool");
+            return 1;
+        }
+
+        // Listen on ephemeral ports and keep every tournament loaded for the whole run
+        configuration.port = 0;
+        configuration.webPort = 0;
+        configuration.metricsPort = 0;
+        configuration.tournamentMemoryBudget = std::numeric_limits<size_t>::max() / (1024 * 1024);
+        configuration.tournamentIdleTimeout = std::numeric_limits<unsigned int>::max() / 60;
+
+        // Fresh web names so that earlier runs are never loaded from the data directory
+        const std::string runId = ClientId::generate().toString();
+
+        std::cout << std::left << std::setw(10) << "mode" << std::right
+                  << std::setw(14) << "actions/s"
+                  << std::setw(10) << "p50 us"
+                  << std::setw(10) << "p99 us"
+                  << std::setw(10) << "p99.9 us"
+                  << std::setw(10) << "max us"
+                  << std::setw(10) << "rejected"
+                  << std::endl;
+
+        configuration.tournamentShards = 0;
+        printResult("pool", runBenchmark(configuration, options, "benchmark-" + runId + "-pool-"));
+
+        configuration.tournamentShards = shards;
+        printResult("sharded", runBenchmark(configuration, options, "benchmark-" + runId + "-sharded-"));
+    }
+    catch(const std::exception& e) {
+        log_error().field("what", e.what()).msg("Exception occured");
+        return 1;
+    }
+
+    return 0;
+}
+
@@ -8,6 +8,11 @@ struct Config {
     unsigned int webPort;
     unsigned int workers;
     std::string postgres;
+    unsigned int databaseConnections;
     boost::filesystem::path dataDirectory;
+    size_t tournamentMemoryBudget; // Megabytes of loaded tournament data before the least recently used are unloaded
+    unsigned int tournamentIdleTimeout; // Minutes without activity before a tournament is unloaded
+    unsigned int metricsPort; // Local port serving metrics in the Prometheus text format. Zero disables it
+    unsigned int tournamentShards; // Single-threaded contexts tournaments are pinned to by name. Zero runs them on the worker pool
 };
 
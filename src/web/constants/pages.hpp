@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Constants {
+    constexpr size_t MAX_PAGE_SIZE = 200; // Maximum number of players or categories sent per page
+}
+
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace Constants {
+    constexpr std::chrono::seconds UNLOAD_INTERVAL(60); // Time between checks for tournaments to unload
+    constexpr std::chrono::seconds MIN_UNLOAD_IDLE_TIME(60); // Recently accessed tournaments are kept even when over the memory budget
+    constexpr std::chrono::seconds LISTING_TTL(60); // Maximum age of the cached tournament listing
+    constexpr size_t JOURNAL_COMPACTION_SIZE = 1000; // Number of journal records triggering a save
+    constexpr std::chrono::minutes JOURNAL_COMPACTION_INTERVAL(5); // Maximum age of unsaved journal records
+    constexpr std::chrono::milliseconds CLOCK_DIFF_TOLERANCE(250); // Change in a hub's measured clock offset that is sent to participants
+    constexpr size_t STORAGE_THREADS = 2; // Threads compressing and writing journals and save-files
+}
+
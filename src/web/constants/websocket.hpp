@@ -0,0 +1,20 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace Constants {
+    // permessage-deflate settings. Context takeover is kept enabled so every
+    // message is compressed against the window of the previous ones, which
+    // pays off for the repetitive keys and values of tournament updates
+    constexpr int WEBSOCKET_DEFLATE_WINDOW_BITS = 15;
+    constexpr int WEBSOCKET_DEFLATE_LEVEL = 6;
+    constexpr int WEBSOCKET_DEFLATE_MEM_LEVEL = 4; // Keeps the per connection deflate state small
+
+    constexpr size_t WEBSOCKET_QUEUE_SOFT_LIMIT = 32; // Queued messages before pending updates are replaced by a fresh subscription
+    constexpr size_t WEBSOCKET_QUEUE_HARD_LIMIT = 256; // Queued messages before a participant is at risk of being disconnected
+    constexpr std::chrono::seconds WEBSOCKET_QUEUE_HARD_LIMIT_TIME(10); // Time a participant may stay over the hard limit
+
+    constexpr size_t MAX_SUBSCRIPTIONS = 64; // Categories, players and tatamis a participant may subscribe to at once
+}
+
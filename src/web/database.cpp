@@ -1,4 +1,5 @@
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <botan-2/botan/bcrypt.h>
 #include <botan-2/botan/rng.h>
@@ -9,56 +10,139 @@
 #include "core/log.hpp"
 #include "web/constants/database.hpp"
 #include "web/database.hpp"
+#include "web/metrics.hpp"
 
-Database::Database(boost::asio::io_context &context, const std::string &config)
+Database::Database(boost::asio::io_context &context, const std::string &config, size_t connectionCount)
     : mContext(context)
-    , mStrand(context)
-    , mConnection(config)
-{}
+    , mQueryContext(std::max<size_t>(connectionCount, 1))
+    , mListingVersion(0)
+{
+    for (size_t i = 0; i < std::max<size_t>(connectionCount, 1); ++i) {
+        auto connection = std::make_unique<pqxx::connection>(config);
+        prepareStatements(*connection);
+        mIdleConnections.push_back(connection.get());
+        mConnections.push_back(std::move(connection));
+    }
+
+    // A connection is only ever used by one request at a time, so there is
+    // no use for more threads than connections
+    mQueryWork.emplace(boost::asio::make_work_guard(mQueryContext));
+    for (size_t i = 0; i < mConnections.size(); ++i)
+        mQueryThreads.emplace_back([this]() { mQueryContext.run(); });
+}
+
+Database::~Database() {
+    mQueryWork.reset();
+    for (std::thread &thread : mQueryThreads)
+        thread.join();
+}
+
+void Database::prepareStatements(pqxx::connection &connection) {
+    connection.prepare("has_user", "select 1 FROM users where email = $1");
+    connection.prepare("get_password_hash", "select password_hash FROM users where email = $1");
+    connection.prepare("validate_token", "select id, token_expiration FROM users where email = $1 and token = $2");
+    connection.prepare("insert_user", "insert into users (email, password_hash, token, token_expiration) values ($1, $2, $3, $4) returning id");
+    connection.prepare("update_token", "update users set token=$1, token_expiration=$2 where email=$3 returning id");
+    connection.prepare("get_web_name", "select owner, tournament_id FROM tournaments where web_name = $1");
+    connection.prepare("insert_web_name", "insert into tournaments (owner, tournament_id, web_name) values ($1, $2, $3)");
+    connection.prepare("update_web_name", "update tournaments set synced=false, tournament_id=$1 WHERE web_name=$2");
+    connection.prepare("set_synced", "update tournaments set synced=true where web_name=$1");
+    connection.prepare("set_save_time", "update tournaments set save_time=$1 where web_name=$2");
+    connection.prepare("get_save_status", "select 1 FROM tournaments where web_name = $1 and synced = true and save_time IS NOT NULL");
+    connection.prepare("update_tournament", "update tournaments set name=$1, location=$2, date=$3 where web_name=$4");
+    connection.prepare("list_upcoming_tournaments", "select web_name, name, location, date FROM tournaments where date >= $1 order by date asc limit 20");
+    connection.prepare("list_past_tournaments", "select web_name, name, location, date FROM tournaments where date < $1 order by date desc limit 20");
+}
+
+void Database::execute(Request request) {
+    // Time spent waiting for a connection is measured separately from the query
+    metrics().pendingQueries.increment();
+    // The guard keeps the callback context alive until the callback has been dispatched
+    request = [request = std::move(request), queueTime = std::chrono::steady_clock::now(), work = boost::asio::make_work_guard(mContext)](pqxx::connection &connection) {
+        const auto startTime = std::chrono::steady_clock::now();
+        metrics().queryWaitDuration.observe(startTime - queueTime);
+        request(connection);
+        metrics().queryDuration.observe(std::chrono::steady_clock::now() - startTime);
+        metrics().pendingQueries.decrement();
+    };
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mIdleConnections.empty()) {
+        mPendingRequests.push(std::move(request));
+        return;
+    }
+
+    pqxx::connection *connection = mIdleConnections.back();
+    mIdleConnections.pop_back();
+    lock.unlock();
+
+    boost::asio::post(mQueryContext, [this, connection, request = std::move(request)]() {
+        run(*connection, request);
+    });
+}
+
+void Database::run(pqxx::connection &connection, const Request &request) {
+    request(connection);
+
+    // Hand the connection to the next pending request or return it to the pool
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mPendingRequests.empty()) {
+        mIdleConnections.push_back(&connection);
+        return;
+    }
+
+    Request next = std::move(mPendingRequests.front());
+    mPendingRequests.pop();
+    lock.unlock();
+
+    boost::asio::post(mQueryContext, [this, &connection, next = std::move(next)]() {
+        run(connection, next);
+    });
+}
 
 void Database::asyncRequestWebToken(const std::string &email, const std::string &password, WebTokenRequestCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::requestWebToken, this, email, password, callback));
+    execute(std::bind(&Database::requestWebToken, this, std::placeholders::_1, email, password, callback));
 }
 
 void Database::asyncValidateWebToken(const std::string &email, const WebToken &token, WebTokenValidationCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::validateWebToken, this, email, token, callback));
+    execute(std::bind(&Database::validateWebToken, this, std::placeholders::_1, email, token, callback));
 }
 
 void Database::asyncRegisterUser(const std::string &email, const std::string &password, UserRegistrationCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::registerUser, this, email, password, callback));
+    execute(std::bind(&Database::registerUser, this, std::placeholders::_1, email, password, callback));
 }
 
 void Database::asyncCheckWebName(int userId, const TournamentId &id, const std::string &webName, WebNameCheckCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::checkWebName, this, userId, id, webName, callback));
+    execute(std::bind(&Database::checkWebName, this, std::placeholders::_1, userId, id, webName, callback));
 }
 
 void Database::asyncRegisterWebName(int userId, const TournamentId &id, const std::string &webName, WebNameRegistrationCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::registerWebName, this, userId, id, webName, callback));
+    execute(std::bind(&Database::registerWebName, this, std::placeholders::_1, userId, id, webName, callback));
 }
 
 void Database::asyncSetSynced(const std::string &webName, SyncedSetCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::setSynced, this, webName, callback));
+    execute(std::bind(&Database::setSynced, this, std::placeholders::_1, webName, callback));
 }
 
 void Database::asyncSetSaveTime(const std::string &webName, std::chrono::system_clock::time_point time, SaveTimeSetCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::setSaveTime, this, webName, time, callback));
+    execute(std::bind(&Database::setSaveTime, this, std::placeholders::_1, webName, time, callback));
 }
 
 void Database::asyncGetSaveStatus(const std::string &webName, SaveStatusGetCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::getSaveStatus, this, webName, callback));
+    execute(std::bind(&Database::getSaveStatus, this, std::placeholders::_1, webName, callback));
 }
 
-bool Database::hasUser(const std::string &email) {
-    pqxx::work work(mConnection);
-    pqxx::result r = work.exec("select 1 FROM users where email = " + work.quote(email));
+bool Database::hasUser(pqxx::connection &connection, const std::string &email) {
+    pqxx::work work(connection);
+    pqxx::result r = work.exec_prepared("has_user", email);
     work.commit();
 
     return (r.size() > 0);
 }
 
-bool Database::checkPassword(const std::string &email, const std::string &password) {
-    pqxx::work work(mConnection);
-    pqxx::result r = work.exec("select password_hash FROM users where email = " + work.quote(email));
+bool Database::checkPassword(pqxx::connection &connection, const std::string &email, const std::string &password) {
+    pqxx::work work(connection);
+    pqxx::result r = work.exec_prepared("get_password_hash", email);
     work.commit();
 
     if (r.empty())
@@ -68,12 +152,10 @@ bool Database::checkPassword(const std::string &email, const std::string &passwo
     return Botan::check_bcrypt(password, hash);
 }
 
-void Database::validateWebToken(const std::string &email, const WebToken &token, WebTokenValidationCallback callback) {
+void Database::validateWebToken(pqxx::connection &connection, const std::string &email, const WebToken &token, WebTokenValidationCallback callback) {
     try {
-        pqxx::work work(mConnection);
-        pqxx::result r = work.exec("select id, token_expiration FROM users where email = "
-                                + work.quote(email)
-                                + " and token = " + work.quote_raw(token.data(), token.size()));
+        pqxx::work work(connection);
+        pqxx::result r = work.exec_prepared("validate_token", email, pqxx::binarystring(token.data(), token.size()));
         work.commit();
 
         if (r.size() == 0) {
@@ -95,9 +177,9 @@ void Database::validateWebToken(const std::string &email, const WebToken &token,
     }
 }
 
-void Database::registerUser(const std::string &email, const std::string &password, UserRegistrationCallback callback) {
+void Database::registerUser(pqxx::connection &connection, const std::string &email, const std::string &password, UserRegistrationCallback callback) {
     try {
-        if (hasUser(email)) {
+        if (hasUser(connection, email)) {
             callback(UserRegistrationResponse::EMAIL_EXISTS, std::nullopt, std::nullopt);
             return;
         }
@@ -108,13 +190,8 @@ void Database::registerUser(const std::string &email, const std::string &passwor
         auto &rng = Botan::system_rng();
         std::string passwordHash = Botan::generate_bcrypt(password, rng);
 
-        pqxx::work work(mConnection);
-        pqxx::result r = work.exec("insert into users (email, password_hash, token, token_expiration) values ("
-                                + work.quote(email)
-                                + ", " + work.quote(passwordHash)
-                                + ", " + work.quote_raw(token.data(), token.size())
-                                + ", " + work.quote(tokenExpiration)
-                                + ") returning id");
+        pqxx::work work(connection);
+        pqxx::result r = work.exec_prepared("insert_user", email, passwordHash, pqxx::binarystring(token.data(), token.size()), tokenExpiration);
         work.commit();
 
         auto userId = r[0][0].as<int>();
@@ -126,9 +203,9 @@ void Database::registerUser(const std::string &email, const std::string &passwor
     }
 }
 
-void Database::requestWebToken(const std::string &email, const std::string &password, WebTokenRequestCallback callback) {
+void Database::requestWebToken(pqxx::connection &connection, const std::string &email, const std::string &password, WebTokenRequestCallback callback) {
     try {
-        if (!checkPassword(email, password)) {
+        if (!checkPassword(connection, email, password)) {
             boost::asio::dispatch(mContext, std::bind(callback, WebTokenRequestResponse::INCORRECT_CREDENTIALS, std::nullopt, std::nullopt));
             return;
         }
@@ -136,11 +213,8 @@ void Database::requestWebToken(const std::string &email, const std::string &pass
         auto token = generateWebToken();
         auto tokenExpiration = generateWebTokenExpiration();
 
-        pqxx::work work(mConnection);
-        pqxx::result r = work.exec("update users set token=" + work.quote_raw(token.data(), token.size())
-                                + ", token_expiration=" + work.quote(tokenExpiration)
-                                + " where email=" + work.quote(email)
-                                + " returning id");
+        pqxx::work work(connection);
+        pqxx::result r = work.exec_prepared("update_token", pqxx::binarystring(token.data(), token.size()), tokenExpiration, email);
         work.commit();
 
         auto userId = r[0][0].as<int>();
@@ -160,11 +234,10 @@ WebToken Database::generateWebToken() {
     return res;
 }
 
-void Database::checkWebName(int userId, const TournamentId &id, const std::string &webName, WebNameCheckCallback callback) {
+void Database::checkWebName(pqxx::connection &connection, int userId, const TournamentId &id, const std::string &webName, WebNameCheckCallback callback) {
     try {
-        pqxx::work work(mConnection);
-        pqxx::result r = work.exec("select owner, tournament_id FROM tournaments where web_name = "
-                                + work.quote(webName));
+        pqxx::work work(connection);
+        pqxx::result r = work.exec_prepared("get_web_name", webName);
         work.commit();
 
         if (r.empty())
@@ -182,11 +255,10 @@ void Database::checkWebName(int userId, const TournamentId &id, const std::strin
     }
 }
 
-void Database::registerWebName(int userId, const TournamentId &id, const std::string &webName, WebNameRegistrationCallback callback) {
+void Database::registerWebName(pqxx::connection &connection, int userId, const TournamentId &id, const std::string &webName, WebNameRegistrationCallback callback) {
     try {
-        pqxx::work work(mConnection);
-        pqxx::result r = work.exec("select owner, tournament_id FROM tournaments where web_name = "
-                                + work.quote(webName));
+        pqxx::work work(connection);
+        pqxx::result r = work.exec_prepared("get_web_name", webName);
         work.commit();
 
 
@@ -201,20 +273,18 @@ void Database::registerWebName(int userId, const TournamentId &id, const std::st
         }
 
         if (r.empty()) {
-            pqxx::work work(mConnection);
-            pqxx::result r = work.exec("insert into tournaments (owner, tournament_id, web_name) values (" + work.quote(userId)
-                                        + ", " + work.quote(id.getValue())
-                                        + ", " + work.quote(webName)
-                                        + ")");
+            pqxx::work work(connection);
+            pqxx::result r = work.exec_prepared("insert_web_name", userId, id.getValue(), webName);
             work.commit();
         }
         else {
-            pqxx::work work(mConnection);
-            pqxx::result r = work.exec("update tournaments set synced=false, tournament_id=" + work.quote(id.getValue())
-                                        + " WHERE web_name=" + work.quote(webName));
+            pqxx::work work(connection);
+            pqxx::result r = work.exec_prepared("update_web_name", id.getValue(), webName);
             work.commit();
         }
 
+        ++mListingVersion;
+
         boost::asio::dispatch(mContext, std::bind(callback, WebNameRegistrationResponse::SUCCESSFUL));
     }
     catch (const std::exception &e) {
@@ -223,10 +293,10 @@ void Database::registerWebName(int userId, const TournamentId &id, const std::st
     }
 }
 
-void Database::setSynced(const std::string &webName, SyncedSetCallback callback) {
+void Database::setSynced(pqxx::connection &connection, const std::string &webName, SyncedSetCallback callback) {
     try {
-        pqxx::work work(mConnection);
-        pqxx::result r = work.exec("update tournaments set synced=true where web_name=" + work.quote(webName));
+        pqxx::work work(connection);
+        pqxx::result r = work.exec_prepared("set_synced", webName);
         work.commit();
 
         boost::asio::dispatch(mContext, std::bind(callback, (r.affected_rows() > 0)));
@@ -252,11 +322,10 @@ std::chrono::system_clock::time_point stringToTime(const std::string &str) {
     return std::chrono::system_clock::from_time_t(std::mktime(&tm));
 }
 
-void Database::setSaveTime(const std::string &webName, std::chrono::system_clock::time_point time, SaveTimeSetCallback callback) {
+void Database::setSaveTime(pqxx::connection &connection, const std::string &webName, std::chrono::system_clock::time_point time, SaveTimeSetCallback callback) {
     try {
-        pqxx::work work(mConnection);
-        pqxx::result r = work.exec("update tournaments set save_time=" + work.quote(timeToString(time))
-                                    + " where web_name=" + work.quote(webName));
+        pqxx::work work(connection);
+        pqxx::result r = work.exec_prepared("set_save_time", timeToString(time), webName);
         work.commit();
 
         boost::asio::dispatch(mContext, std::bind(callback, (r.affected_rows() > 0)));
@@ -267,11 +336,10 @@ void Database::setSaveTime(const std::string &webName, std::chrono::system_clock
     }
 }
 
-void Database::getSaveStatus(const std::string &webName, SaveStatusGetCallback callback) {
+void Database::getSaveStatus(pqxx::connection &connection, const std::string &webName, SaveStatusGetCallback callback) {
     try {
-        pqxx::work work(mConnection);
-        pqxx::result r = work.exec("select 1 FROM tournaments where web_name = " + work.quote(webName)
-                                   + " and synced = true and save_time IS NOT NULL");
+        pqxx::work work(connection);
+        pqxx::result r = work.exec_prepared("get_save_status", webName);
         work.commit();
 
         boost::asio::dispatch(mContext, std::bind(callback, !r.empty()));
@@ -283,18 +351,18 @@ void Database::getSaveStatus(const std::string &webName, SaveStatusGetCallback c
 }
 
 void Database::asyncUpdateTournament(const std::string &webName, const std::string &name, const std::string &location, const std::string &date, UpdateTournamentCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::updateTournament, this, webName, name, location, date, callback));
+    execute(std::bind(&Database::updateTournament, this, std::placeholders::_1, webName, name, location, date, callback));
 }
 
-void Database::updateTournament(const std::string &webName, const std::string &name, const std::string &location, const std::string &date, UpdateTournamentCallback callback) {
+void Database::updateTournament(pqxx::connection &connection, const std::string &webName, const std::string &name, const std::string &location, const std::string &date, UpdateTournamentCallback callback) {
     try {
-        pqxx::work work(mConnection);
-        pqxx::result r = work.exec("update tournaments set name=" + work.quote(name)
-                                    + ", location=" + work.quote(location)
-                                    + ", date=" + work.quote(date)
-                                    + " where web_name=" + work.quote(webName));
+        pqxx::work work(connection);
+        pqxx::result r = work.exec_prepared("update_tournament", name, location, date, webName);
         work.commit();
 
+        if (r.affected_rows() > 0)
+            ++mListingVersion;
+
         boost::asio::dispatch(mContext, std::bind(callback, (r.affected_rows() > 0)));
     }
     catch (const std::exception &e) {
@@ -304,10 +372,10 @@ void Database::updateTournament(const std::string &webName, const std::string &n
 }
 
 void Database::asyncListTournaments(ListTournamentsCallback callback) {
-    boost::asio::dispatch(mStrand, std::bind(&Database::listTournaments, this, callback));
+    execute(std::bind(&Database::listTournaments, this, std::placeholders::_1, callback));
 }
 
-void Database::listTournaments(ListTournamentsCallback callback) {
+void Database::listTournaments(pqxx::connection &connection, ListTournamentsCallback callback) {
     auto current_time = boost::posix_time::second_clock::universal_time();
     std::string current_date = boost::gregorian::to_iso_extended_string(current_time.date());
 
@@ -315,13 +383,9 @@ void Database::listTournaments(ListTournamentsCallback callback) {
     std::vector<TournamentListing> pastTournaments;
 
     try {
-        pqxx::work work(mConnection);
-        pqxx::result upcomingResult = work.exec("select web_name, name, location, date FROM tournaments where date >= "
-                                + work.quote(current_date)
-                                + " order by date asc limit 20");
-        pqxx::result pastResult = work.exec("select web_name, name, location, date FROM tournaments where date < "
-                                + work.quote(current_date)
-                                + " order by date desc limit 20");
+        pqxx::work work(connection);
+        pqxx::result upcomingResult = work.exec_prepared("list_upcoming_tournaments", current_date);
+        pqxx::result pastResult = work.exec_prepared("list_past_tournaments", current_date);
         work.commit();
 
         for (int i = 0; i < upcomingResult.size(); ++i) {
@@ -350,6 +414,10 @@ void Database::listTournaments(ListTournamentsCallback callback) {
     }
 }
 
+uint64_t Database::getListingVersion() const {
+    return mListingVersion;
+}
+
 std::string Database::generateWebTokenExpiration() {
     auto time = boost::posix_time::second_clock::universal_time();
     return boost::posix_time::to_simple_string(time);
@@ -1,7 +1,14 @@
 #pragma once
 
-#include <boost/asio/io_context_strand.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <atomic>
 #include <chrono>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
 #include <pqxx/pqxx>
 
 #include "core/web/web_types.hpp"
@@ -17,7 +24,10 @@ struct TournamentListing {
 
 class Database {
 public:
-    Database(boost::asio::io_context &context, const std::string &config);
+    // Requests block on their own threads, one per connection of the pool, and
+    // callbacks are dispatched to the given context
+    Database(boost::asio::io_context &context, const std::string &config, size_t connectionCount);
+    ~Database();
 
     typedef std::function<void(UserRegistrationResponse, const std::optional<WebToken>&, std::optional<int>)> UserRegistrationCallback;
     void asyncRegisterUser(const std::string &email, const std::string &password, UserRegistrationCallback callback);
@@ -49,34 +59,52 @@ public:
     typedef std::function<void(bool, std::vector<TournamentListing>, std::vector<TournamentListing>)> ListTournamentsCallback;
     void asyncListTournaments(ListTournamentsCallback callback);
 
+    // Incremented whenever a change to the tournament listing has been committed
+    uint64_t getListingVersion() const;
+
 private:
-    void registerUser(const std::string &email, const std::string &password, UserRegistrationCallback callback);
+    typedef std::function<void (pqxx::connection &)> Request;
+    void execute(Request request);
+    void run(pqxx::connection &connection, const Request &request);
+    void prepareStatements(pqxx::connection &connection);
+
+    void registerUser(pqxx::connection &connection, const std::string &email, const std::string &password, UserRegistrationCallback callback);
 
-    void requestWebToken(const std::string &email, const std::string &password, WebTokenRequestCallback callback);
-    void validateWebToken(const std::string &email, const WebToken &token, WebTokenValidationCallback callback);
+    void requestWebToken(pqxx::connection &connection, const std::string &email, const std::string &password, WebTokenRequestCallback callback);
+    void validateWebToken(pqxx::connection &connection, const std::string &email, const WebToken &token, WebTokenValidationCallback callback);
 
-    void checkWebName(int userId, const TournamentId &id, const std::string &webName, WebNameCheckCallback callback);
-    void registerWebName(int userId, const TournamentId &id, const std::string &webName, WebNameRegistrationCallback callback);
+    void checkWebName(pqxx::connection &connection, int userId, const TournamentId &id, const std::string &webName, WebNameCheckCallback callback);
+    void registerWebName(pqxx::connection &connection, int userId, const TournamentId &id, const std::string &webName, WebNameRegistrationCallback callback);
 
-    void setSynced(const std::string &webName, SyncedSetCallback callback);
-    void setSaveTime(const std::string &webName, std::chrono::system_clock::time_point time, SaveTimeSetCallback callback);
+    void setSynced(pqxx::connection &connection, const std::string &webName, SyncedSetCallback callback);
+    void setSaveTime(pqxx::connection &connection, const std::string &webName, std::chrono::system_clock::time_point time, SaveTimeSetCallback callback);
 
-    void getSaveStatus(const std::string &webName, SaveStatusGetCallback callback);
+    void getSaveStatus(pqxx::connection &connection, const std::string &webName, SaveStatusGetCallback callback);
 
-    void updateTournament(const std::string &webName, const std::string &name, const std::string &location, const std::string &date, UpdateTournamentCallback callback);
+    void updateTournament(pqxx::connection &connection, const std::string &webName, const std::string &name, const std::string &location, const std::string &date, UpdateTournamentCallback callback);
 
-    void listTournaments(ListTournamentsCallback callback);
+    void listTournaments(pqxx::connection &connection, ListTournamentsCallback callback);
 
-    bool hasUser(const std::string &email);
-    bool checkPassword(const std::string &email, const std::string &password);
+    bool hasUser(pqxx::connection &connection, const std::string &email);
+    bool checkPassword(pqxx::connection &connection, const std::string &email, const std::string &password);
     WebToken generateWebToken();
 
     std::string generateWebTokenExpiration();
     bool validateWebTokenExpiration(const std::string &expiration);
 
 private:
+    typedef boost::asio::executor_work_guard<boost::asio::io_context::executor_type> WorkGuard;
+
     boost::asio::io_context &mContext;
-    boost::asio::io_context::strand mStrand;
-    pqxx::connection mConnection;
+    boost::asio::io_context mQueryContext;
+    std::optional<WorkGuard> mQueryWork; // Keeps the query threads running while idle
+    std::vector<std::thread> mQueryThreads;
+    std::vector<std::unique_ptr<pqxx::connection>> mConnections;
+
+    std::mutex mMutex;
+    std::vector<pqxx::connection *> mIdleConnections;
+    std::queue<Request> mPendingRequests; // Requests waiting for a connection
+
+    std::atomic<uint64_t> mListingVersion;
 };
 
@@ -1,4 +1,4 @@
-#include <rapidjson/writer.h>
+#include <set>
 
 #include "core/draw_systems/draw_system.hpp"
 #include "core/log.hpp"
@@ -7,6 +7,8 @@
 #include "core/stores/player_store.hpp"
 #include "web/database.hpp"
 #include "web/json_encoder.hpp"
+#include "web/message_pack_writer.hpp"
+#include "web/metrics.hpp"
 #include "web/web_tatami_model.hpp"
 #include "web/web_tournament_store.hpp"
 
@@ -22,70 +24,39 @@ rapidjson::StringBuffer& JsonBuffer::getStringBuffer() {
     return mStringBuffer;
 }
 
-std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentSubscriptionMessage(const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, std::optional<unsigned int> subscribedTatami, std::chrono::milliseconds clockDiff, bool shouldCache) {
-    rapidjson::Document document;
-    auto &allocator = document.GetAllocator();
+boost::asio::const_buffer JsonBuffer::getMessagePackBuffer() const {
+    std::call_once(mMessagePackFlag, [this]() {
+        mMessagePack = MessagePackWriter::transcode(mStringBuffer.GetString(), mStringBuffer.GetSize());
+    });
 
-    // See if values common to all participants are already cached
-    if (mCachedSubscriptionObject.has_value()) {
-        document.CopyFrom(*mCachedSubscriptionObject, allocator);
-    }
-    else {
-        document.SetObject();
-
-        document.AddMember("type", encodeString("tournamentSubscription", allocator), allocator);
-
-        // Tournament meta data field
-        document.AddMember("tournament", encodeMeta(tournament, allocator), allocator);
-
-        // categories field
-        rapidjson::Value categories(rapidjson::kArrayType);
-        for (const auto &p : tournament.getCategories())
-            categories.PushBack(encodeCategory(*(p.second), allocator), allocator);
-        document.AddMember("categories", categories, allocator);
-
-        // players field
-        rapidjson::Value players(rapidjson::kArrayType);
-        for (const auto &p : tournament.getPlayers())
-            players.PushBack(encodePlayer(*(p.second), allocator), allocator);
-        document.AddMember("players", players, allocator);
+    return boost::asio::buffer(mMessagePack.data(), mMessagePack.size());
+}
 
-        // Encode tatamis
-        rapidjson::Value tatamis(rapidjson::kArrayType);
-        auto tatamiCount = tournament.getTatamis().tatamiCount();
-        for (size_t i = 0; i < tatamiCount; ++i) {
-            const auto &model = tournament.getWebTatamiModel(i);
-            tatamis.PushBack(encodeTatami(i, model, allocator), allocator);
-        }
+template <typename WriteFunction>
+JsonEncoder::JsonFragment JsonEncoder::serializeFragment(rapidjson::Type type, WriteFunction writeFunction) {
+    mScratchBuffer.Clear();
+    JsonWriter writer(mScratchBuffer);
+    writeFunction(writer);
+    assert(writer.IsComplete());
 
-        document.AddMember("tatamis", tatamis, allocator);
+    return {type, std::string(mScratchBuffer.GetString(), mScratchBuffer.GetSize())};
+}
 
-        // Save to cache
-        if (shouldCache) {
-            mCachedSubscriptionObject = rapidjson::Document();
-            mCachedSubscriptionObject->CopyFrom(document, mCachedSubscriptionObject->GetAllocator());
-        }
+void JsonEncoder::writeMembers(JsonWriter &writer, const JsonMembers &members) {
+    for (const auto &member : members) {
+        writer.Key(member.first);
+        writeRaw(writer, member.second);
     }
+}
 
-    // subscribed category field
-    if (subscribedPlayer.has_value() && tournament.containsPlayer(*subscribedPlayer))
-        document.AddMember("subscribedPlayer", encodeSubscribedPlayer(tournament.getPlayer(*subscribedPlayer), allocator), allocator);
-    else
-        document.AddMember("subscribedPlayer", rapidjson::Value(), allocator);
-
-    // subscribed category field
-    if (subscribedCategory.has_value() && tournament.containsCategory(*subscribedCategory))
-        document.AddMember("subscribedCategory", encodeSubscribedCategory(tournament, tournament.getCategory(*subscribedCategory), allocator), allocator);
-    else
-        document.AddMember("subscribedCategory", rapidjson::Value(), allocator);
-
-    // subscribed tatami field
-    const auto &tatamis = tournament.getTatamis();
-    if (subscribedTatami.has_value() && *subscribedTatami < tatamis.tatamiCount())
-        document.AddMember("subscribedTatami", encodeSubscribedTatami(*subscribedTatami, tournament, allocator), allocator);
-    else
-        document.AddMember("subscribedTatami", rapidjson::Value(), allocator);
+void JsonEncoder::writeRaw(JsonWriter &writer, const JsonFragment &fragment) {
+    writer.RawValue(fragment.json.c_str(), fragment.json.size(), fragment.type);
+}
 
+std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentSubscriptionMessage(const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, std::optional<unsigned int> subscribedTatami, std::chrono::milliseconds clockDiff, bool shouldCache, bool lazy) {
+    MetricsTimer timer(metrics().encodeSubscriptionDuration);
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
 
     // Identify matches
     std::unordered_set<CombinedId> matchIds;
@@ -93,7 +64,7 @@ std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentSubscriptionMessage(con
     // Identity subscribed matches
     if (subscribedCategory.has_value() && tournament.containsCategory(*subscribedCategory)) {
         for (const auto &match : tournament.getCategory(*subscribedCategory).getMatches())
-            matchIds.insert(match->getCombinedId());
+            matchIds.insert(match.getCombinedId());
     }
     else if (subscribedPlayer.has_value() && tournament.containsPlayer(*subscribedPlayer)) {
         const auto &player = tournament.getPlayer(*subscribedPlayer);
@@ -111,290 +82,596 @@ std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentSubscriptionMessage(con
         }
     }
 
-    // Encode matches
-    rapidjson::Value matches(rapidjson::kArrayType);
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("tournamentSubscription");
+
+    if (lazy) {
+        // Only send the categories and players needed to display the matches.
+        // The remaining ones are requested page by page
+        writeLazySubscriptionMembers(writer, tournament, subscribedCategory, subscribedPlayer, matchIds);
+    }
+    else if (mCachedSubscriptionMembers.has_value()) {
+        // Values common to all participants are already cached
+        writeMembers(writer, *mCachedSubscriptionMembers);
+    }
+    else {
+        auto members = serializeSubscriptionMembers(tournament);
+        writeMembers(writer, members);
+
+        // Save to cache
+        if (shouldCache)
+            mCachedSubscriptionMembers = std::move(members);
+    }
+
+    // subscribed player field
+    writer.Key("subscribedPlayer");
+    if (subscribedPlayer.has_value() && tournament.containsPlayer(*subscribedPlayer))
+        writeSubscribedPlayer(writer, tournament.getPlayer(*subscribedPlayer));
+    else
+        writer.Null();
+
+    // subscribed category field
+    writer.Key("subscribedCategory");
+    if (subscribedCategory.has_value() && tournament.containsCategory(*subscribedCategory))
+        writeSubscribedCategory(writer, tournament, tournament.getCategory(*subscribedCategory));
+    else
+        writer.Null();
+
+    // subscribed tatami field
+    const auto &tatamis = tournament.getTatamis();
+    writer.Key("subscribedTatami");
+    if (subscribedTatami.has_value() && *subscribedTatami < tatamis.tatamiCount())
+        writeSubscribedTatami(writer, *subscribedTatami, tournament);
+    else
+        writer.Null();
+
+    writer.Key("matches");
+    writeMatches(writer, tournament, matchIds, clockDiff, shouldCache);
+
+    writer.EndObject();
+
+    return buffer;
+}
+
+void JsonEncoder::writeLazySubscriptionMembers(JsonWriter &writer, const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, const std::unordered_set<CombinedId> &matchIds) {
+    std::set<CategoryId> categoryIds;
+    std::set<PlayerId> playerIds;
+
     for (const auto &combinedId : matchIds) {
         const auto &category = tournament.getCategory(combinedId.getCategoryId());
         const auto &match = category.getMatch(combinedId.getMatchId());
-        matches.PushBack(encodeMatch(category, match, clockDiff, allocator, shouldCache), allocator);
+
+        categoryIds.insert(category.getId());
+        if (match.getWhitePlayer().has_value())
+            playerIds.insert(*match.getWhitePlayer());
+        if (match.getBluePlayer().has_value())
+            playerIds.insert(*match.getBluePlayer());
+    }
+
+    if (subscribedCategory.has_value() && tournament.containsCategory(*subscribedCategory)) {
+        const auto &category = tournament.getCategory(*subscribedCategory);
+        categoryIds.insert(category.getId());
+        playerIds.insert(category.getPlayers().begin(), category.getPlayers().end());
+    }
+
+    if (subscribedPlayer.has_value() && tournament.containsPlayer(*subscribedPlayer)) {
+        const auto &player = tournament.getPlayer(*subscribedPlayer);
+        playerIds.insert(player.getId());
+        categoryIds.insert(player.getCategories().begin(), player.getCategories().end());
+    }
+
+    writer.Key("lazy");
+    writer.Bool(true);
+
+    writer.Key("tournament");
+    writeMeta(writer, tournament);
+
+    writer.Key("categoryCount");
+    writer.Uint64(tournament.getCategories().size());
+
+    writer.Key("playerCount");
+    writer.Uint64(tournament.getPlayers().size());
+
+    writer.Key("categories");
+    writer.StartArray();
+    for (auto categoryId : categoryIds)
+        writeCategory(writer, tournament.getCategory(categoryId));
+    writer.EndArray();
+
+    writer.Key("players");
+    writer.StartArray();
+    for (auto playerId : playerIds)
+        writePlayer(writer, tournament.getPlayer(playerId));
+    writer.EndArray();
+
+    writer.Key("tatamis");
+    writer.StartArray();
+    auto tatamiCount = tournament.getTatamis().tatamiCount();
+    for (size_t i = 0; i < tatamiCount; ++i)
+        writeTatami(writer, i, tournament.getWebTatamiModel(i));
+    writer.EndArray();
+}
+
+std::unique_ptr<JsonBuffer> JsonEncoder::encodePlayerPageMessage(const WebTournamentStore &tournament, PlayerId from, size_t count) {
+    const auto &ids = tournament.getPlayerIds();
+    auto it = ids.lower_bound(from);
+
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
+
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("playerPage");
+
+    writer.Key("from");
+    writer.Uint(from.getValue());
+
+    writer.Key("players");
+    writer.StartArray();
+    for (size_t i = 0; i < count && it != ids.end(); ++i, ++it)
+        writePlayer(writer, tournament.getPlayer(*it));
+    writer.EndArray();
+
+    // First id of the next page, or null when this was the last one
+    writer.Key("next");
+    if (it != ids.end())
+        writer.Uint(it->getValue());
+    else
+        writer.Null();
+
+    writer.EndObject();
+
+    return buffer;
+}
+
+std::unique_ptr<JsonBuffer> JsonEncoder::encodeCategoryPageMessage(const WebTournamentStore &tournament, CategoryId from, size_t count) {
+    const auto &ids = tournament.getCategoryIds();
+    auto it = ids.lower_bound(from);
+
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
+
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("categoryPage");
+
+    writer.Key("from");
+    writer.Uint(from.getValue());
+
+    writer.Key("categories");
+    writer.StartArray();
+    for (size_t i = 0; i < count && it != ids.end(); ++i, ++it)
+        writeCategory(writer, tournament.getCategory(*it));
+    writer.EndArray();
+
+    // First id of the next page, or null when this was the last one
+    writer.Key("next");
+    if (it != ids.end())
+        writer.Uint(it->getValue());
+    else
+        writer.Null();
+
+    writer.EndObject();
+
+    return buffer;
+}
+
+std::unique_ptr<JsonBuffer> JsonEncoder::encodePlayersMessage(const WebTournamentStore &tournament, const std::vector<PlayerId> &playerIds) {
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
+
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("players");
+
+    writer.Key("players");
+    writer.StartArray();
+    for (auto playerId : playerIds) {
+        if (tournament.containsPlayer(playerId))
+            writePlayer(writer, tournament.getPlayer(playerId));
+    }
+    writer.EndArray();
+
+    // Unknown ids are reported back so the client can stop asking for them
+    writer.Key("missing");
+    writer.StartArray();
+    for (auto playerId : playerIds) {
+        if (!tournament.containsPlayer(playerId))
+            writer.Uint(playerId.getValue());
     }
+    writer.EndArray();
 
-    document.AddMember("matches", matches, allocator);
+    writer.EndObject();
 
+    return buffer;
+}
+
+std::unique_ptr<JsonBuffer> JsonEncoder::encodeCategoriesMessage(const WebTournamentStore &tournament, const std::vector<CategoryId> &categoryIds) {
     auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    JsonWriter writer(buffer->getStringBuffer());
+
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("categories");
+
+    writer.Key("categories");
+    writer.StartArray();
+    for (auto categoryId : categoryIds) {
+        if (tournament.containsCategory(categoryId))
+            writeCategory(writer, tournament.getCategory(categoryId));
+    }
+    writer.EndArray();
+
+    // Unknown ids are reported back so the client can stop asking for them
+    writer.Key("missing");
+    writer.StartArray();
+    for (auto categoryId : categoryIds) {
+        if (!tournament.containsCategory(categoryId))
+            writer.Uint(categoryId.getValue());
+    }
+    writer.EndArray();
+
+    writer.EndObject();
 
     return buffer;
 }
 
+JsonEncoder::JsonMembers JsonEncoder::serializeSubscriptionMembers(const WebTournamentStore &tournament) {
+    JsonMembers members;
+
+    // Tournament meta data field
+    members.emplace_back("tournament", serializeFragment(rapidjson::kObjectType, [&](JsonWriter &writer) {
+        writeMeta(writer, tournament);
+    }));
+
+    // categories field
+    members.emplace_back("categories", serializeFragment(rapidjson::kArrayType, [&](JsonWriter &writer) {
+        writer.StartArray();
+        for (const auto &p : tournament.getCategories())
+            writeCategory(writer, *(p.second));
+        writer.EndArray();
+    }));
+
+    // players field
+    members.emplace_back("players", serializeFragment(rapidjson::kArrayType, [&](JsonWriter &writer) {
+        writer.StartArray();
+        for (const auto &p : tournament.getPlayers())
+            writePlayer(writer, *(p.second));
+        writer.EndArray();
+    }));
+
+    // tatamis field
+    members.emplace_back("tatamis", serializeFragment(rapidjson::kArrayType, [&](JsonWriter &writer) {
+        writer.StartArray();
+        auto tatamiCount = tournament.getTatamis().tatamiCount();
+        for (size_t i = 0; i < tatamiCount; ++i)
+            writeTatami(writer, i, tournament.getWebTatamiModel(i));
+        writer.EndArray();
+    }));
+
+    return members;
+}
+
 std::unique_ptr<JsonBuffer> JsonEncoder::encodeCategorySubscriptionMessage(const WebTournamentStore &tournament, const CategoryStore &category, std::chrono::milliseconds clockDiff) {
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
 
-    document.AddMember("type", encodeString("categorySubscription", allocator), allocator);
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("categorySubscription");
 
     // subscribed category field
-    document.AddMember("subscribedCategory", encodeSubscribedCategory(tournament, category, allocator), allocator);
+    writer.Key("subscribedCategory");
+    writeSubscribedCategory(writer, tournament, category);
 
     // matches
-    rapidjson::Value matches(rapidjson::kArrayType);
+    writer.Key("matches");
+    writer.StartArray();
     for (const auto &match : category.getMatches())
-        matches.PushBack(encodeMatch(category, *match, clockDiff, allocator, false), allocator);
-    document.AddMember("matches", matches, allocator);
+        writeMatch(writer, category, match, clockDiff, false);
+    writer.EndArray();
 
-    auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    writer.EndObject();
 
     return buffer;
 }
 
 std::unique_ptr<JsonBuffer> JsonEncoder::encodePlayerSubscriptionMessage(const WebTournamentStore &tournament, const PlayerStore &player, std::chrono::milliseconds clockDiff) {
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
 
-    document.AddMember("type", encodeString("playerSubscription", allocator), allocator);
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("playerSubscription");
 
-    // subscribed category field
-    document.AddMember("subscribedPlayer", encodeSubscribedPlayer(player, allocator), allocator);
+    // subscribed player field
+    writer.Key("subscribedPlayer");
+    writeSubscribedPlayer(writer, player);
 
     // matches
-    rapidjson::Value matches(rapidjson::kArrayType);
+    writer.Key("matches");
+    writer.StartArray();
     for (auto combinedId : player.getMatches()) {
         const auto &category = tournament.getCategory(combinedId.getCategoryId());
         const auto &match = category.getMatch(combinedId.getMatchId());
-        matches.PushBack(encodeMatch(category, match, clockDiff, allocator, false), allocator);
+        writeMatch(writer, category, match, clockDiff, false);
     }
-    document.AddMember("matches", matches, allocator);
+    writer.EndArray();
 
-    auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    writer.EndObject();
 
     return buffer;
 }
 
-std::unique_ptr<JsonBuffer> JsonEncoder::encodeTatamiSubscriptionMessage(const WebTournamentStore &tournament, size_t index, std::chrono::milliseconds clockDiff) {
-    assert(index < tournament.getTatamis().tatamiCount());
+std::unique_ptr<JsonBuffer> JsonEncoder::encodeSubscriptionsMessage(const WebTournamentStore &tournament, const SubscriptionSet &subscriptions, std::chrono::milliseconds clockDiff) {
+    MetricsTimer timer(metrics().encodeSubscriptionDuration);
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
 
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("subscriptions");
 
-    document.AddMember("type", encodeString("tatamiSubscription", allocator), allocator);
+    std::unordered_set<CombinedId> matchIds;
+    std::vector<unsigned int> failedCategories;
+    std::vector<unsigned int> failedPlayers;
+    std::vector<unsigned int> failedTatamis;
+
+    writer.Key("subscribedCategories");
+    writer.StartArray();
+    for (auto categoryId : subscriptions.categories) {
+        if (!tournament.containsCategory(categoryId)) {
+            failedCategories.push_back(categoryId.getValue());
+            continue;
+        }
 
-    // subscribed category field
-    document.AddMember("subscribedTatami", encodeSubscribedTatami(index, tournament, allocator), allocator);
+        const auto &category = tournament.getCategory(categoryId);
+        writeSubscribedCategory(writer, tournament, category);
+        for (const auto &match : category.getMatches())
+            matchIds.insert(match.getCombinedId());
+    }
+    writer.EndArray();
+
+    writer.Key("subscribedPlayers");
+    writer.StartArray();
+    for (auto playerId : subscriptions.players) {
+        if (!tournament.containsPlayer(playerId)) {
+            failedPlayers.push_back(playerId.getValue());
+            continue;
+        }
 
-    auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+        const auto &player = tournament.getPlayer(playerId);
+        writeSubscribedPlayer(writer, player);
+        matchIds.insert(player.getMatches().begin(), player.getMatches().end());
+    }
+    writer.EndArray();
+
+    writer.Key("subscribedTatamis");
+    writer.StartArray();
+    for (auto index : subscriptions.tatamis) {
+        if (index >= tournament.getTatamis().tatamiCount()) {
+            failedTatamis.push_back(index);
+            continue;
+        }
+
+        writeSubscribedTatami(writer, index, tournament);
+    }
+    writer.EndArray();
+
+    writer.Key("failedCategories");
+    writer.StartArray();
+    for (auto id : failedCategories)
+        writer.Uint(id);
+    writer.EndArray();
+
+    writer.Key("failedPlayers");
+    writer.StartArray();
+    for (auto id : failedPlayers)
+        writer.Uint(id);
+    writer.EndArray();
+
+    writer.Key("failedTatamis");
+    writer.StartArray();
+    for (auto index : failedTatamis)
+        writer.Uint(index);
+    writer.EndArray();
+
+    // Matches shared between the subscriptions are only sent once
+    writer.Key("matches");
+    writeMatches(writer, tournament, matchIds, clockDiff, false);
+
+    writer.EndObject();
 
     return buffer;
 }
 
-bool JsonEncoder::hasTournamentChanges(const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, std::optional<unsigned int> subscribedTatami) {
-    // check tournament
-    if (tournament.tournamentChanged())
-        return true;
+std::unique_ptr<JsonBuffer> JsonEncoder::encodeTatamiSubscriptionMessage(const WebTournamentStore &tournament, size_t index, std::chrono::milliseconds clockDiff) {
+    assert(index < tournament.getTatamis().tatamiCount());
 
-    for (const auto &tatamiModel : tournament.getWebTatamiModels()) {
-        if (tatamiModel.matchesChanged())
-            return true;
-    }
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
 
-    // check players
-    if (!tournament.getChangedPlayers().empty())
-        return true;
-    if (!tournament.getAddedPlayers().empty())
-        return true;
-    if (!tournament.getErasedPlayers().empty())
-        return true;
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("tatamiSubscription");
 
-    // check categories
-    if (!tournament.getChangedCategories().empty())
-        return true;
-    if (!tournament.getAddedCategories().empty())
-        return true;
-    if (!tournament.getErasedCategories().empty())
-        return true;
+    // subscribed tatami field
+    writer.Key("subscribedTatami");
+    writeSubscribedTatami(writer, index, tournament);
 
-    // check subscribed matches
-    if (subscribedCategory.has_value() && tournament.containsCategory(*subscribedCategory)) {
-        if (tournament.getCategoryMatchResets().find(*subscribedCategory) != tournament.getCategoryMatchResets().end())
-            return true;
-        if (tournament.getCategoryResultsResets().find(*subscribedCategory) != tournament.getCategoryResultsResets().end())
-            return true;
-
-        for (const auto &match : tournament.getCategory(*subscribedCategory).getMatches()) {
-            const auto &combinedId = match->getCombinedId();
-            if (tournament.getChangedMatches().find(combinedId) != tournament.getChangedMatches().end())
-                return true;
-        }
-    }
-    else if (subscribedPlayer.has_value() && tournament.containsPlayer(*subscribedPlayer)) {
-        if (tournament.getPlayerMatchResets().find(*subscribedPlayer) != tournament.getPlayerMatchResets().end())
-            return true;
+    writer.EndObject();
 
-        const auto &player = tournament.getPlayer(*subscribedPlayer);
-        for (const auto &combinedId : player.getMatches()) {
-            if (tournament.getChangedMatches().find(combinedId) != tournament.getChangedMatches().end())
-                return true;
-        }
-    }
-    else if (subscribedTatami.has_value() && *subscribedTatami < tournament.getTatamis().tatamiCount()) {
-        if (tournament.getWebTatamiModel(*subscribedTatami).changed())
-            return true;
-    }
+    return buffer;
+}
 
-    // check tatami matches
-    auto tatamiCount = tournament.getTatamis().tatamiCount();
-    for (size_t i = 0; i < tatamiCount; ++i) {
-        const auto &model = tournament.getWebTatamiModel(i);
-        if (!model.getInsertedMatches().empty())
-            return true;
-        for (auto combinedId : model.getMatches()) {
-            if (tournament.getChangedMatches().find(combinedId) != tournament.getChangedMatches().end())
-                return true;
-        }
+TournamentChangeDigest JsonEncoder::digestTournamentChanges(const WebTournamentStore &tournament) {
+    TournamentChangeDigest digest;
+
+    // check tournament, players and categories
+    digest.general = tournament.tournamentChanged()
+        || !tournament.getChangedPlayers().empty()
+        || !tournament.getAddedPlayers().empty()
+        || !tournament.getErasedPlayers().empty()
+        || !tournament.getChangedCategories().empty()
+        || !tournament.getAddedCategories().empty()
+        || !tournament.getErasedCategories().empty();
+
+    // check tatamis
+    for (size_t index : tournament.getChangedTatamis()) {
+        const auto &model = tournament.getWebTatamiModel(index);
+        if (model.matchesChanged() || !model.getChangedMatches().empty())
+            digest.general = true;
+        if (model.changed())
+            digest.tatamis.insert(index);
     }
 
-    return false;
-}
+    // Subscriptions to the categories and players of changed matches
+    for (const auto &combinedId : tournament.getChangedMatches()) {
+        if (!tournament.containsCategory(combinedId.getCategoryId()))
+            continue;
 
-std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentChangesMessage(const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, std::optional<unsigned int> subscribedTatami, std::chrono::milliseconds clockDiff) {
-    rapidjson::Document document;
-    auto &allocator = document.GetAllocator();
+        digest.categories.insert(combinedId.getCategoryId());
 
-    if (mCachedChangesObject.has_value()) {
-        document.CopyFrom(*mCachedChangesObject, allocator);
+        const auto &category = tournament.getCategory(combinedId.getCategoryId());
+        if (!category.containsMatch(combinedId.getMatchId()))
+            continue;
+
+        const auto &match = category.getMatch(combinedId.getMatchId());
+        if (match.getWhitePlayer())
+            digest.players.insert(*match.getWhitePlayer());
+        if (match.getBluePlayer())
+            digest.players.insert(*match.getBluePlayer());
     }
-    else {
-        document.SetObject();
-        document.AddMember("type", encodeString("tournamentChanges", allocator), allocator);
-
-        // Tournament meta data field
-        if (tournament.tournamentChanged())
-            document.AddMember("tournament", encodeMeta(tournament, allocator), allocator);
-
-        // categories field
-        rapidjson::Value categories(rapidjson::kArrayType);
-        for (auto categoryId : tournament.getChangedCategories()) {
-            const auto &category = tournament.getCategory(categoryId);
-            categories.PushBack(encodeCategory(category, allocator), allocator);
-        }
 
-        for (auto categoryId : tournament.getAddedCategories()) {
-            const auto &category = tournament.getCategory(categoryId);
-            categories.PushBack(encodeCategory(category, allocator), allocator);
-        }
-        document.AddMember("categories", categories, allocator);
+    digest.categories.insert(tournament.getCategoryMatchResets().begin(), tournament.getCategoryMatchResets().end());
+    digest.categories.insert(tournament.getCategoryResultsResets().begin(), tournament.getCategoryResultsResets().end());
+    digest.players.insert(tournament.getPlayerMatchResets().begin(), tournament.getPlayerMatchResets().end());
 
-        // erased categories field
-        rapidjson::Value erasedCategories(rapidjson::kArrayType);
-        for (auto categoryId : tournament.getErasedCategories()) {
-            rapidjson::Value val(categoryId.getValue());
+    return digest;
+}
 
-            erasedCategories.PushBack(val, allocator);
-        }
-        document.AddMember("erasedCategories", erasedCategories, allocator);
+std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentChangesMessage(const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, std::optional<unsigned int> subscribedTatami, std::chrono::milliseconds clockDiff) {
+    SubscriptionSet subscriptions;
+    if (subscribedCategory.has_value())
+        subscriptions.categories.insert(*subscribedCategory);
+    else if (subscribedPlayer.has_value())
+        subscriptions.players.insert(*subscribedPlayer);
+    else if (subscribedTatami.has_value())
+        subscriptions.tatamis.insert(*subscribedTatami);
+
+    return encodeChangesMessage(tournament, subscriptions, false, clockDiff);
+}
 
-        // players field
-        rapidjson::Value players(rapidjson::kArrayType);
-        for (auto playerId : tournament.getChangedPlayers()) {
-            const auto &player = tournament.getPlayer(playerId);
-            players.PushBack(encodePlayer(player, allocator), allocator);
-        }
+std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentChangesMessage(const WebTournamentStore &tournament, const SubscriptionSet &subscriptions, std::chrono::milliseconds clockDiff) {
+    return encodeChangesMessage(tournament, subscriptions, true, clockDiff);
+}
 
-        for (auto playerId : tournament.getAddedPlayers()) {
-            const auto &player = tournament.getPlayer(playerId);
-            players.PushBack(encodePlayer(player, allocator), allocator);
+std::unique_ptr<JsonBuffer> JsonEncoder::encodeChangesMessage(const WebTournamentStore &tournament, const SubscriptionSet &subscriptions, bool multiple, std::chrono::milliseconds clockDiff) {
+    MetricsTimer timer(metrics().encodeChangesDuration);
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
+
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("tournamentChanges");
+
+    if (!mCachedChangesMembers.has_value())
+        mCachedChangesMembers = serializeChangesMembers(tournament);
+    writeMembers(writer, *mCachedChangesMembers);
+
+    // Encode subscribed categories, players and tatamis. A single subscription
+    // has its own field, which is null once erased. Multiple subscriptions are
+    // listed in arrays holding the changed ones. Erased ones are found through
+    // the erased categories and players
+    if (multiple) {
+        writer.Key("subscribedCategories");
+        writer.StartArray();
+    }
+    for (auto categoryId : subscriptions.categories) {
+        if (tournament.getErasedCategories().find(categoryId) != tournament.getErasedCategories().end()) {
+            if (!multiple) {
+                writer.Key("subscribedCategory");
+                writer.Null();
+            }
+            continue;
         }
-        document.AddMember("players", players, allocator);
 
-        // erased players field
-        rapidjson::Value erasedPlayers(rapidjson::kArrayType);
-        for (auto playerId : tournament.getErasedPlayers()) {
-            rapidjson::Value val(playerId.getValue());
+        bool shouldEncode = false;
 
-            erasedPlayers.PushBack(val, allocator);
+        shouldEncode |= (tournament.getChangedCategories().find(categoryId) != tournament.getChangedCategories().end());
+        shouldEncode |= (tournament.getAddedCategories().find(categoryId) != tournament.getAddedCategories().end());
+        shouldEncode |= (tournament.getCategoryMatchResets().find(categoryId) != tournament.getCategoryMatchResets().end());
+        shouldEncode |= (tournament.getCategoryResultsResets().find(categoryId) != tournament.getCategoryResultsResets().end());
+        if (shouldEncode) {
+            if (!multiple)
+                writer.Key("subscribedCategory");
+            writeSubscribedCategory(writer, tournament, tournament.getCategory(categoryId));
         }
-        document.AddMember("erasedPlayers", erasedPlayers, allocator);
-
-        // Encode tatamis
-        rapidjson::Value tatamis(rapidjson::kArrayType);
-        auto tatamiCount = tournament.getTatamis().tatamiCount();
-        for (size_t i = 0; i < tatamiCount; ++i) {
-            const auto &model = tournament.getWebTatamiModel(i);
-
-            if (model.matchesChanged())
-                tatamis.PushBack(encodeTatami(i, model, allocator), allocator);
+    }
+    if (multiple) {
+        writer.EndArray();
+        writer.Key("subscribedPlayers");
+        writer.StartArray();
+    }
+    for (auto playerId : subscriptions.players) {
+        if (tournament.getErasedPlayers().find(playerId) != tournament.getErasedPlayers().end()) {
+            if (!multiple) {
+                writer.Key("subscribedPlayer");
+                writer.Null();
+            }
+            continue;
         }
 
-        document.AddMember("tatamis", tatamis, allocator);
-
-        // save object to cache
-        mCachedChangesObject = rapidjson::Document();
-        mCachedChangesObject->CopyFrom(document, mCachedChangesObject->GetAllocator());
-    }
+        bool shouldEncode = false;
 
-    // Encode subscribed category or player
-    if (subscribedCategory.has_value()) { // encode subscribed category
-        if (tournament.getErasedCategories().find(*subscribedCategory) != tournament.getErasedCategories().end()) {
-            document.AddMember("subscribedCategory", rapidjson::Value(), allocator);
-        }
-        else {
-            bool shouldEncode = false;
-
-            shouldEncode |= (tournament.getChangedCategories().find(*subscribedCategory) != tournament.getChangedCategories().end());
-            shouldEncode |= (tournament.getAddedCategories().find(*subscribedCategory) != tournament.getAddedCategories().end());
-            shouldEncode |= (tournament.getCategoryMatchResets().find(*subscribedCategory) != tournament.getCategoryMatchResets().end());
-            shouldEncode |= (tournament.getCategoryResultsResets().find(*subscribedCategory) != tournament.getCategoryResultsResets().end());
-            if (shouldEncode)
-                document.AddMember("subscribedCategory", encodeSubscribedCategory(tournament, tournament.getCategory(*subscribedCategory), allocator), allocator);
+        shouldEncode |= (tournament.getChangedPlayers().find(playerId) != tournament.getChangedPlayers().end());
+        shouldEncode |= (tournament.getAddedPlayers().find(playerId) != tournament.getAddedPlayers().end());
+        shouldEncode |= (tournament.getPlayerMatchResets().find(playerId) != tournament.getPlayerMatchResets().end());
+        if (shouldEncode) {
+            if (!multiple)
+                writer.Key("subscribedPlayer");
+            writeSubscribedPlayer(writer, tournament.getPlayer(playerId));
         }
     }
-    else if (subscribedPlayer.has_value()) { // encode subscribed player
-        if (tournament.getErasedPlayers().find(*subscribedPlayer) != tournament.getErasedPlayers().end()) {
-            document.AddMember("subscribedPlayer", rapidjson::Value(), allocator);
-        }
-        else {
-            bool shouldEncode = false;
-
-            shouldEncode |= (tournament.getChangedPlayers().find(*subscribedPlayer) != tournament.getChangedPlayers().end());
-            shouldEncode |= (tournament.getAddedPlayers().find(*subscribedPlayer) != tournament.getAddedPlayers().end());
-            shouldEncode |= (tournament.getPlayerMatchResets().find(*subscribedPlayer) != tournament.getPlayerMatchResets().end());
-            if (shouldEncode)
-                document.AddMember("subscribedPlayer", encodeSubscribedPlayer(tournament.getPlayer(*subscribedPlayer), allocator), allocator);
-        }
+    if (multiple) {
+        writer.EndArray();
+        writer.Key("subscribedTatamis");
+        writer.StartArray();
     }
-    else if (subscribedTatami.has_value()) {
-        const auto &tatamis = tournament.getTatamis();
-        if  (*subscribedTatami < tatamis.tatamiCount()) {
-            if (tournament.getWebTatamiModel(*subscribedTatami).changed())
-                document.AddMember("subscribedTatami", encodeSubscribedTatami(*subscribedTatami, tournament, allocator), allocator);
+    for (auto index : subscriptions.tatamis) {
+        if (index < tournament.getTatamis().tatamiCount() && tournament.getWebTatamiModel(index).changed()) {
+            if (!multiple)
+                writer.Key("subscribedTatami");
+            writeSubscribedTatami(writer, index, tournament);
         }
     }
+    if (multiple)
+        writer.EndArray();
 
     // Identify changed matches
     std::unordered_set<CombinedId> matchIds;
 
     // Identify changed subscribed matches
-    if (subscribedCategory.has_value() && tournament.containsCategory(*subscribedCategory)) {
-        bool matchesReset = (tournament.getCategoryMatchResets().find(*subscribedCategory) != tournament.getCategoryMatchResets().end());
-        for (const auto &match : tournament.getCategory(*subscribedCategory).getMatches()) {
-            const auto &combinedId = match->getCombinedId();
+    for (auto categoryId : subscriptions.categories) {
+        if (!tournament.containsCategory(categoryId))
+            continue;
+
+        bool matchesReset = (tournament.getCategoryMatchResets().find(categoryId) != tournament.getCategoryMatchResets().end());
+        for (const auto &match : tournament.getCategory(categoryId).getMatches()) {
+            const auto &combinedId = match.getCombinedId();
             if (!matchesReset && tournament.getChangedMatches().find(combinedId) == tournament.getChangedMatches().end())
                 continue;
             matchIds.insert(combinedId);
         }
     }
-    else if (subscribedPlayer.has_value() && tournament.containsPlayer(*subscribedPlayer)) {
-        const auto &player = tournament.getPlayer(*subscribedPlayer);
-        bool matchesReset = (tournament.getPlayerMatchResets().find(*subscribedPlayer) != tournament.getPlayerMatchResets().end());
+
+    for (auto playerId : subscriptions.players) {
+        if (!tournament.containsPlayer(playerId))
+            continue;
+
+        const auto &player = tournament.getPlayer(playerId);
+        bool matchesReset = (tournament.getPlayerMatchResets().find(playerId) != tournament.getPlayerMatchResets().end());
 
         for (const auto &combinedId : player.getMatches()) {
             if (!matchesReset && tournament.getChangedMatches().find(combinedId) == tournament.getChangedMatches().end())
@@ -404,515 +681,590 @@ std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentChangesMessage(const We
     }
 
     // Identify changed tatami matches
-    auto tatamiCount = tournament.getTatamis().tatamiCount();
-    for (size_t i = 0; i < tatamiCount; ++i) {
-        const auto &model = tournament.getWebTatamiModel(i);
+    for (size_t index : tournament.getChangedTatamis()) {
+        const auto &model = tournament.getWebTatamiModel(index);
 
         // Add all inserted matches
         for (const auto &combinedId : model.getInsertedMatches())
             matchIds.insert(combinedId);
 
         // Add changed matches that were already present
-        for (const auto &combinedId: model.getMatches()) {
-            if (tournament.getChangedMatches().find(combinedId) != tournament.getChangedMatches().end())
-                matchIds.insert(combinedId);
-        }
+        for (const auto &combinedId : model.getChangedMatches())
+            matchIds.insert(combinedId);
     }
 
-    // Encode matches
-    rapidjson::Value matches(rapidjson::kArrayType);
-    for (const auto &combinedId : matchIds) {
-        const auto &category = tournament.getCategory(combinedId.getCategoryId());
-        const auto &match = category.getMatch(combinedId.getMatchId());
-        matches.PushBack(encodeMatch(category, match, clockDiff, allocator, true), allocator);
-    }
-    document.AddMember("matches", matches, allocator);
+    writer.Key("matches");
+    writeMatches(writer, tournament, matchIds, clockDiff, true);
 
-    auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    writer.EndObject();
 
     return buffer;
 }
 
-rapidjson::Value JsonEncoder::encodePlayer(const PlayerStore &player, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res;
-    res.SetObject();
+JsonEncoder::JsonMembers JsonEncoder::serializeChangesMembers(const WebTournamentStore &tournament) {
+    JsonMembers members;
+
+    // Tournament meta data field
+    if (tournament.tournamentChanged()) {
+        members.emplace_back("tournament", serializeFragment(rapidjson::kObjectType, [&](JsonWriter &writer) {
+            writeMeta(writer, tournament);
+        }));
+    }
 
-    res.AddMember("id", player.getId().getValue(), allocator);
-    res.AddMember("firstName", encodeString(player.getFirstName(), allocator), allocator);
-    res.AddMember("lastName", encodeString(player.getLastName(), allocator), allocator);
+    // categories field
+    members.emplace_back("categories", serializeFragment(rapidjson::kArrayType, [&](JsonWriter &writer) {
+        writer.StartArray();
+        for (auto categoryId : tournament.getChangedCategories())
+            writeCategory(writer, tournament.getCategory(categoryId));
+        for (auto categoryId : tournament.getAddedCategories())
+            writeCategory(writer, tournament.getCategory(categoryId));
+        writer.EndArray();
+    }));
+
+    // erased categories field
+    members.emplace_back("erasedCategories", serializeFragment(rapidjson::kArrayType, [&](JsonWriter &writer) {
+        writer.StartArray();
+        for (auto categoryId : tournament.getErasedCategories())
+            writer.Uint(categoryId.getValue());
+        writer.EndArray();
+    }));
+
+    // players field
+    members.emplace_back("players", serializeFragment(rapidjson::kArrayType, [&](JsonWriter &writer) {
+        writer.StartArray();
+        for (auto playerId : tournament.getChangedPlayers())
+            writePlayer(writer, tournament.getPlayer(playerId));
+        for (auto playerId : tournament.getAddedPlayers())
+            writePlayer(writer, tournament.getPlayer(playerId));
+        writer.EndArray();
+    }));
+
+    // erased players field
+    members.emplace_back("erasedPlayers", serializeFragment(rapidjson::kArrayType, [&](JsonWriter &writer) {
+        writer.StartArray();
+        for (auto playerId : tournament.getErasedPlayers())
+            writer.Uint(playerId.getValue());
+        writer.EndArray();
+    }));
+
+    // tatamis field
+    members.emplace_back("tatamis", serializeFragment(rapidjson::kArrayType, [&](JsonWriter &writer) {
+        writer.StartArray();
+        for (size_t index : tournament.getChangedTatamis()) {
+            const auto &model = tournament.getWebTatamiModel(index);
 
+            if (model.matchesChanged())
+                writeTatami(writer, index, model);
+        }
+        writer.EndArray();
+    }));
+
+    return members;
+}
+
+void JsonEncoder::writePlayerFields(JsonWriter &writer, const PlayerStore &player) {
+    writer.Key("id");
+    writer.Uint(player.getId().getValue());
+    writer.Key("firstName");
+    writeString(writer, player.getFirstName());
+    writer.Key("lastName");
+    writeString(writer, player.getLastName());
+
+    writer.Key("country");
     if (player.getCountry().has_value())
-        res.AddMember("country", encodeString(player.getCountry()->toString(), allocator), allocator);
+        writeString(writer, player.getCountry()->toString());
     else
-        res.AddMember("country", rapidjson::Value(), allocator);
+        writer.Null();
 
+    writer.Key("rank");
     if (player.getRank().has_value())
-        res.AddMember("rank", encodeString(player.getRank()->toString(), allocator), allocator);
+        writeString(writer, player.getRank()->toString());
     else
-        res.AddMember("rank", rapidjson::Value(), allocator);
+        writer.Null();
 
+    // writer.Key("sex");
     // if (player.getSex().has_value())
-    //     res.AddMember("sex", encodeString(player.getSex()->toString(), allocator), allocator);
+    //     writeString(writer, player.getSex()->toString());
     // else
-    //     res.AddMember("sex", rapidjson::Value(), allocator);
+    //     writer.Null();
 
-    res.AddMember("club", encodeString(player.getClub(), allocator), allocator);
+    writer.Key("club");
+    writeString(writer, player.getClub());
+}
 
-    return res;
+void JsonEncoder::writePlayer(JsonWriter &writer, const PlayerStore &player) {
+    writer.StartObject();
+    writePlayerFields(writer, player);
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeSubscribedPlayer(const PlayerStore &player, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res = encodePlayer(player, allocator);
+void JsonEncoder::writeSubscribedPlayer(JsonWriter &writer, const PlayerStore &player) {
+    writer.StartObject();
+    writePlayerFields(writer, player);
 
-    rapidjson::Value categories(rapidjson::kArrayType);
+    writer.Key("categories");
+    writer.StartArray();
     for (const auto &categoryId : player.getCategories())
-        categories.PushBack(categoryId.getValue(), allocator);
-    res.AddMember("categories", categories, allocator);
+        writer.Uint(categoryId.getValue());
+    writer.EndArray();
 
-    rapidjson::Value matches(rapidjson::kArrayType);
+    writer.Key("matches");
+    writer.StartArray();
     for (const auto &combinedId : player.getMatches())
-        matches.PushBack(encodeCombinedId(combinedId, allocator), allocator);
-
-    res.AddMember("matches", matches, allocator);
+        writeCombinedId(writer, combinedId);
+    writer.EndArray();
 
-    return res;
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeCategory(const CategoryStore &category, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res;
-    res.SetObject();
-
-    res.AddMember("id", category.getId().getValue(), allocator);
-    res.AddMember("name", encodeString(category.getName(), allocator), allocator);
-    res.AddMember("matchesHidden", category.areMatchesHidden(), allocator);
+void JsonEncoder::writeCategoryFields(JsonWriter &writer, const CategoryStore &category) {
+    writer.Key("id");
+    writer.Uint(category.getId().getValue());
+    writer.Key("name");
+    writeString(writer, category.getName());
+    writer.Key("matchesHidden");
+    writer.Bool(category.areMatchesHidden());
+}
 
-    return res;
+void JsonEncoder::writeCategory(JsonWriter &writer, const CategoryStore &category) {
+    writer.StartObject();
+    writeCategoryFields(writer, category);
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeSubscribedCategory(const TournamentStore &tournament, const CategoryStore &category, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res = encodeCategory(category, allocator);
+void JsonEncoder::writeSubscribedCategory(JsonWriter &writer, const TournamentStore &tournament, const CategoryStore &category) {
+    writer.StartObject();
+    writeCategoryFields(writer, category);
 
     // Encode matches
-    rapidjson::Value matches(rapidjson::kArrayType);
+    writer.Key("matches");
+    writer.StartArray();
     for (const auto &match : category.getMatches())
-        matches.PushBack(encodeCombinedId(match->getCombinedId(), allocator), allocator);
-
-    res.AddMember("matches", matches, allocator);
+        writeCombinedId(writer, match.getCombinedId());
+    writer.EndArray();
 
     // Encode players
-    rapidjson::Value players(rapidjson::kArrayType);
-    for (auto &playerId : category.getPlayers()) {
-        rapidjson::Value val(playerId.getValue());
-        players.PushBack(val, allocator);
-    }
+    writer.Key("players");
+    writer.StartArray();
+    for (auto &playerId : category.getPlayers())
+        writer.Uint(playerId.getValue());
+    writer.EndArray();
 
-    res.AddMember("players", players, allocator);
-    res.AddMember("results", encodeCategoryResults(tournament, category, allocator), allocator);
+    writer.Key("results");
+    writeCategoryResults(writer, tournament, category);
 
-    return res;
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeMatch(const CategoryStore &category, const MatchStore &match, std::chrono::milliseconds clockDiff, rapidjson::Document::AllocatorType &allocator, bool shouldCache) {
+void JsonEncoder::writeMatches(JsonWriter &writer, const WebTournamentStore &tournament, const std::unordered_set<CombinedId> &matchIds, std::chrono::milliseconds clockDiff, bool shouldCache) {
+    writer.StartArray();
+    for (const auto &combinedId : matchIds) {
+        const auto &category = tournament.getCategory(combinedId.getCategoryId());
+        const auto &match = category.getMatch(combinedId.getMatchId());
+        writeMatch(writer, category, match, clockDiff, shouldCache);
+    }
+    writer.EndArray();
+}
+
+void JsonEncoder::writeMatch(JsonWriter &writer, const CategoryStore &category, const MatchStore &match, std::chrono::milliseconds clockDiff, bool shouldCache) {
     auto combinedId = match.getCombinedId();
 
     auto it = mCachedMatches.find(combinedId);
     if (it != mCachedMatches.end()) {
-        rapidjson::Value res(it->second, allocator);
-        return res;
+        writer.RawValue(it->second.c_str(), it->second.size(), rapidjson::kObjectType);
+        return;
+    }
+
+    if (!shouldCache) {
+        writeMatchFields(writer, category, match, clockDiff);
+        return;
     }
 
+    auto fragment = serializeFragment(rapidjson::kObjectType, [&](JsonWriter &matchWriter) {
+        writeMatchFields(matchWriter, category, match, clockDiff);
+    });
+
+    writeRaw(writer, fragment);
+    mCachedMatches.emplace(combinedId, std::move(fragment.json));
+}
+
+void JsonEncoder::writeMatchFields(JsonWriter &writer, const CategoryStore &category, const MatchStore &match, std::chrono::milliseconds clockDiff) {
     const auto &ruleset = category.getRuleset();
 
-    rapidjson::Value res;
-    res.SetObject();
+    writer.StartObject();
 
-    res.AddMember("combinedId", encodeCombinedId(combinedId, allocator), allocator);
-    res.AddMember("bye", match.isBye(), allocator);
-    res.AddMember("title", encodeString(match.getTitle(), allocator), allocator);
-    res.AddMember("position", category.getMatchPosition(match.getId()), allocator);
+    writer.Key("combinedId");
+    writeCombinedId(writer, match.getCombinedId());
+    writer.Key("bye");
+    writer.Bool(match.isBye());
+    writer.Key("title");
+    writeString(writer, match.getTitle());
+    writer.Key("position");
+    writer.Uint64(category.getMatchPosition(match.getId()));
 
+    writer.Key("whitePlayer");
     if (match.getWhitePlayer().has_value())
-        res.AddMember("whitePlayer", match.getWhitePlayer()->getValue(), allocator);
+        writer.Uint(match.getWhitePlayer()->getValue());
     else
-        res.AddMember("whitePlayer", rapidjson::Value(), allocator);
+        writer.Null();
 
+    writer.Key("bluePlayer");
     if (match.getBluePlayer().has_value())
-        res.AddMember("bluePlayer", match.getBluePlayer()->getValue(), allocator);
+        writer.Uint(match.getBluePlayer()->getValue());
     else
-        res.AddMember("bluePlayer", rapidjson::Value(), allocator);
+        writer.Null();
 
-    res.AddMember("status", encodeMatchStatus(match.getStatus(), allocator), allocator);
+    writer.Key("status");
+    writeMatchStatus(writer, match.getStatus());
 
-    res.AddMember("whiteScore", encodeMatchScore(match.getWhiteScore(), allocator), allocator);
-    res.AddMember("blueScore", encodeMatchScore(match.getBlueScore(), allocator), allocator);
+    writer.Key("whiteScore");
+    writeMatchScore(writer, match.getWhiteScore());
+    writer.Key("blueScore");
+    writeMatchScore(writer, match.getBlueScore());
 
-    res.AddMember("goldenScore", match.isGoldenScore(), allocator);
+    writer.Key("goldenScore");
+    writer.Bool(match.isGoldenScore());
 
+    writer.Key("resumeTime");
     if (match.getStatus() == MatchStatus::UNPAUSED)
-        res.AddMember("resumeTime", encodeTime(match.getResumeTime(), clockDiff, allocator), allocator);
+        writeTime(writer, match.getResumeTime(), clockDiff);
     else
-        res.AddMember("resumeTime", rapidjson::Value(), allocator);
+        writer.Null();
 
-    res.AddMember("duration", encodeDuration(match.getDuration(), allocator), allocator);
+    writer.Key("duration");
+    writeDuration(writer, match.getDuration());
 
-    res.AddMember("normalTime", encodeDuration(category.getRuleset().getNormalTime(), allocator), allocator);
+    writer.Key("normalTime");
+    writeDuration(writer, ruleset.getNormalTime());
 
-    res.AddMember("osaekomi", encodeOsaekomi(match.getOsaekomi(), clockDiff, allocator), allocator);
+    writer.Key("osaekomi");
+    writeOsaekomi(writer, match.getOsaekomi(), clockDiff);
 
     std::optional<MatchStore::PlayerIndex> winner;
     if (match.getStatus() == MatchStatus::FINISHED)
         winner = ruleset.getWinner(match);
+    writer.Key("winner");
     if (winner.has_value())
-        res.AddMember("winner", encodeString(winner == MatchStore::PlayerIndex::WHITE ? "WHITE" : "BLUE", allocator), allocator);
+        writer.String(winner == MatchStore::PlayerIndex::WHITE ? "WHITE" : "BLUE");
     else
-        res.AddMember("winner", rapidjson::Value(), allocator);
+        writer.Null();
 
-    rapidjson::Value events(rapidjson::kArrayType);
+    writer.Key("events");
+    writer.StartArray();
     for (const MatchEvent &event : match.getEvents())
-        events.PushBack(encodeMatchEvent(event, allocator), allocator);
-
-    res.AddMember("events", events, allocator);
-
-    if (shouldCache) {
-        rapidjson::Document cache;
-        cache.CopyFrom(res, cache.GetAllocator());
-        mCachedMatches.emplace(combinedId, std::move(cache));
-    }
+        writeMatchEvent(writer, event);
+    writer.EndArray();
 
-    return res;
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeMatchScore(const MatchStore::Score &score, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res;
-    res.SetObject();
-
-    res.AddMember("ippon", score.ippon, allocator);
-    res.AddMember("wazari", score.wazari, allocator);
-    res.AddMember("shido", score.shido, allocator);
-    res.AddMember("hansokuMake", score.hansokuMake, allocator);
-    return res;
+void JsonEncoder::writeMatchScore(JsonWriter &writer, const MatchStore::Score &score) {
+    writer.StartObject();
+    writer.Key("ippon");
+    writer.Bool(score.ippon);
+    writer.Key("wazari");
+    writer.Uint(score.wazari);
+    writer.Key("shido");
+    writer.Uint(score.shido);
+    writer.Key("hansokuMake");
+    writer.Bool(score.hansokuMake);
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeMatchStatus(const MatchStatus &status, rapidjson::Document::AllocatorType &allocator) {
+void JsonEncoder::writeMatchStatus(JsonWriter &writer, const MatchStatus &status) {
     if (status == MatchStatus::NOT_STARTED)
-        return encodeString("NOT_STARTED", allocator);
-    if (status == MatchStatus::PAUSED)
-        return encodeString("PAUSED", allocator);
-    if (status == MatchStatus::UNPAUSED)
-        return encodeString("UNPAUSED", allocator);
-    return encodeString("FINISHED", allocator);
+        writer.String("NOT_STARTED");
+    else if (status == MatchStatus::PAUSED)
+        writer.String("PAUSED");
+    else if (status == MatchStatus::UNPAUSED)
+        writer.String("UNPAUSED");
+    else
+        writer.String("FINISHED");
 }
 
-rapidjson::Value JsonEncoder::encodeCombinedId(const CombinedId &id, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res;
-    res.SetObject();
-
-    res.AddMember("categoryId", id.getCategoryId().getValue(), allocator);
-    res.AddMember("matchId", id.getMatchId().getValue(), allocator);
-
-    return res;
+void JsonEncoder::writeCombinedId(JsonWriter &writer, const CombinedId &id) {
+    writer.StartObject();
+    writer.Key("categoryId");
+    writer.Uint(id.getCategoryId().getValue());
+    writer.Key("matchId");
+    writer.Uint(id.getMatchId().getValue());
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeString(const std::string &str, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value json;
-    json.SetString(str.c_str(), str.size(), allocator);
-    return json;
+void JsonEncoder::writeString(JsonWriter &writer, const std::string &str) {
+    writer.String(str.c_str(), static_cast<rapidjson::SizeType>(str.size()));
 }
 
-rapidjson::Value JsonEncoder::encodeMeta(const WebTournamentStore &tournament, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res;
-    res.SetObject();
-
-    res.AddMember("name", encodeString(tournament.getName(), allocator), allocator);
-    res.AddMember("location", encodeString(tournament.getLocation(), allocator), allocator);
-    res.AddMember("date", encodeString(tournament.getDate(), allocator), allocator);
-    res.AddMember("webName", encodeString(tournament.getWebName(), allocator), allocator);
-    res.AddMember("tatamiCount", tournament.getTatamis().tatamiCount(), allocator);
+void JsonEncoder::writeMeta(JsonWriter &writer, const WebTournamentStore &tournament) {
+    writer.StartObject();
+    writer.Key("name");
+    writeString(writer, tournament.getName());
+    writer.Key("location");
+    writeString(writer, tournament.getLocation());
+    writer.Key("date");
+    writeString(writer, tournament.getDate());
+    writer.Key("webName");
+    writeString(writer, tournament.getWebName());
+    writer.Key("tatamiCount");
+    writer.Uint64(tournament.getTatamis().tatamiCount());
+    writer.EndObject();
+}
 
-    return res;
+void JsonEncoder::writeTypeMessage(JsonWriter &writer, const char *type) {
+    writer.StartObject();
+    writer.Key("type");
+    writer.String(type);
+    writer.EndObject();
 }
 
 std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentSubscriptionFailMessage() {
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
-
-    document.AddMember("type", encodeString("tournamentSubscriptionFail", allocator), allocator);
-
     auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    JsonWriter writer(buffer->getStringBuffer());
+    writeTypeMessage(writer, "tournamentSubscriptionFail");
 
     return buffer;
 }
 
 std::unique_ptr<JsonBuffer> JsonEncoder::encodeCategorySubscriptionFailMessage() {
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
-
-    document.AddMember("type", encodeString("categorySubscriptionFail", allocator), allocator);
-
     auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    JsonWriter writer(buffer->getStringBuffer());
+    writeTypeMessage(writer, "categorySubscriptionFail");
 
     return buffer;
 }
 
 std::unique_ptr<JsonBuffer> JsonEncoder::encodeTatamiSubscriptionFailMessage() {
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
-
-    document.AddMember("type", encodeString("tatamiSubscriptionFail", allocator), allocator);
-
     auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    JsonWriter writer(buffer->getStringBuffer());
+    writeTypeMessage(writer, "tatamiSubscriptionFail");
 
     return buffer;
 }
 
 std::unique_ptr<JsonBuffer> JsonEncoder::encodePlayerSubscriptionFailMessage() {
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
-
-    document.AddMember("type", encodeString("playerSubscriptionFail", allocator), allocator);
-
     auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    JsonWriter writer(buffer->getStringBuffer());
+    writeTypeMessage(writer, "playerSubscriptionFail");
 
     return buffer;
 }
 
-rapidjson::Value JsonEncoder::encodeMatchEvent(const MatchEvent &event, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res;
-    res.SetObject();
+void JsonEncoder::writeMatchEvent(JsonWriter &writer, const MatchEvent &event) {
+    writer.StartObject();
 
     // encode type
+    writer.Key("type");
     if (event.type == MatchEventType::IPPON)
-        res.AddMember("type", encodeString("IPPON", allocator), allocator);
+        writer.String("IPPON");
     else if (event.type == MatchEventType::WAZARI)
-        res.AddMember("type", encodeString("WAZARI", allocator), allocator);
+        writer.String("WAZARI");
     else if (event.type == MatchEventType::SHIDO)
-        res.AddMember("type", encodeString("SHIDO", allocator), allocator);
+        writer.String("SHIDO");
     else if (event.type == MatchEventType::HANSOKU_MAKE)
-        res.AddMember("type", encodeString("HANSOKU_MAKE", allocator), allocator);
+        writer.String("HANSOKU_MAKE");
     else if (event.type == MatchEventType::IPPON_OSAEKOMI)
-        res.AddMember("type", encodeString("IPPON_OSAEKOMI", allocator), allocator);
+        writer.String("IPPON_OSAEKOMI");
     else if (event.type == MatchEventType::WAZARI_OSAEKOMI)
-        res.AddMember("type", encodeString("WAZARI_OSAEKOMI", allocator), allocator);
+        writer.String("WAZARI_OSAEKOMI");
     else if (event.type == MatchEventType::CANCEL_IPPON)
-        res.AddMember("type", encodeString("CANCEL_IPPON", allocator), allocator);
+        writer.String("CANCEL_IPPON");
     else if (event.type == MatchEventType::CANCEL_WAZARI)
-        res.AddMember("type", encodeString("CANCEL_WAZARI", allocator), allocator);
+        writer.String("CANCEL_WAZARI");
     else if (event.type == MatchEventType::CANCEL_SHIDO)
-        res.AddMember("type", encodeString("CANCEL_SHIDO", allocator), allocator);
+        writer.String("CANCEL_SHIDO");
     else
-        res.AddMember("type", encodeString("CANCEL_HANSOKU_MAKE", allocator), allocator);
+        writer.String("CANCEL_HANSOKU_MAKE");
 
-    res.AddMember("playerIndex", encodeString(event.playerIndex == MatchStore::PlayerIndex::WHITE ? "WHITE" : "BLUE", allocator), allocator);
-    res.AddMember("duration", encodeDuration(event.duration, allocator), allocator);
+    writer.Key("playerIndex");
+    writer.String(event.playerIndex == MatchStore::PlayerIndex::WHITE ? "WHITE" : "BLUE");
+    writer.Key("duration");
+    writeDuration(writer, event.duration);
 
-    return res;
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeDuration(const std::chrono::milliseconds &duration, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res(duration.count());
-
-    return res;
+void JsonEncoder::writeDuration(JsonWriter &writer, const std::chrono::milliseconds &duration) {
+    writer.Int64(duration.count());
 }
 
-rapidjson::Value JsonEncoder::encodeTime(const std::chrono::milliseconds &time, std::chrono::milliseconds clockDiff, rapidjson::Document::AllocatorType &allocator) {
+void JsonEncoder::writeTime(JsonWriter &writer, const std::chrono::milliseconds &time, std::chrono::milliseconds clockDiff) {
     auto sinceEpoch = time - clockDiff;
-    rapidjson::Value res(sinceEpoch.count()); // unix timestamp
-
-    return res;
+    writer.Int64(sinceEpoch.count()); // unix timestamp
 }
 
-rapidjson::Value JsonEncoder::encodeTatami(size_t index, const WebTatamiModel &model, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res;
-    res.SetObject();
+void JsonEncoder::writeTatami(JsonWriter &writer, size_t index, const WebTatamiModel &model) {
+    writer.StartObject();
 
-    res.AddMember("index", index, allocator);
+    writer.Key("index");
+    writer.Uint64(index);
 
     // encode matches
-    rapidjson::Value matches(rapidjson::kArrayType);
+    writer.Key("matches");
+    writer.StartArray();
     for (auto &combinedId : model.getMatches())
-        matches.PushBack(encodeCombinedId(combinedId, allocator), allocator);
+        writeCombinedId(writer, combinedId);
+    writer.EndArray();
 
-    res.AddMember("matches", matches, allocator);
-
-    return res;
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeOsaekomi(const std::optional<std::pair<MatchStore::PlayerIndex, std::chrono::milliseconds>>& osaekomi, std::chrono::milliseconds clockDiff, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res;
-    if (!osaekomi.has_value())
-        return res;
-
-    res.SetObject();
-    res.AddMember("player", encodeString(osaekomi->first == MatchStore::PlayerIndex::WHITE ? "WHITE" : "BLUE", allocator), allocator);
-    res.AddMember("start", encodeTime(osaekomi->second, clockDiff, allocator), allocator);
+void JsonEncoder::writeOsaekomi(JsonWriter &writer, const std::optional<std::pair<MatchStore::PlayerIndex, std::chrono::milliseconds>>& osaekomi, std::chrono::milliseconds clockDiff) {
+    if (!osaekomi.has_value()) {
+        writer.Null();
+        return;
+    }
 
-    return res;
+    writer.StartObject();
+    writer.Key("player");
+    writer.String(osaekomi->first == MatchStore::PlayerIndex::WHITE ? "WHITE" : "BLUE");
+    writer.Key("start");
+    writeTime(writer, osaekomi->second, clockDiff);
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeCategoryResults(const TournamentStore &tournament, const CategoryStore &category, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res(rapidjson::kArrayType);
-
+void JsonEncoder::writeCategoryResults(JsonWriter &writer, const TournamentStore &tournament, const CategoryStore &category) {
     const auto &drawSystem = category.getDrawSystem();
     auto results = drawSystem.getResults(tournament, category);
 
+    writer.StartArray();
     for (const auto &row : results) {
-        rapidjson::Value val;
-        val.SetObject();
+        writer.StartObject();
 
-        val.AddMember("player", row.first.getValue(), allocator);
+        writer.Key("player");
+        writer.Uint(row.first.getValue());
 
-        rapidjson::Value pos;
+        writer.Key("pos");
         if (row.second.has_value())
-            pos.Set(*(row.second), allocator);
-        val.AddMember("pos", pos, allocator);
+            writer.Uint(*(row.second));
+        else
+            writer.Null();
 
-        res.PushBack(val, allocator);
+        writer.EndObject();
     }
-
-    return res;
+    writer.EndArray();
 }
 
-rapidjson::Value JsonEncoder::encodeSubscribedTatami(size_t index, const WebTournamentStore &tournament, rapidjson::Document::AllocatorType &allocator) {
+void JsonEncoder::writeSubscribedTatami(JsonWriter &writer, size_t index, const WebTournamentStore &tournament) {
     assert(index < tournament.getTatamis().tatamiCount());
     const auto &tatami = tournament.getTatamis().at(index);
-    rapidjson::Value res;
-    res.SetObject();
 
-    res.AddMember("index", index, allocator);
+    writer.StartObject();
+
+    writer.Key("index");
+    writer.Uint64(index);
 
-    rapidjson::Value concurrentGroups(rapidjson::kArrayType);
+    writer.Key("blocks");
+    writer.StartArray();
     for (size_t i = 0; i < tatami.groupCount(); ++i) {
         const auto &concurrentGroup = tatami.at(i);
 
-        rapidjson::Value sequentialGroups(rapidjson::kArrayType);
-
+        writer.StartArray();
         for (size_t j = 0; j < concurrentGroup.groupCount(); ++j) {
             const auto &sequentialGroup = concurrentGroup.at(j);
 
-            rapidjson::Value blocks(rapidjson::kArrayType);
-
+            writer.StartArray();
             for (size_t k = 0; k < sequentialGroup.blockCount(); ++k) {
                 auto p = sequentialGroup.at(k);
 
                 CategoryId categoryId = p.first;
                 MatchType matchType = p.second;
-                rapidjson::Value block;
-                block.SetObject();
-                block.AddMember("categoryId", categoryId.getValue(), allocator);
-                block.AddMember("type", encodeMatchType(matchType, allocator), allocator);
-                block.AddMember("status", encodeBlockStatus(tournament.getCategory(categoryId), matchType, allocator), allocator);
 
-                blocks.PushBack(block, allocator);
+                writer.StartObject();
+                writer.Key("categoryId");
+                writer.Uint(categoryId.getValue());
+                writer.Key("type");
+                writeMatchType(writer, matchType);
+                writer.Key("status");
+                writeBlockStatus(writer, tournament.getCategory(categoryId), matchType);
+                writer.EndObject();
             }
-
-            sequentialGroups.PushBack(blocks, allocator);
+            writer.EndArray();
         }
-
-        concurrentGroups.PushBack(sequentialGroups, allocator);
+        writer.EndArray();
     }
+    writer.EndArray();
 
-    res.AddMember("blocks", concurrentGroups, allocator);
-
-    return res;
+    writer.EndObject();
 }
 
-rapidjson::Value JsonEncoder::encodeMatchType(MatchType matchType, rapidjson::Document::AllocatorType &allocator) {
+void JsonEncoder::writeMatchType(JsonWriter &writer, MatchType matchType) {
     // encode type
     if (matchType == MatchType::FINAL)
-        return encodeString("FINAL", allocator);
+        writer.String("FINAL");
     else
-        return encodeString("ELIMINATION", allocator);
+        writer.String("ELIMINATION");
 }
 
-rapidjson::Value JsonEncoder::encodeBlockStatus(const CategoryStore &category, MatchType matchType, rapidjson::Document::AllocatorType &allocator) {
+void JsonEncoder::writeBlockStatus(JsonWriter &writer, const CategoryStore &category, MatchType matchType) {
     const auto &status = category.getStatus(matchType);
 
     if (status.notStartedMatches > 0 && status.startedMatches == 0 && status.finishedMatches == 0)
-        return encodeString("NOT_STARTED", allocator);
+        writer.String("NOT_STARTED");
     else if (status.startedMatches > 0 || status.notStartedMatches > 0)
-        return encodeString("STARTED", allocator);
+        writer.String("STARTED");
     else
-        return encodeString("FINISHED", allocator);
+        writer.String("FINISHED");
 }
 
-rapidjson::Value JsonEncoder::encodeTournamentListing(const TournamentListing &tournament, rapidjson::Document::AllocatorType &allocator) {
-    rapidjson::Value res;
-    res.SetObject();
-
-    res.AddMember("name", encodeString(tournament.name, allocator), allocator);
-    res.AddMember("webName", encodeString(tournament.webName, allocator), allocator);
-    res.AddMember("location", encodeString(tournament.location, allocator), allocator);
-    res.AddMember("date", encodeString(tournament.date, allocator), allocator);
-
-    return res;
+void JsonEncoder::writeTournamentListing(JsonWriter &writer, const TournamentListing &tournament) {
+    writer.StartObject();
+    writer.Key("name");
+    writeString(writer, tournament.name);
+    writer.Key("webName");
+    writeString(writer, tournament.webName);
+    writer.Key("location");
+    writeString(writer, tournament.location);
+    writer.Key("date");
+    writeString(writer, tournament.date);
+    writer.EndObject();
 }
 
 std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentListingMessage(const std::vector<TournamentListing> &pastTournamentsListing, const std::vector<TournamentListing> &upcomingTournamentsListing) {
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
+    MetricsTimer timer(metrics().encodeListingDuration);
+    auto buffer = std::make_unique<JsonBuffer>();
+    JsonWriter writer(buffer->getStringBuffer());
 
-    document.AddMember("type", encodeString("tournamentListing", allocator), allocator);
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("tournamentListing");
 
     // Past tournaments
-    rapidjson::Value pastTournaments(rapidjson::kArrayType);
+    writer.Key("pastTournaments");
+    writer.StartArray();
     for (const auto &tournament : pastTournamentsListing)
-        pastTournaments.PushBack(encodeTournamentListing(tournament, allocator), allocator);
-    document.AddMember("pastTournaments", pastTournaments, allocator);
+        writeTournamentListing(writer, tournament);
+    writer.EndArray();
 
     // Upcoming tournaments
-    rapidjson::Value upcomingTournaments(rapidjson::kArrayType);
+    writer.Key("upcomingTournaments");
+    writer.StartArray();
     for (const auto &tournament : upcomingTournamentsListing)
-        upcomingTournaments.PushBack(encodeTournamentListing(tournament, allocator), allocator);
-    document.AddMember("upcomingTournaments", upcomingTournaments, allocator);
+        writeTournamentListing(writer, tournament);
+    writer.EndArray();
 
-    auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    writer.EndObject();
 
     return buffer;
 }
 
 std::unique_ptr<JsonBuffer> JsonEncoder::encodeTournamentListingFailMessage() {
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
-
-    document.AddMember("type", encodeString("tournamentListingFail", allocator), allocator);
-
     auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    JsonWriter writer(buffer->getStringBuffer());
+    writeTypeMessage(writer, "tournamentListingFail");
 
     return buffer;
 }
 
 std::unique_ptr<JsonBuffer> JsonEncoder::encodeClockMessage(std::chrono::milliseconds clock) {
-    rapidjson::Document document;
-    document.SetObject();
-    auto &allocator = document.GetAllocator();
-
-    document.AddMember("type", encodeString("clock", allocator), allocator);
-    document.AddMember("clock", clock.count(), allocator);
-
     auto buffer = std::make_unique<JsonBuffer>();
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer->getStringBuffer());
-    document.Accept(writer);
+    JsonWriter writer(buffer->getStringBuffer());
+
+    writer.StartObject();
+    writer.Key("type");
+    writer.String("clock");
+    writer.Key("clock");
+    writer.Int64(clock.count());
+    writer.EndObject();
 
     return buffer;
 }
-
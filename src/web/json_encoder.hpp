@@ -1,9 +1,16 @@
 #pragma once
 
 #include <boost/asio/buffer.hpp>
+#include <mutex>
 #include <optional>
-#include <rapidjson/document.h>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 
 #include "core/id.hpp"
 #include "core/stores/match_store.hpp"
@@ -16,6 +23,38 @@ class WebTournamentStore;
 
 struct TournamentListing;
 
+// Categories, players and tatamis a participant is subscribed to
+struct SubscriptionSet {
+    std::set<CategoryId> categories;
+    std::set<PlayerId> players;
+    std::set<unsigned int> tatamis;
+
+    bool empty() const {
+        return categories.empty() && players.empty() && tatamis.empty();
+    }
+
+    size_t size() const {
+        return categories.size() + players.size() + tatamis.size();
+    }
+
+    bool operator<(const SubscriptionSet &other) const {
+        return std::tie(categories, players, tatamis) < std::tie(other.categories, other.players, other.tatamis);
+    }
+
+    bool operator==(const SubscriptionSet &other) const {
+        return std::tie(categories, players, tatamis) == std::tie(other.categories, other.players, other.tatamis);
+    }
+};
+
+// Targets touched by the tournament changes since they were last cleared.
+// Computed once per flush so that each subscription is checked by lookup
+struct TournamentChangeDigest {
+    bool general; // Changes that every participant is sent
+    std::unordered_set<CategoryId> categories;
+    std::unordered_set<PlayerId> players;
+    std::unordered_set<unsigned int> tatamis;
+};
+
 class JsonBuffer {
 public:
     JsonBuffer();
@@ -23,16 +62,23 @@ public:
     boost::asio::const_buffer getBuffer() const;
     rapidjson::StringBuffer& getStringBuffer();
 
+    // MessagePack encoding of the same message. It is produced on first use
+    // and shared by every participant the buffer is delivered to
+    boost::asio::const_buffer getMessagePackBuffer() const;
+
 private:
     rapidjson::StringBuffer mStringBuffer;
+    mutable std::once_flag mMessagePackFlag;
+    mutable std::string mMessagePack;
 };
 
 class JsonEncoder {
 public:
-    std::unique_ptr<JsonBuffer> encodeTournamentSubscriptionMessage(const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, std::optional<unsigned int> subscribedTatami, std::chrono::milliseconds clockDiff, bool shouldCache);
+    std::unique_ptr<JsonBuffer> encodeTournamentSubscriptionMessage(const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, std::optional<unsigned int> subscribedTatami, std::chrono::milliseconds clockDiff, bool shouldCache, bool lazy);
     std::unique_ptr<JsonBuffer> encodeTournamentSubscriptionFailMessage();
     std::unique_ptr<JsonBuffer> encodeTournamentChangesMessage(const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, std::optional<unsigned int> subscribedTatami, std::chrono::milliseconds clockDiff);
-    bool hasTournamentChanges(const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, std::optional<unsigned int> subscribedTatami);
+    std::unique_ptr<JsonBuffer> encodeTournamentChangesMessage(const WebTournamentStore &tournament, const SubscriptionSet &subscriptions, std::chrono::milliseconds clockDiff); // Lists every changed subscription
+    TournamentChangeDigest digestTournamentChanges(const WebTournamentStore &tournament);
 
     std::unique_ptr<JsonBuffer> encodeCategorySubscriptionMessage(const WebTournamentStore &tournament, const CategoryStore &category, std::chrono::milliseconds clockDiff);
     std::unique_ptr<JsonBuffer> encodeCategorySubscriptionFailMessage();
@@ -43,39 +89,78 @@ public:
     std::unique_ptr<JsonBuffer> encodeTatamiSubscriptionMessage(const WebTournamentStore &tournament, size_t index, std::chrono::milliseconds clockDiff);
     std::unique_ptr<JsonBuffer> encodeTatamiSubscriptionFailMessage();
 
+    // Combined snapshot of several subscriptions. Targets that do not exist are listed as failed
+    std::unique_ptr<JsonBuffer> encodeSubscriptionsMessage(const WebTournamentStore &tournament, const SubscriptionSet &subscriptions, std::chrono::milliseconds clockDiff);
+
+    // Players and categories in ascending id order, starting at the given id. Used by lazy subscriptions
+    std::unique_ptr<JsonBuffer> encodePlayerPageMessage(const WebTournamentStore &tournament, PlayerId from, size_t count);
+    std::unique_ptr<JsonBuffer> encodeCategoryPageMessage(const WebTournamentStore &tournament, CategoryId from, size_t count);
+    std::unique_ptr<JsonBuffer> encodePlayersMessage(const WebTournamentStore &tournament, const std::vector<PlayerId> &playerIds);
+    std::unique_ptr<JsonBuffer> encodeCategoriesMessage(const WebTournamentStore &tournament, const std::vector<CategoryId> &categoryIds);
+
     std::unique_ptr<JsonBuffer> encodeTournamentListingMessage(const std::vector<TournamentListing> &pastTournaments, const std::vector<TournamentListing> &upcomingTournaments);
     std::unique_ptr<JsonBuffer> encodeTournamentListingFailMessage();
 
     std::unique_ptr<JsonBuffer> encodeClockMessage(std::chrono::milliseconds clock);
 
 private:
-    rapidjson::Value encodeMeta(const WebTournamentStore &tournament, rapidjson::Document::AllocatorType &allocator);
-
-    rapidjson::Value encodePlayer(const PlayerStore &player, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeSubscribedPlayer(const PlayerStore &player, rapidjson::Document::AllocatorType &allocator);
-
-    rapidjson::Value encodeCategory(const CategoryStore &category, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeSubscribedCategory(const TournamentStore &tournament, const CategoryStore &category, rapidjson::Document::AllocatorType &allocator);
-
-    rapidjson::Value encodeTatami(size_t index, const WebTatamiModel &model, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeSubscribedTatami(size_t index, const WebTournamentStore &tournament, rapidjson::Document::AllocatorType &allocator);
-
-    rapidjson::Value encodeMatch(const CategoryStore &category, const MatchStore &match, std::chrono::milliseconds clockDiff, rapidjson::Document::AllocatorType &allocator, bool shouldCache);
-    rapidjson::Value encodeCategoryResults(const TournamentStore &tournament, const CategoryStore &category, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeString(const std::string &str, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeCombinedId(const CombinedId &id, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeMatchScore(const MatchStore::Score &score, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeMatchStatus(const MatchStatus &status, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeMatchEvent(const MatchEvent &event, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeDuration(const std::chrono::milliseconds &duration, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeTime(const std::chrono::milliseconds &time, std::chrono::milliseconds clockDiff, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeOsaekomi(const std::optional<std::pair<MatchStore::PlayerIndex, std::chrono::milliseconds>>& osaekomi, std::chrono::milliseconds clockDiff, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeMatchType(MatchType matchType, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeBlockStatus(const CategoryStore &category, MatchType matchType, rapidjson::Document::AllocatorType &allocator);
-    rapidjson::Value encodeTournamentListing(const TournamentListing &tournament, rapidjson::Document::AllocatorType &allocator);
-
-    std::optional<rapidjson::Document> mCachedSubscriptionObject;
-    std::optional<rapidjson::Document> mCachedChangesObject;
-    std::unordered_map<CombinedId, rapidjson::Document> mCachedMatches;
+    typedef rapidjson::Writer<rapidjson::StringBuffer> JsonWriter;
+
+    // Pre-serialized JSON value that is spliced into later messages without being re-encoded
+    struct JsonFragment {
+        rapidjson::Type type;
+        std::string json;
+    };
+
+    // Object members (key and serialized value) shared by every participant of a message
+    typedef std::vector<std::pair<const char *, JsonFragment>> JsonMembers;
+
+    template <typename WriteFunction>
+    JsonFragment serializeFragment(rapidjson::Type type, WriteFunction writeFunction);
+    void writeMembers(JsonWriter &writer, const JsonMembers &members);
+    void writeRaw(JsonWriter &writer, const JsonFragment &fragment);
+
+    JsonMembers serializeSubscriptionMembers(const WebTournamentStore &tournament);
+    JsonMembers serializeChangesMembers(const WebTournamentStore &tournament);
+    std::unique_ptr<JsonBuffer> encodeChangesMessage(const WebTournamentStore &tournament, const SubscriptionSet &subscriptions, bool multiple, std::chrono::milliseconds clockDiff);
+    void writeLazySubscriptionMembers(JsonWriter &writer, const WebTournamentStore &tournament, std::optional<CategoryId> subscribedCategory, std::optional<PlayerId> subscribedPlayer, const std::unordered_set<CombinedId> &matchIds);
+
+    void writeTypeMessage(JsonWriter &writer, const char *type);
+
+    void writeMeta(JsonWriter &writer, const WebTournamentStore &tournament);
+
+    void writePlayerFields(JsonWriter &writer, const PlayerStore &player);
+    void writePlayer(JsonWriter &writer, const PlayerStore &player);
+    void writeSubscribedPlayer(JsonWriter &writer, const PlayerStore &player);
+
+    void writeCategoryFields(JsonWriter &writer, const CategoryStore &category);
+    void writeCategory(JsonWriter &writer, const CategoryStore &category);
+    void writeSubscribedCategory(JsonWriter &writer, const TournamentStore &tournament, const CategoryStore &category);
+
+    void writeTatami(JsonWriter &writer, size_t index, const WebTatamiModel &model);
+    void writeSubscribedTatami(JsonWriter &writer, size_t index, const WebTournamentStore &tournament);
+
+    void writeMatch(JsonWriter &writer, const CategoryStore &category, const MatchStore &match, std::chrono::milliseconds clockDiff, bool shouldCache);
+    void writeMatchFields(JsonWriter &writer, const CategoryStore &category, const MatchStore &match, std::chrono::milliseconds clockDiff);
+    void writeMatches(JsonWriter &writer, const WebTournamentStore &tournament, const std::unordered_set<CombinedId> &matchIds, std::chrono::milliseconds clockDiff, bool shouldCache);
+    void writeCategoryResults(JsonWriter &writer, const TournamentStore &tournament, const CategoryStore &category);
+    void writeString(JsonWriter &writer, const std::string &str);
+    void writeCombinedId(JsonWriter &writer, const CombinedId &id);
+    void writeMatchScore(JsonWriter &writer, const MatchStore::Score &score);
+    void writeMatchStatus(JsonWriter &writer, const MatchStatus &status);
+    void writeMatchEvent(JsonWriter &writer, const MatchEvent &event);
+    void writeDuration(JsonWriter &writer, const std::chrono::milliseconds &duration);
+    void writeTime(JsonWriter &writer, const std::chrono::milliseconds &time, std::chrono::milliseconds clockDiff);
+    void writeOsaekomi(JsonWriter &writer, const std::optional<std::pair<MatchStore::PlayerIndex, std::chrono::milliseconds>>& osaekomi, std::chrono::milliseconds clockDiff);
+    void writeMatchType(JsonWriter &writer, MatchType matchType);
+    void writeBlockStatus(JsonWriter &writer, const CategoryStore &category, MatchType matchType);
+    void writeTournamentListing(JsonWriter &writer, const TournamentListing &tournament);
+
+    std::optional<JsonMembers> mCachedSubscriptionMembers;
+    std::optional<JsonMembers> mCachedChangesMembers;
+    std::unordered_map<CombinedId, std::string> mCachedMatches;
+
+    // Reused when serializing fragments so that caching does not allocate per value
+    rapidjson::StringBuffer mScratchBuffer;
 };
 
@@ -1,7 +1,9 @@
 #include <sstream>
 #include <zstd.h>
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/post.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include "core/constants/actions.hpp"
 #include "core/constants/compression.hpp"
@@ -10,18 +12,27 @@
 #include "web/loaded_tournament.hpp"
 #include "web/web_participant.hpp"
 #include "web/json_encoder.hpp"
+#include "web/metrics.hpp"
+#include "web/constants/tournaments.hpp"
+#include "web/constants/websocket.hpp"
 
 static constexpr size_t FILE_HEADER_SIZE = 17;
+static constexpr size_t JOURNAL_RECORD_HEADER_SIZE = 9;
 
 // TODO: Use newer style boost::asio::post in all code
-LoadedTournament::LoadedTournament(const std::string &webName, const boost::filesystem::path &dataDirectory, boost::asio::io_context &context, Database &database)
+LoadedTournament::LoadedTournament(const std::string &webName, const boost::filesystem::path &dataDirectory, boost::asio::io_context &context, boost::asio::io_context &storageContext, Database &database)
     : mContext(context)
     , mStrand(context)
+    , mJournalStrand(storageContext)
     , mDatabase(database)
     , mWebName(webName)
     , mClockDiff(0)
     , mFileInUse(false)
     , mFileLocation(dataDirectory / webName)
+    , mLastAccess(std::chrono::steady_clock::now().time_since_epoch().count())
+    , mMemoryEstimate(0)
+    , mJournalSequence(0)
+    , mJournalRecordCount(0)
 {
 }
 
@@ -37,98 +48,197 @@ void LoadedTournament::sync(std::unique_ptr<WebTournamentStore> tournament, Shar
     wrapper->actionList = std::move(actionList);
     wrapper->diff = std::move(diff);
 
-    boost::asio::post(mStrand, [this, wrapper, callback](){
+    metrics().strandBacklog.increment();
+    boost::asio::post(mStrand, [this, wrapper, callback, queueTime = std::chrono::steady_clock::now()](){
+        recordStrandDelay(queueTime);
+        metrics().syncs.increment();
+
         mTournament = std::move(wrapper->tournament);
-        mActionList = std::move(wrapper->actionList);
+        mTournament->indexIds();
+        resetActionList(std::move(wrapper->actionList));
         mClockDiff = std::move(wrapper->diff);
         mModificationTime = std::chrono::system_clock::now();
 
+        // The journal record is the only copy serialized here. It is folded
+        // into the save-file by the next save
+        appendJournal(JournalRecordType::SYNC, mClockDiff, *mTournament, mActionList);
+
         mTournament->flushWebTatamiModels();
 
         deliverSync();
 
+        // Tournaments without a save time in the database are never loaded, so
+        // the first sync is saved right away instead of living in the journal
+        if (mSynchronizationTime == std::chrono::system_clock::time_point() && !mFileInUse) {
+            save([webName = mWebName](bool success) {
+                if (!success)
+                    log_error().field("webName", webName).msg("Failed saving synced tournament");
+            });
+        }
+
         boost::asio::dispatch(mContext, std::bind(callback, true));
     });
 }
 
-void LoadedTournament::dispatch(ClientActionId actionId, std::shared_ptr<Action> action, DispatchCallback callback) {
-    mStrand.post([this, actionId, action, callback](){
-        try {
-            action->redo(*mTournament);
-        }
-        catch (const std::exception &e) {
-            boost::asio::dispatch(mContext, std::bind(callback, false));
+void LoadedTournament::setClockDiff(std::chrono::milliseconds diff) {
+    boost::asio::dispatch(mStrand, [this, diff]() {
+        if (mTournament == nullptr)
+            return;
+
+        // Every measurement differs by a few milliseconds of round trip noise.
+        // The stored offset is kept unless the hub's clock actually drifted
+        const auto drift = (diff > mClockDiff ? diff - mClockDiff : mClockDiff - diff);
+        if (drift <= Constants::CLOCK_DIFF_TOLERANCE)
             return;
-        }
 
-        mActionList.push_back({actionId, std::move(action)});
-        mActionIds.insert(actionId);
+        mClockDiff = diff;
         mModificationTime = std::chrono::system_clock::now();
+        appendJournal(JournalRecordType::CLOCK_DIFF, mClockDiff);
+
+        // Only running matches are encoded with times relative to the hub's
+        // clock, so they are sent as changes instead of a full sync
+        for (const auto &p : mTournament->getCategories()) {
+            std::vector<MatchId> matchIds;
+            for (const MatchStore &match : p.second->getMatches()) {
+                if (match.getStatus() == MatchStatus::UNPAUSED || match.getOsaekomi().has_value())
+                    matchIds.push_back(match.getId());
+            }
 
-        if (mActionList.size() > MAX_ACTION_STACK_SIZE) {
-            mActionIds.erase(mActionList.front().first);
-            mActionList.pop_front();
+            if (!matchIds.empty())
+                mTournament->changeMatches(p.first, matchIds);
         }
 
         mTournament->flushWebTatamiModels();
         deliverChanges();
+    });
+}
+
+void LoadedTournament::getActionIds(ActionIdsCallback callback) {
+    boost::asio::dispatch(mStrand, [this, callback](){
+        std::vector<ClientActionId> actionIds;
+        if (mTournament != nullptr) {
+            for (const auto &p : mActionList)
+                actionIds.push_back(p.first);
+        }
+
+        boost::asio::dispatch(mContext, std::bind(callback, std::move(actionIds)));
+    });
+}
+
+void LoadedTournament::dispatch(ClientActionId actionId, std::shared_ptr<Action> action, DispatchCallback callback) {
+    metrics().strandBacklog.increment();
+    mStrand.post([this, actionId, action, callback, queueTime = std::chrono::steady_clock::now()](){
+        recordStrandDelay(queueTime);
+        metrics().dispatchedActions.increment();
+
+        if (!redoAction(actionId, action)) {
+            boost::asio::dispatch(mContext, std::bind(callback, false));
+            return;
+        }
+
+        appendJournal(JournalRecordType::ACTION, actionId, action);
+
+        mTournament->flushWebTatamiModels();
+        deliverChanges();
 
         boost::asio::dispatch(mContext, std::bind(callback, true));
     });
 }
 
 void LoadedTournament::undo(ClientActionId actionId, UndoCallback callback) {
-    mStrand.post([this, actionId, callback](){
-        auto idIt = mActionIds.find(actionId);
-        if (idIt == mActionIds.end()) {
+    metrics().strandBacklog.increment();
+    mStrand.post([this, actionId, callback, queueTime = std::chrono::steady_clock::now()](){
+        recordStrandDelay(queueTime);
+        metrics().undoneActions.increment();
+
+        if (!undoAction(actionId)) {
             boost::asio::dispatch(mContext, std::bind(callback, false));
             return;
         }
 
-        // If the action is not found, the loop will be rolled back before failing
-        bool success = true;
+        appendJournal(JournalRecordType::UNDO, actionId);
 
-        try {
-            auto it = std::prev(mActionList.end());
-            while (it != mActionList.begin() && it->first != actionId) {
-                it->second->undo(*mTournament);
-                std::advance(it, -1);
-            }
+        mTournament->flushWebTatamiModels();
+        deliverChanges();
 
-            if (it->first != actionId) {
-                success = false;
-                std::advance(it, 1);
-            }
-            else {
-                auto it2 = it;
-                it = std::next(it2);
+        boost::asio::dispatch(mContext, std::bind(callback, true));
+    });
+}
 
-                it2->second->undo(*mTournament);
-                mActionList.erase(it2);
-            }
+void LoadedTournament::recordStrandDelay(std::chrono::steady_clock::time_point queueTime) {
+    metrics().strandBacklog.decrement();
+    metrics().strandDelay.observe(std::chrono::steady_clock::now() - queueTime);
+}
 
-            while (it != mActionList.end()) {
-                it->second->redo(*mTournament);
-                std::advance(it, 1);
-            }
+bool LoadedTournament::redoAction(ClientActionId actionId, std::shared_ptr<Action> action) {
+    try {
+        action->redo(*mTournament);
+    }
+    catch (const std::exception &e) {
+        return false;
+    }
+
+    mActionList.push_back({actionId, std::move(action)});
+    mActionIds.insert(actionId);
+    mModificationTime = std::chrono::system_clock::now();
+
+    if (mActionList.size() > MAX_ACTION_STACK_SIZE) {
+        mActionIds.erase(mActionList.front().first);
+        mActionList.pop_front();
+    }
+
+    return true;
+}
+
+bool LoadedTournament::undoAction(ClientActionId actionId) {
+    auto idIt = mActionIds.find(actionId);
+    if (idIt == mActionIds.end())
+        return false;
+
+    // If the action is not found, the loop will be rolled back before failing
+    bool success = true;
+
+    try {
+        auto it = std::prev(mActionList.end());
+        while (it != mActionList.begin() && it->first != actionId) {
+            it->second->undo(*mTournament);
+            std::advance(it, -1);
         }
-        catch (const std::exception &e) {
+
+        if (it->first != actionId) {
             success = false;
+            std::advance(it, 1);
         }
+        else {
+            auto it2 = it;
+            it = std::next(it2);
 
-        if (!success) {
-            boost::asio::dispatch(mContext, std::bind(callback, false));
-            return;
+            it2->second->undo(*mTournament);
+            mActionList.erase(it2);
         }
 
-        mTournament->flushWebTatamiModels();
-        deliverChanges();
+        while (it != mActionList.end()) {
+            it->second->redo(*mTournament);
+            std::advance(it, 1);
+        }
+    }
+    catch (const std::exception &e) {
+        success = false;
+    }
 
-        mModificationTime = std::chrono::system_clock::now();
-        mActionIds.erase(idIt);
+    if (!success)
+        return false;
 
-        boost::asio::dispatch(mContext, std::bind(callback, true));
-    });
+    mModificationTime = std::chrono::system_clock::now();
+    mActionIds.erase(idIt);
+    return true;
+}
+
+void LoadedTournament::resetActionList(SharedActionList actionList) {
+    mActionList = std::move(actionList);
+    mActionIds.clear();
+    for (const auto &p : mActionList)
+        mActionIds.insert(p.first);
 }
 
 void LoadedTournament::load(LoadCallback callback) {
@@ -193,10 +303,16 @@ void LoadedTournament::load(LoadCallback callback) {
         }
 
         auto tournament = std::make_unique<WebTournamentStore>();
+        unsigned int journalSequence = 0;
+        SharedActionList actionList;
         try {
             std::istringstream stream(uncompressed);
             cereal::PortableBinaryInputArchive archive(stream);
             archive(mClockDiff, *tournament);
+
+            // Save-files written before the journal was introduced end here
+            if (stream.peek() != std::istringstream::traits_type::eof())
+                archive(journalSequence, actionList);
         }
         catch(const std::exception &e) {
             boost::asio::dispatch(mContext, std::bind(callback, false));
@@ -206,9 +322,31 @@ void LoadedTournament::load(LoadCallback callback) {
         }
 
         mTournament = std::move(tournament);
+        mTournament->indexIds();
+        resetActionList(std::move(actionList));
+        mMemoryEstimate = uncompressedSize;
+        mSnapshot.reset();
+        mLazySnapshot.reset();
+
+        // Replay the journal files written since the save. New records are
+        // appended to a fresh journal file so that a partially written record
+        // at the end of the last one is never followed by valid records
+        mJournalSequence = journalSequence;
+        mJournalRecordCount = 0;
+        while (replayJournal(mJournalSequence))
+            ++mJournalSequence;
+
+        if (mJournalRecordCount > 0) {
+            log_info().field("webName", mWebName).field("recordCount", mJournalRecordCount).msg("Replayed tournament journal");
+            mJournalStartTime = std::chrono::steady_clock::now();
+        }
+
+        boost::asio::post(mJournalStrand, [this, journalSequence]() {
+            removeJournals(journalSequence);
+        });
+
         mTournament->flushWebTatamiModels();
-        mActionIds.clear();
-        mActionList.clear();
+        mTournament->clearChanges();
 
         mSynchronizationTime = std::chrono::system_clock::now();
         mFileInUse = false;
@@ -226,12 +364,15 @@ void LoadedTournament::save(SaveCallback callback) {
 
         mFileInUse = true;
 
+        // Records appended from now on go to a new journal file. The previous
+        // ones are removed once the save-file containing them is written
+        const unsigned int journalSequence = ++mJournalSequence;
         auto uncompressed = std::make_shared<std::string>();
 
         try {
             std::ostringstream stream;
             cereal::PortableBinaryOutputArchive archive(stream);
-            archive(mClockDiff, *mTournament);
+            archive(mClockDiff, *mTournament, journalSequence, mActionList);
             *uncompressed = stream.str();
         }
         catch(const std::exception &e) {
@@ -241,7 +382,19 @@ void LoadedTournament::save(SaveCallback callback) {
             return;
         }
 
-        boost::asio::dispatch(mContext, [this, uncompressed, callback]() {
+        mMemoryEstimate = uncompressed->size();
+        mJournalRecordCount = 0;
+
+        // Compression and writing run on the journal strand, off the tournament
+        // context. The guard keeps the context running until the callback is made
+        boost::asio::post(mJournalStrand, [this, uncompressed, journalSequence, callback, work = boost::asio::make_work_guard(mContext)]() {
+            auto fail = [this, callback]() {
+                boost::asio::dispatch(mStrand, [this, callback]() {
+                    mFileInUse = false;
+                    boost::asio::dispatch(mContext, std::bind(callback, false));
+                });
+            };
+
             // Compress string
             const size_t uncompressedSize = uncompressed->size();
             const size_t compressBound = ZSTD_compressBound(uncompressedSize);
@@ -251,8 +404,7 @@ void LoadedTournament::save(SaveCallback callback) {
 
             if (ZSTD_isError(compressedSize)) {
                 log_error().msg("Failed compressing tournament for save-file");
-                boost::asio::dispatch(mContext, std::bind(callback, false));
-                mFileInUse = false;
+                fail();
                 return;
             }
 
@@ -266,20 +418,21 @@ void LoadedTournament::save(SaveCallback callback) {
             }
             catch(const std::exception &e) {
                 log_error().msg("Failed serialization of tournament save-file header");
-                boost::asio::dispatch(mContext, std::bind(callback, false));
-                mFileInUse = false;
+                fail();
                 return;
             }
 
             assert(header.size() == FILE_HEADER_SIZE);
 
-            // Write header and data to file
-            std::ofstream file(mFileLocation.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+            // Write header and data to a temporary file and move it in place
+            // so that a crash never leaves a partially written save-file
+            boost::filesystem::path temporaryLocation = mFileLocation;
+            temporaryLocation += ".tmp";
+            std::ofstream file(temporaryLocation.string(), std::ios::out | std::ios::binary | std::ios::trunc);
 
             if (!file.is_open()) {
                 log_error().msg("Failed opening tournament save-file");
-                boost::asio::dispatch(mContext, std::bind(callback, false));
-                mFileInUse = false;
+                fail();
                 return;
             }
 
@@ -290,33 +443,245 @@ void LoadedTournament::save(SaveCallback callback) {
             }
             catch(const std::exception &e) {
                 log_error().msg("Failed writing tournament binary data to save-file");
-                boost::asio::dispatch(mContext, std::bind(callback, false));
-                mFileInUse = false;
+                fail();
+                return;
+            }
+
+            boost::system::error_code ec;
+            boost::filesystem::rename(temporaryLocation, mFileLocation, ec);
+            if (ec) {
+                log_error().field("message", ec.message()).msg("Failed replacing tournament save-file");
+                fail();
                 return;
             }
 
+            // The callback may unload the tournament, so the journals are removed first
+            removeJournals(journalSequence);
+
             boost::asio::dispatch(mStrand, [this, callback]() {
                 mFileInUse = false;
                 mSynchronizationTime = std::chrono::system_clock::now();
-                mDatabase.asyncSetSaveTime(mWebName, mSynchronizationTime, [this](bool success) {
+                // The tournament may be unloaded before the database responds
+                mDatabase.asyncSetSaveTime(mWebName, mSynchronizationTime, [webName = mWebName](bool success) {
                     if (!success)
-                        log_error().field("webName", mWebName).msg("Failed updating database save_time column");
+                        log_error().field("webName", webName).msg("Failed updating database save_time column");
                 });
+
                 boost::asio::dispatch(mContext, std::bind(callback, true));
             });
         });
     });
 }
 
-void LoadedTournament::saveIfNeccesary() {
+void LoadedTournament::saveIfNeccesary(SaveCallback callback) {
+    boost::asio::dispatch(mStrand, [this, callback](){
+        if (mModificationTime <= mSynchronizationTime && mJournalRecordCount == 0) {
+            if (callback)
+                boost::asio::dispatch(mContext, std::bind(callback, true));
+            return;
+        }
+
+        save([this, callback](bool success) {
+            if (!success)
+                log_error().field("webName", mWebName).msg("Failed saving tournament");
+            if (callback)
+                callback(success);
+        });
+    });
+}
+
+void LoadedTournament::compactJournal() {
     boost::asio::dispatch(mStrand, [this](){
-        if (mModificationTime > mSynchronizationTime) {
-            save([this](bool success) {
-                if (!success)
-                    log_error().field("webName", mWebName).msg("Failed saving tournament");
-            });
+        if (mJournalRecordCount == 0 || mFileInUse)
+            return;
+
+        if (std::chrono::steady_clock::now() - mJournalStartTime < Constants::JOURNAL_COMPACTION_INTERVAL)
+            return;
+
+        save([webName = mWebName](bool success) {
+            if (!success)
+                log_error().field("webName", webName).msg("Failed compacting tournament journal");
+        });
+    });
+}
+
+boost::filesystem::path LoadedTournament::getJournalLocation(unsigned int sequence) const {
+    boost::filesystem::path location = mFileLocation;
+    location += ".journal-" + std::to_string(sequence);
+    return location;
+}
+
+template <typename... Args>
+void LoadedTournament::appendJournal(JournalRecordType type, const Args&... args) {
+    std::string record;
+    try {
+        std::ostringstream stream;
+        cereal::PortableBinaryOutputArchive archive(stream);
+        archive(type, args...);
+        record = stream.str();
+    }
+    catch(const std::exception &e) {
+        log_error().field("webName", mWebName).msg("Failed serialization of tournament journal record");
+        return;
+    }
+
+    if (mJournalRecordCount++ == 0)
+        mJournalStartTime = std::chrono::steady_clock::now();
+
+    boost::asio::post(mJournalStrand, [this, sequence = mJournalSequence, record = std::move(record)]() {
+        if (mJournalFileSequence != sequence) {
+            mJournalFile = std::ofstream(getJournalLocation(sequence).string(), std::ios::out | std::ios::binary | std::ios::app);
+            mJournalFileSequence = sequence;
+        }
+
+        // Records are prefixed with their size so that a partially written
+        // record at the end of the file can be detected when replaying
+        std::string header;
+        try {
+            std::ostringstream stream;
+            cereal::PortableBinaryOutputArchive archive(stream);
+            archive(static_cast<uint64_t>(record.size()));
+            header = stream.str();
+        }
+        catch(const std::exception &e) {
+            log_error().field("webName", mWebName).msg("Failed serialization of tournament journal record header");
+            return;
+        }
+
+        assert(header.size() == JOURNAL_RECORD_HEADER_SIZE);
+
+        mJournalFile.write(header.data(), header.size());
+        mJournalFile.write(record.data(), record.size());
+        mJournalFile.flush();
+
+        if (!mJournalFile) {
+            log_error().field("webName", mWebName).msg("Failed writing tournament journal record");
+            mJournalFileSequence.reset(); // Reopen the file for the next record
         }
     });
+
+    if (mJournalRecordCount >= Constants::JOURNAL_COMPACTION_SIZE && !mFileInUse) {
+        save([webName = mWebName](bool success) {
+            if (!success)
+                log_error().field("webName", webName).msg("Failed compacting tournament journal");
+        });
+    }
+}
+
+bool LoadedTournament::replayJournal(unsigned int sequence) {
+    std::ifstream file(getJournalLocation(sequence).string(), std::ios::in | std::ios::binary);
+
+    if (!file.is_open())
+        return false;
+
+    std::string header;
+    header.resize(JOURNAL_RECORD_HEADER_SIZE);
+    while (file.read(header.data(), JOURNAL_RECORD_HEADER_SIZE)) {
+        uint64_t size;
+        try {
+            std::istringstream stream(header);
+            cereal::PortableBinaryInputArchive archive(stream);
+            archive(size);
+        }
+        catch (const std::exception &e) {
+            log_error().field("webName", mWebName).msg("Failed reading tournament journal record header");
+            return true;
+        }
+
+        std::string record;
+        record.resize(size);
+        if (!file.read(record.data(), size)) {
+            log_warning().field("webName", mWebName).msg("Ignoring partially written tournament journal record");
+            return true;
+        }
+
+        if (!replayJournalRecord(record))
+            log_warning().field("webName", mWebName).msg("Failed replaying tournament journal record");
+        ++mJournalRecordCount;
+    }
+
+    if (file.gcount() > 0)
+        log_warning().field("webName", mWebName).msg("Ignoring partially written tournament journal record");
+
+    return true;
+}
+
+bool LoadedTournament::replayJournalRecord(const std::string &record) {
+    try {
+        std::istringstream stream(record);
+        cereal::PortableBinaryInputArchive archive(stream);
+
+        JournalRecordType type;
+        archive(type);
+
+        if (type == JournalRecordType::ACTION) {
+            ClientActionId actionId;
+            std::shared_ptr<Action> action;
+            archive(actionId, action);
+            return redoAction(actionId, std::move(action));
+        }
+
+        if (type == JournalRecordType::UNDO) {
+            ClientActionId actionId;
+            archive(actionId);
+            return undoAction(actionId);
+        }
+
+        if (type == JournalRecordType::CLOCK_DIFF) {
+            archive(mClockDiff);
+            return true;
+        }
+
+        std::chrono::milliseconds clockDiff;
+        auto tournament = std::make_unique<WebTournamentStore>();
+        SharedActionList actionList;
+        archive(clockDiff, *tournament, actionList);
+
+        mTournament = std::move(tournament);
+        mTournament->indexIds();
+        resetActionList(std::move(actionList));
+        mClockDiff = clockDiff;
+        return true;
+    }
+    catch (const std::exception &e) {
+        return false;
+    }
+}
+
+void LoadedTournament::removeJournals(unsigned int sequence) {
+    if (mJournalFileSequence && *mJournalFileSequence < sequence) {
+        mJournalFile.close();
+        mJournalFileSequence.reset();
+    }
+
+    for (unsigned int i = sequence; i > 0; --i) {
+        boost::system::error_code ec;
+        if (!boost::filesystem::remove(getJournalLocation(i - 1), ec))
+            break;
+    }
+}
+
+void LoadedTournament::prepareUnload(UnloadCallback callback) {
+    boost::asio::dispatch(mStrand, [this, callback](){
+        if (!mWebParticipants.empty() || !mOwner.expired() || mFileInUse) {
+            boost::asio::dispatch(mContext, std::bind(callback, false));
+            return;
+        }
+
+        saveIfNeccesary(callback);
+    });
+}
+
+void LoadedTournament::touch() {
+    mLastAccess = std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+std::chrono::steady_clock::time_point LoadedTournament::getLastAccess() const {
+    return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(mLastAccess.load()));
+}
+
+size_t LoadedTournament::getMemoryEstimate() const {
+    return mMemoryEstimate;
 }
 
 void LoadedTournament::setOwner(std::weak_ptr<TCPParticipant> owner) {
@@ -331,30 +696,115 @@ std::weak_ptr<TCPParticipant> LoadedTournament::getOwner() {
     return mOwner;
 }
 
-void LoadedTournament::addParticipant(std::shared_ptr<WebParticipant> participant) {
-    boost::asio::dispatch(mStrand, [this, participant](){
-        JsonEncoder encoder;
-        auto message = encoder.encodeTournamentSubscriptionMessage(*mTournament, std::nullopt, std::nullopt, std::nullopt, mClockDiff, false);
-        participant->deliver(std::move(message));
+// Arguments of the single subscription encoder functions. Empty for multiple
+// subscriptions, which are sent in messages of their own
+static std::tuple<std::optional<CategoryId>, std::optional<PlayerId>, std::optional<unsigned int>> getSingleSubscription(const SubscriptionSet &targets, bool multiple) {
+    if (multiple)
+        return {};
+
+    std::optional<CategoryId> category;
+    if (!targets.categories.empty())
+        category = *targets.categories.begin();
+
+    std::optional<PlayerId> player;
+    if (!targets.players.empty())
+        player = *targets.players.begin();
+
+    std::optional<unsigned int> tatami;
+    if (!targets.tatamis.empty())
+        tatami = *targets.tatamis.begin();
+
+    return {category, player, tatami};
+}
+
+// Removes the participant from the subscriber set of the target, erasing the set once empty
+template <typename Target>
+static void eraseSubscriber(std::unordered_map<Target, std::unordered_set<std::shared_ptr<WebParticipant>>> &subscribers, const Target &target, const std::shared_ptr<WebParticipant> &participant) {
+    auto it = subscribers.find(target);
+    if (it == subscribers.end())
+        return;
+
+    it->second.erase(participant);
+    if (it->second.empty())
+        subscribers.erase(it);
+}
+
+void LoadedTournament::addParticipant(std::shared_ptr<WebParticipant> participant, bool lazy) {
+    boost::asio::dispatch(mStrand, [this, participant, lazy](){
+        participant->deliver(getSnapshot(lazy), MessageKind::TOURNAMENT_STATE);
 
+        if (lazy)
+            mLazyParticipants.insert(participant);
         mWebParticipants.insert(std::move(participant));
     });
 }
 
 void LoadedTournament::eraseParticipant(std::shared_ptr<WebParticipant> participant) {
     boost::asio::dispatch(mStrand, [this, participant](){
+        touch();
+        unsubscribe(participant);
         mWebParticipants.erase(participant);
-        mPlayerSubscriptions.erase(participant);
-        mCategorySubscriptions.erase(participant);
-        mTatamiSubscriptions.erase(participant);
+        mLazyParticipants.erase(participant);
+    });
+}
+
+void LoadedTournament::resync(std::shared_ptr<WebParticipant> participant) {
+    boost::asio::dispatch(mStrand, [this, participant](){
+        if (mWebParticipants.find(participant) == mWebParticipants.end())
+            return;
+
+        const bool lazy = (mLazyParticipants.find(participant) != mLazyParticipants.end());
+        const auto key = getSubscriptionKey(participant);
+        JsonEncoder encoder;
+        if (key.multiple) {
+            participant->deliver(getSnapshot(lazy), MessageKind::TOURNAMENT_STATE);
+            participant->deliver(encoder.encodeSubscriptionsMessage(*mTournament, key.targets, mClockDiff), MessageKind::SUBSCRIPTION_STATE, std::make_shared<const SubscriptionSet>(key.targets));
+            return;
+        }
+
+        if (key == SubscriptionKey()) {
+            participant->deliver(getSnapshot(lazy), MessageKind::TOURNAMENT_STATE);
+            return;
+        }
+
+        const auto [category, player, tatami] = getSingleSubscription(key.targets, false);
+        participant->deliver(encoder.encodeTournamentSubscriptionMessage(*mTournament, category, player, tatami, mClockDiff, false, lazy), MessageKind::TOURNAMENT_STATE);
+    });
+}
+
+void LoadedTournament::listPlayers(std::shared_ptr<WebParticipant> participant, PlayerId from, size_t count) {
+    boost::asio::dispatch(mStrand, [this, participant, from, count](){
+        JsonEncoder encoder;
+        participant->deliver(encoder.encodePlayerPageMessage(*mTournament, from, count));
+    });
+}
+
+void LoadedTournament::listCategories(std::shared_ptr<WebParticipant> participant, CategoryId from, size_t count) {
+    boost::asio::dispatch(mStrand, [this, participant, from, count](){
+        JsonEncoder encoder;
+        participant->deliver(encoder.encodeCategoryPageMessage(*mTournament, from, count));
+    });
+}
+
+void LoadedTournament::getPlayers(std::shared_ptr<WebParticipant> participant, std::vector<PlayerId> players) {
+    boost::asio::dispatch(mStrand, [this, participant, players = std::move(players)](){
+        JsonEncoder encoder;
+        participant->deliver(encoder.encodePlayersMessage(*mTournament, players));
+    });
+}
+
+void LoadedTournament::getCategories(std::shared_ptr<WebParticipant> participant, std::vector<CategoryId> categories) {
+    boost::asio::dispatch(mStrand, [this, participant, categories = std::move(categories)](){
+        JsonEncoder encoder;
+        participant->deliver(encoder.encodeCategoriesMessage(*mTournament, categories));
     });
 }
 
 void LoadedTournament::subscribeCategory(std::shared_ptr<WebParticipant> participant, CategoryId category) {
     boost::asio::dispatch(mStrand, [this, participant, category](){
-        mCategorySubscriptions[participant] = category;
-        mPlayerSubscriptions.erase(participant);
-        mTatamiSubscriptions.erase(participant);
+        unsubscribe(participant);
+        mSubscriptions[participant].targets.categories.insert(category);
+        mCategorySubscribers[category].insert(participant);
         JsonEncoder encoder;
         std::unique_ptr<JsonBuffer> message;
         if (mTournament->containsCategory(category))
@@ -362,15 +812,15 @@ void LoadedTournament::subscribeCategory(std::shared_ptr<WebParticipant> partici
         else
             message = encoder.encodeCategorySubscriptionFailMessage();
 
-        participant->deliver(std::move(message));
+        participant->deliver(std::move(message), MessageKind::SUBSCRIPTION_STATE, std::make_shared<const SubscriptionSet>(mSubscriptions[participant].targets));
     });
 }
 
 void LoadedTournament::subscribePlayer(std::shared_ptr<WebParticipant> participant, PlayerId player) {
     boost::asio::dispatch(mStrand, [this, participant, player](){
-        mPlayerSubscriptions[participant] = player;
-        mCategorySubscriptions.erase(participant);
-        mTatamiSubscriptions.erase(participant);
+        unsubscribe(participant);
+        mSubscriptions[participant].targets.players.insert(player);
+        mPlayerSubscribers[player].insert(participant);
         JsonEncoder encoder;
         std::unique_ptr<JsonBuffer> message;
         if (mTournament->containsPlayer(player))
@@ -378,15 +828,15 @@ void LoadedTournament::subscribePlayer(std::shared_ptr<WebParticipant> participa
         else
             message = encoder.encodePlayerSubscriptionFailMessage();
 
-        participant->deliver(std::move(message));
+        participant->deliver(std::move(message), MessageKind::SUBSCRIPTION_STATE, std::make_shared<const SubscriptionSet>(mSubscriptions[participant].targets));
     });
 }
 
 void LoadedTournament::subscribeTatami(std::shared_ptr<WebParticipant> participant, unsigned int index) {
     boost::asio::dispatch(mStrand, [this, participant, index]() {
-        mTatamiSubscriptions[participant] = index;
-        mPlayerSubscriptions.erase(participant);
-        mCategorySubscriptions.erase(participant);
+        unsubscribe(participant);
+        mSubscriptions[participant].targets.tatamis.insert(index);
+        mTatamiSubscribers[index].insert(participant);
         JsonEncoder encoder;
         std::unique_ptr<JsonBuffer> message;
         if (index < mTournament->getTatamis().tatamiCount())
@@ -394,39 +844,184 @@ void LoadedTournament::subscribeTatami(std::shared_ptr<WebParticipant> participa
         else
             message = encoder.encodeTatamiSubscriptionFailMessage();
 
-        participant->deliver(std::move(message));
+        participant->deliver(std::move(message), MessageKind::SUBSCRIPTION_STATE, std::make_shared<const SubscriptionSet>(mSubscriptions[participant].targets));
+    });
+}
+
+void LoadedTournament::addSubscriptions(std::shared_ptr<WebParticipant> participant, SubscriptionSet subscriptions) {
+    boost::asio::dispatch(mStrand, [this, participant, subscriptions = std::move(subscriptions)]() {
+        auto it = mSubscriptions.find(participant);
+        if (it != mSubscriptions.end() && !it->second.multiple)
+            unsubscribe(participant);
+
+        auto &key = mSubscriptions[participant];
+        key.multiple = true;
+
+        // Only targets not already subscribed to are sent
+        SubscriptionSet added;
+        for (auto category : subscriptions.categories) {
+            if (key.targets.size() >= Constants::MAX_SUBSCRIPTIONS)
+                break;
+            if (!key.targets.categories.insert(category).second)
+                continue;
+            mCategorySubscribers[category].insert(participant);
+            added.categories.insert(category);
+        }
+
+        for (auto player : subscriptions.players) {
+            if (key.targets.size() >= Constants::MAX_SUBSCRIPTIONS)
+                break;
+            if (!key.targets.players.insert(player).second)
+                continue;
+            mPlayerSubscribers[player].insert(participant);
+            added.players.insert(player);
+        }
+
+        for (auto index : subscriptions.tatamis) {
+            if (key.targets.size() >= Constants::MAX_SUBSCRIPTIONS)
+                break;
+            if (!key.targets.tatamis.insert(index).second)
+                continue;
+            mTatamiSubscribers[index].insert(participant);
+            added.tatamis.insert(index);
+        }
+
+        if (key.targets.empty())
+            mSubscriptions.erase(participant);
+
+        // Earlier batches are still needed, so the message is never replaced while queued
+        JsonEncoder encoder;
+        participant->deliver(encoder.encodeSubscriptionsMessage(*mTournament, added, mClockDiff));
+    });
+}
+
+void LoadedTournament::eraseSubscriptions(std::shared_ptr<WebParticipant> participant, SubscriptionSet subscriptions) {
+    boost::asio::dispatch(mStrand, [this, participant, subscriptions = std::move(subscriptions)]() {
+        auto it = mSubscriptions.find(participant);
+        if (it == mSubscriptions.end() || !it->second.multiple)
+            return;
+
+        auto &targets = it->second.targets;
+        for (auto category : subscriptions.categories) {
+            if (targets.categories.erase(category) > 0)
+                eraseSubscriber(mCategorySubscribers, category, participant);
+        }
+
+        for (auto player : subscriptions.players) {
+            if (targets.players.erase(player) > 0)
+                eraseSubscriber(mPlayerSubscribers, player, participant);
+        }
+
+        for (auto index : subscriptions.tatamis) {
+            if (targets.tatamis.erase(index) > 0)
+                eraseSubscriber(mTatamiSubscribers, index, participant);
+        }
+
+        if (targets.empty())
+            mSubscriptions.erase(it);
     });
 }
 
+void LoadedTournament::unsubscribe(const std::shared_ptr<WebParticipant> &participant) {
+    auto it = mSubscriptions.find(participant);
+    if (it == mSubscriptions.end())
+        return;
+
+    const auto &targets = it->second.targets;
+    for (auto category : targets.categories)
+        eraseSubscriber(mCategorySubscribers, category, participant);
+    for (auto player : targets.players)
+        eraseSubscriber(mPlayerSubscribers, player, participant);
+    for (auto index : targets.tatamis)
+        eraseSubscriber(mTatamiSubscribers, index, participant);
+
+    mSubscriptions.erase(it);
+}
+
+
+std::map<LoadedTournament::SubscriptionKey, std::vector<std::shared_ptr<WebParticipant>>> LoadedTournament::groupParticipants() const {
+    std::map<SubscriptionKey, std::vector<std::shared_ptr<WebParticipant>>> groups;
+    for (const auto & participant : mWebParticipants)
+        groups[getSubscriptionKey(participant)].push_back(participant);
+
+    return groups;
+}
+
+LoadedTournament::SubscriptionKey LoadedTournament::getSubscriptionKey(const std::shared_ptr<WebParticipant> &participant) const {
+    auto it = mSubscriptions.find(participant);
+    if (it == mSubscriptions.end())
+        return SubscriptionKey();
+    return it->second;
+}
+
+std::shared_ptr<const JsonBuffer> LoadedTournament::getSnapshot(bool lazy) {
+    auto &snapshot = (lazy ? mLazySnapshot : mSnapshot);
+    if (!snapshot) {
+        JsonEncoder encoder;
+        snapshot = encoder.encodeTournamentSubscriptionMessage(*mTournament, std::nullopt, std::nullopt, std::nullopt, mClockDiff, false, lazy);
+    }
+
+    return snapshot;
+}
+
 void LoadedTournament::deliverChanges() {
+    // Encode once per distinct subscription and share the buffer between its participants
     JsonEncoder encoder;
-    for (const auto & participant : mWebParticipants) {
-        std::optional<CategoryId> category;
-        auto categoryIt = mCategorySubscriptions.find(participant);
-        if (categoryIt != mCategorySubscriptions.end())
-            category = categoryIt->second;
-
-        std::optional<PlayerId> player;
-        auto playerIt = mPlayerSubscriptions.find(participant);
-        if (playerIt != mPlayerSubscriptions.end())
-            player = playerIt->second;
-
-        std::optional<unsigned int> tatami;
-        auto tatamiIt = mTatamiSubscriptions.find(participant);
-        if (tatamiIt != mTatamiSubscriptions.end())
-            tatami = tatamiIt->second;
-
-        if (!encoder.hasTournamentChanges(*mTournament, category, player, tatami))
-            continue;
-
-        auto buffer = encoder.encodeTournamentChangesMessage(*mTournament, category, player, tatami, mClockDiff);
-        participant->deliver(std::move(buffer));
+    const TournamentChangeDigest digest = encoder.digestTournamentChanges(*mTournament);
+
+    std::map<SubscriptionKey, std::vector<std::shared_ptr<WebParticipant>>> groups;
+    if (digest.general) {
+        // The snapshots contain exactly what participants without subscriptions see
+        mSnapshot.reset();
+        mLazySnapshot.reset();
+
+        // Every participant is sent changes
+        groups = groupParticipants();
+    }
+    else {
+        // Only the subscribers of the changed targets are sent changes
+        std::unordered_set<std::shared_ptr<WebParticipant>> participants;
+        for (auto category : digest.categories) {
+            auto it = mCategorySubscribers.find(category);
+            if (it != mCategorySubscribers.end())
+                participants.insert(it->second.begin(), it->second.end());
+        }
+
+        for (auto player : digest.players) {
+            auto it = mPlayerSubscribers.find(player);
+            if (it != mPlayerSubscribers.end())
+                participants.insert(it->second.begin(), it->second.end());
+        }
+
+        for (auto tatami : digest.tatamis) {
+            auto it = mTatamiSubscribers.find(tatami);
+            if (it != mTatamiSubscribers.end())
+                participants.insert(it->second.begin(), it->second.end());
+        }
+
+        for (const auto & participant : participants)
+            groups[getSubscriptionKey(participant)].push_back(participant);
+    }
+
+    for (const auto & [key, participants] : groups) {
+        auto target = (key.targets.empty() ? nullptr : std::make_shared<const SubscriptionSet>(key.targets));
+        std::shared_ptr<const JsonBuffer> buffer;
+        if (key.multiple) {
+            buffer = encoder.encodeTournamentChangesMessage(*mTournament, key.targets, mClockDiff);
+        }
+        else {
+            const auto [category, player, tatami] = getSingleSubscription(key.targets, false);
+            buffer = encoder.encodeTournamentChangesMessage(*mTournament, category, player, tatami, mClockDiff);
+        }
+
+        for (const auto & participant : participants)
+            participant->deliver(buffer, MessageKind::CHANGES, target);
     }
 
     if (mTournament->tournamentChanged()) { // updates names, location etc of tournament
-        mDatabase.asyncUpdateTournament(mWebName, mTournament->getName(), mTournament->getLocation(), mTournament->getDate(), [this](bool success) {
+        mDatabase.asyncUpdateTournament(mWebName, mTournament->getName(), mTournament->getLocation(), mTournament->getDate(), [webName = mWebName](bool success) {
             if (!success)
-                log_error().field("webName", mWebName).msg("Failed updating database tournament info");
+                log_error().field("webName", webName).msg("Failed updating database tournament info");
         });
     }
 
@@ -435,29 +1030,38 @@ void LoadedTournament::deliverChanges() {
 
 void LoadedTournament::deliverSync() {
     JsonEncoder encoder;
-    for (const auto & participant : mWebParticipants) {
-        std::optional<CategoryId> category;
-        auto categoryIt = mCategorySubscriptions.find(participant);
-        if (categoryIt != mCategorySubscriptions.end())
-            category = categoryIt->second;
-
-        std::optional<PlayerId> player;
-        auto playerIt = mPlayerSubscriptions.find(participant);
-        if (playerIt != mPlayerSubscriptions.end())
-            player = playerIt->second;
-
-        std::optional<unsigned int> tatami;
-        auto tatamiIt = mTatamiSubscriptions.find(participant);
-        if (tatamiIt != mTatamiSubscriptions.end())
-            tatami = tatamiIt->second;
-
-        auto buffer = encoder.encodeTournamentSubscriptionMessage(*mTournament, category, player, tatami, mClockDiff, true);
-        participant->deliver(std::move(buffer));
+    mSnapshot.reset();
+    mLazySnapshot.reset();
+    for (const auto & [key, participants] : groupParticipants()) {
+        const auto [category, player, tatami] = getSingleSubscription(key.targets, key.multiple);
+        std::shared_ptr<const JsonBuffer> buffer;
+        std::shared_ptr<const JsonBuffer> lazyBuffer;
+        std::shared_ptr<const JsonBuffer> subscriptionsBuffer;
+        std::shared_ptr<const SubscriptionSet> target;
+        if (key.multiple) {
+            subscriptionsBuffer = encoder.encodeSubscriptionsMessage(*mTournament, key.targets, mClockDiff);
+            target = std::make_shared<const SubscriptionSet>(key.targets);
+        }
+
+        for (const auto & participant : participants) {
+            const bool lazy = (mLazyParticipants.find(participant) != mLazyParticipants.end());
+            auto &message = (lazy ? lazyBuffer : buffer);
+            if (!message)
+                message = encoder.encodeTournamentSubscriptionMessage(*mTournament, category, player, tatami, mClockDiff, true, lazy);
+            participant->deliver(message, MessageKind::TOURNAMENT_STATE);
+            if (subscriptionsBuffer)
+                participant->deliver(subscriptionsBuffer, MessageKind::SUBSCRIPTION_STATE, target);
+        }
+
+        if (key == SubscriptionKey()) {
+            mSnapshot = std::move(buffer);
+            mLazySnapshot = std::move(lazyBuffer);
+        }
     }
 
-    mDatabase.asyncUpdateTournament(mWebName, mTournament->getName(), mTournament->getLocation(), mTournament->getDate(), [this](bool success) {
+    mDatabase.asyncUpdateTournament(mWebName, mTournament->getName(), mTournament->getLocation(), mTournament->getDate(), [webName = mWebName](bool success) {
         if (!success)
-            log_error().field("webName", mWebName).msg("Failed updating database tournament info");
+            log_error().field("webName", webName).msg("Failed updating database tournament info");
     });
 
     mTournament->clearChanges();
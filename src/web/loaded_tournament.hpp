@@ -2,36 +2,67 @@
 
 #include <boost/asio/io_context_strand.hpp>
 #include <boost/filesystem/path.hpp>
+#include <atomic>
 #include <chrono>
 #include <fstream>
+#include <map>
+#include <optional>
+#include <tuple>
 
 #include "core/actions/action.hpp"
 #include "web/web_tournament_store.hpp"
 #include "web/database.hpp"
+#include "web/json_encoder.hpp"
 
 class WebParticipant;
 class TCPParticipant;
 
 class LoadedTournament {
 public:
-    LoadedTournament(const std::string &webName, const boost::filesystem::path &dataDirectory, boost::asio::io_context &context, Database &database);
+    // Journal records and save-files are compressed and written on the storage
+    // context so that disk work never runs on the tournament's context
+    LoadedTournament(const std::string &webName, const boost::filesystem::path &dataDirectory, boost::asio::io_context &context, boost::asio::io_context &storageContext, Database &database);
 
     typedef std::function<void (bool)> SyncCallback;
     void sync(std::unique_ptr<WebTournamentStore> tournament, SharedActionList actionList, std::chrono::milliseconds diff, SyncCallback callback);
 
+    // Updates the offset to the hub's clock measured when a hub resumes an upload.
+    // Measurements within Constants::CLOCK_DIFF_TOLERANCE of the stored offset are ignored
+    void setClockDiff(std::chrono::milliseconds diff);
+
     typedef std::function<void (bool)> DispatchCallback;
     void dispatch(ClientActionId actionId, std::shared_ptr<Action> action, DispatchCallback callback);
 
     typedef std::function<void (bool)> UndoCallback;
     void undo(ClientActionId actionId, UndoCallback callback);
 
+    // Ids of the applied actions, oldest first. Lets a reconnecting hub upload
+    // only the actions that are missing
+    typedef std::function<void (std::vector<ClientActionId>)> ActionIdsCallback;
+    void getActionIds(ActionIdsCallback callback);
+
     typedef std::function<void (bool)> LoadCallback;
     void load(LoadCallback callback);
 
     typedef std::function<void (bool)> SaveCallback;
     void save(SaveCallback callback);
 
-    void saveIfNeccesary();
+    void saveIfNeccesary(SaveCallback callback = nullptr);
+
+    // Folds the journal into a new save-file once it has grown large or old enough
+    void compactJournal();
+
+    // Saves the tournament if needed and reports whether it can be dropped,
+    // i.e. whether it has no participants and no owner
+    typedef std::function<void (bool)> UnloadCallback;
+    void prepareUnload(UnloadCallback callback);
+
+    // Marks the tournament as used. Safe to call from any thread
+    void touch();
+    std::chrono::steady_clock::time_point getLastAccess() const;
+
+    // Serialized size at the last load or save. Safe to call from any thread
+    size_t getMemoryEstimate() const;
 
     void setOwner(std::weak_ptr<TCPParticipant> owner);
     void clearOwner();
@@ -41,15 +72,84 @@ public:
     void subscribePlayer(std::shared_ptr<WebParticipant> participant, PlayerId player);
     void subscribeTatami(std::shared_ptr<WebParticipant> participant, unsigned int index);
 
-    void addParticipant(std::shared_ptr<WebParticipant> participant);
+    // Adds to the participant's subscriptions, replacing a subscription made
+    // with the functions above. Only the added targets are encoded and they
+    // are sent together in a single message
+    void addSubscriptions(std::shared_ptr<WebParticipant> participant, SubscriptionSet subscriptions);
+    void eraseSubscriptions(std::shared_ptr<WebParticipant> participant, SubscriptionSet subscriptions);
+
+    // Lazy participants are only sent the players and categories they need
+    // up front and request the rest through the list and get functions
+    void addParticipant(std::shared_ptr<WebParticipant> participant, bool lazy);
     void eraseParticipant(std::shared_ptr<WebParticipant> participant);
 
+    // Sends the participant a fresh subscription replacing its queued updates
+    void resync(std::shared_ptr<WebParticipant> participant);
+
+    void listPlayers(std::shared_ptr<WebParticipant> participant, PlayerId from, size_t count);
+    void listCategories(std::shared_ptr<WebParticipant> participant, CategoryId from, size_t count);
+    void getPlayers(std::shared_ptr<WebParticipant> participant, std::vector<PlayerId> players);
+    void getCategories(std::shared_ptr<WebParticipant> participant, std::vector<CategoryId> categories);
+
 private:
+    // Participants with equal subscriptions are sent identical messages. A
+    // single subscription made with subscribeCategory, subscribePlayer or
+    // subscribeTatami keeps the message format of those functions
+    struct SubscriptionKey {
+        SubscriptionSet targets;
+        bool multiple = false;
+
+        bool operator<(const SubscriptionKey &other) const {
+            return std::tie(multiple, targets) < std::tie(other.multiple, other.targets);
+        }
+
+        bool operator==(const SubscriptionKey &other) const {
+            return multiple == other.multiple && targets == other.targets;
+        }
+    };
+
+    std::map<SubscriptionKey, std::vector<std::shared_ptr<WebParticipant>>> groupParticipants() const;
+    SubscriptionKey getSubscriptionKey(const std::shared_ptr<WebParticipant> &participant) const;
+
+    void unsubscribe(const std::shared_ptr<WebParticipant> &participant); // Removes all of the participant's subscriptions
+
     void deliverChanges();
     void deliverSync();
 
+    // Applies an action or undo to the tournament and the action list. Shared
+    // between live requests and journal replay
+    bool redoAction(ClientActionId actionId, std::shared_ptr<Action> action);
+    bool undoAction(ClientActionId actionId);
+
+    void recordStrandDelay(std::chrono::steady_clock::time_point queueTime); // Called when a hub request starts running on the strand
+
+    // Every dispatch, undo, sync and clock change since the last save is appended to the
+    // journal, which is replayed on top of the save-file when loading. Each
+    // save starts a new journal file so that older ones can be deleted once
+    // the save-file is written
+    enum class JournalRecordType : uint8_t {
+        ACTION,
+        UNDO,
+        SYNC,
+        CLOCK_DIFF,
+    };
+
+    boost::filesystem::path getJournalLocation(unsigned int sequence) const;
+    template <typename... Args>
+    void appendJournal(JournalRecordType type, const Args&... args);
+    bool replayJournal(unsigned int sequence);
+    bool replayJournalRecord(const std::string &record);
+    void removeJournals(unsigned int sequence); // Removes the journal files preceding the sequence number. Must be called on the journal strand
+
+    void resetActionList(SharedActionList actionList);
+
+    // Returns the subscription message sent to participants joining without any
+    // subscriptions. It is shared between joins until the tournament changes
+    std::shared_ptr<const JsonBuffer> getSnapshot(bool lazy);
+
     boost::asio::io_context &mContext;
     boost::asio::io_context::strand mStrand;
+    boost::asio::io_context::strand mJournalStrand;
     Database &mDatabase;
 
     // TODO: Store tournament_id or make webName a key in the database
@@ -59,14 +159,29 @@ private:
     std::chrono::milliseconds mClockDiff;
     std::unordered_set<ClientActionId> mActionIds;
     std::unordered_set<std::shared_ptr<WebParticipant>> mWebParticipants;
-    std::unordered_map<std::shared_ptr<WebParticipant>, PlayerId> mPlayerSubscriptions;
-    std::unordered_map<std::shared_ptr<WebParticipant>, CategoryId> mCategorySubscriptions;
-    std::unordered_map<std::shared_ptr<WebParticipant>, unsigned int> mTatamiSubscriptions;
+    std::unordered_map<std::shared_ptr<WebParticipant>, SubscriptionKey> mSubscriptions;
+
+    // Subscribers by target, so that a flush only visits the participants of the changed targets
+    typedef std::unordered_set<std::shared_ptr<WebParticipant>> ParticipantSet;
+    std::unordered_map<CategoryId, ParticipantSet> mCategorySubscribers;
+    std::unordered_map<PlayerId, ParticipantSet> mPlayerSubscribers;
+    std::unordered_map<unsigned int, ParticipantSet> mTatamiSubscribers;
+    std::unordered_set<std::shared_ptr<WebParticipant>> mLazyParticipants;
     std::weak_ptr<TCPParticipant> mOwner;
+    std::shared_ptr<const JsonBuffer> mSnapshot; // Empty when the tournament changed since it was encoded
+    std::shared_ptr<const JsonBuffer> mLazySnapshot;
 
     bool mFileInUse;
     boost::filesystem::path mFileLocation;
     std::chrono::system_clock::time_point mSynchronizationTime; // Time when the tournament was last saved/loaded
     std::chrono::system_clock::time_point mModificationTime; // Time when the tournament was last modified
+    std::atomic<std::chrono::steady_clock::rep> mLastAccess;
+    std::atomic<size_t> mMemoryEstimate;
+
+    unsigned int mJournalSequence; // Sequence number of the journal file currently appended to
+    size_t mJournalRecordCount; // Records appended since the last save
+    std::chrono::steady_clock::time_point mJournalStartTime; // Time of the first record since the last save
+    std::ofstream mJournalFile; // Only accessed on the journal strand
+    std::optional<unsigned int> mJournalFileSequence;
 };
 
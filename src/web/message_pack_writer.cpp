@@ -0,0 +1,197 @@
+#include <cstring>
+
+#include "web/message_pack_writer.hpp"
+
+// Containers are opened with room for the largest (5 byte) header
+static constexpr size_t MAX_CONTAINER_HEADER_SIZE = 5;
+
+MessagePackWriter::MessagePackWriter(std::string &output)
+    : mOutput(output)
+{}
+
+std::string MessagePackWriter::transcode(const char *json, size_t size) {
+    std::string output;
+    output.reserve(size);
+
+    MessagePackWriter writer(output);
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(json);
+
+    if (reader.Parse(stream, writer).IsError())
+        return std::string();
+
+    return output;
+}
+
+void MessagePackWriter::writeBigEndian(uint64_t value, size_t bytes) {
+    for (size_t i = bytes; i > 0; --i)
+        mOutput.push_back(static_cast<char>((value >> (8 * (i - 1))) & 0xff));
+}
+
+bool MessagePackWriter::Null() {
+    mOutput.push_back(static_cast<char>(0xc0));
+    return true;
+}
+
+bool MessagePackWriter::Bool(bool value) {
+    mOutput.push_back(static_cast<char>(value ? 0xc3 : 0xc2));
+    return true;
+}
+
+bool MessagePackWriter::Int(int value) {
+    return Int64(value);
+}
+
+bool MessagePackWriter::Uint(unsigned value) {
+    return Uint64(value);
+}
+
+bool MessagePackWriter::Int64(int64_t value) {
+    if (value >= 0)
+        return Uint64(static_cast<uint64_t>(value));
+
+    if (value >= -32) {
+        mOutput.push_back(static_cast<char>(value)); // negative fixint
+    }
+    else if (value >= INT8_MIN) {
+        mOutput.push_back(static_cast<char>(0xd0));
+        writeBigEndian(static_cast<uint8_t>(value), 1);
+    }
+    else if (value >= INT16_MIN) {
+        mOutput.push_back(static_cast<char>(0xd1));
+        writeBigEndian(static_cast<uint16_t>(value), 2);
+    }
+    else if (value >= INT32_MIN) {
+        mOutput.push_back(static_cast<char>(0xd2));
+        writeBigEndian(static_cast<uint32_t>(value), 4);
+    }
+    else {
+        mOutput.push_back(static_cast<char>(0xd3));
+        writeBigEndian(static_cast<uint64_t>(value), 8);
+    }
+
+    return true;
+}
+
+bool MessagePackWriter::Uint64(uint64_t value) {
+    if (value <= 0x7f) {
+        mOutput.push_back(static_cast<char>(value)); // positive fixint
+    }
+    else if (value <= UINT8_MAX) {
+        mOutput.push_back(static_cast<char>(0xcc));
+        writeBigEndian(value, 1);
+    }
+    else if (value <= UINT16_MAX) {
+        mOutput.push_back(static_cast<char>(0xcd));
+        writeBigEndian(value, 2);
+    }
+    else if (value <= UINT32_MAX) {
+        mOutput.push_back(static_cast<char>(0xce));
+        writeBigEndian(value, 4);
+    }
+    else {
+        mOutput.push_back(static_cast<char>(0xcf));
+        writeBigEndian(value, 8);
+    }
+
+    return true;
+}
+
+bool MessagePackWriter::Double(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    mOutput.push_back(static_cast<char>(0xcb));
+    writeBigEndian(bits, 8);
+    return true;
+}
+
+bool MessagePackWriter::RawNumber(const char *str, rapidjson::SizeType length, bool copy) {
+    // Only called when parsing with kParseNumbersAsStringsFlag
+    return false;
+}
+
+bool MessagePackWriter::String(const char *str, rapidjson::SizeType length, bool copy) {
+    if (length < 32) {
+        mOutput.push_back(static_cast<char>(0xa0 | length));
+    }
+    else if (length <= UINT8_MAX) {
+        mOutput.push_back(static_cast<char>(0xd9));
+        writeBigEndian(length, 1);
+    }
+    else if (length <= UINT16_MAX) {
+        mOutput.push_back(static_cast<char>(0xda));
+        writeBigEndian(length, 2);
+    }
+    else {
+        mOutput.push_back(static_cast<char>(0xdb));
+        writeBigEndian(length, 4);
+    }
+
+    mOutput.append(str, length);
+    return true;
+}
+
+bool MessagePackWriter::Key(const char *str, rapidjson::SizeType length, bool copy) {
+    return String(str, length, copy);
+}
+
+void MessagePackWriter::startContainer() {
+    mContainerOffsets.push_back(mOutput.size());
+    mOutput.append(MAX_CONTAINER_HEADER_SIZE, '\0');
+}
+
+void MessagePackWriter::endContainer(uint8_t fixPrefix, uint8_t prefix16, uint8_t prefix32, uint32_t count) {
+    const size_t offset = mContainerOffsets.back();
+    mContainerOffsets.pop_back();
+
+    char header[MAX_CONTAINER_HEADER_SIZE];
+    size_t headerSize;
+    if (count < 16) {
+        header[0] = static_cast<char>(fixPrefix | count);
+        headerSize = 1;
+    }
+    else if (count <= UINT16_MAX) {
+        header[0] = static_cast<char>(prefix16);
+        header[1] = static_cast<char>(count >> 8);
+        header[2] = static_cast<char>(count);
+        headerSize = 3;
+    }
+    else {
+        header[0] = static_cast<char>(prefix32);
+        header[1] = static_cast<char>(count >> 24);
+        header[2] = static_cast<char>(count >> 16);
+        header[3] = static_cast<char>(count >> 8);
+        header[4] = static_cast<char>(count);
+        headerSize = 5;
+    }
+
+    // Shift the contents back over the unused part of the reserved header
+    char *data = mOutput.data() + offset;
+    const size_t contentSize = mOutput.size() - offset - MAX_CONTAINER_HEADER_SIZE;
+    if (headerSize < MAX_CONTAINER_HEADER_SIZE)
+        std::memmove(data + headerSize, data + MAX_CONTAINER_HEADER_SIZE, contentSize);
+    std::memcpy(data, header, headerSize);
+    mOutput.resize(offset + headerSize + contentSize);
+}
+
+bool MessagePackWriter::StartObject() {
+    startContainer();
+    return true;
+}
+
+bool MessagePackWriter::EndObject(rapidjson::SizeType memberCount) {
+    endContainer(0x80, 0xde, 0xdf, memberCount);
+    return true;
+}
+
+bool MessagePackWriter::StartArray() {
+    startContainer();
+    return true;
+}
+
+bool MessagePackWriter::EndArray(rapidjson::SizeType elementCount) {
+    endContainer(0x90, 0xdc, 0xdd, elementCount);
+    return true;
+}
+
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <rapidjson/reader.h>
+
+// SAX handler that re-encodes a JSON document as MessagePack. Maps and arrays
+// are given the smallest header that fits once their size is known.
+class MessagePackWriter {
+public:
+    MessagePackWriter(std::string &output);
+
+    // Returns an empty string if the json could not be parsed
+    static std::string transcode(const char *json, size_t size);
+
+    bool Null();
+    bool Bool(bool value);
+    bool Int(int value);
+    bool Uint(unsigned value);
+    bool Int64(int64_t value);
+    bool Uint64(uint64_t value);
+    bool Double(double value);
+    bool RawNumber(const char *str, rapidjson::SizeType length, bool copy);
+    bool String(const char *str, rapidjson::SizeType length, bool copy);
+    bool StartObject();
+    bool Key(const char *str, rapidjson::SizeType length, bool copy);
+    bool EndObject(rapidjson::SizeType memberCount);
+    bool StartArray();
+    bool EndArray(rapidjson::SizeType elementCount);
+
+private:
+    void writeBigEndian(uint64_t value, size_t bytes);
+    void startContainer();
+    void endContainer(uint8_t fixPrefix, uint8_t prefix16, uint8_t prefix32, uint32_t count);
+
+    std::string &mOutput;
+    std::vector<size_t> mContainerOffsets; // Where the header of each open container starts
+};
+
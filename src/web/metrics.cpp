@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <sstream>
+
+#include "web/metrics.hpp"
+
+static const std::vector<double> LATENCY_BOUNDS = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5};
+static const std::vector<double> QUEUE_DEPTH_BOUNDS = {1, 2, 4, 8, 16, 32, 64, 128, 256};
+
+Metric::Metric(const std::string &name, const std::string &help, const std::string &labels)
+    : mName(name)
+    , mHelp(help)
+    , mLabels(labels)
+{}
+
+const std::string & Metric::getName() const {
+    return mName;
+}
+
+const std::string & Metric::getHelp() const {
+    return mHelp;
+}
+
+MetricsCounter::MetricsCounter(const std::string &name, const std::string &help, const std::string &labels)
+    : Metric(name, help, labels)
+    , mValue(0)
+{}
+
+void MetricsCounter::increment(uint64_t value) {
+    mValue.fetch_add(value, std::memory_order_relaxed);
+}
+
+const char * MetricsCounter::getType() const {
+    return "counter";
+}
+
+void MetricsCounter::serialize(std::ostream &stream) const {
+    writeSample(stream, "", "", mValue.load(std::memory_order_relaxed));
+}
+
+MetricsGauge::MetricsGauge(const std::string &name, const std::string &help, const std::string &labels)
+    : Metric(name, help, labels)
+    , mValue(0)
+{}
+
+void MetricsGauge::increment(int64_t value) {
+    mValue.fetch_add(value, std::memory_order_relaxed);
+}
+
+void MetricsGauge::decrement(int64_t value) {
+    mValue.fetch_sub(value, std::memory_order_relaxed);
+}
+
+void MetricsGauge::set(int64_t value) {
+    mValue.store(value, std::memory_order_relaxed);
+}
+
+const char * MetricsGauge::getType() const {
+    return "gauge";
+}
+
+void MetricsGauge::serialize(std::ostream &stream) const {
+    writeSample(stream, "", "", mValue.load(std::memory_order_relaxed));
+}
+
+MetricsHistogram::MetricsHistogram(const std::string &name, const std::string &help, std::vector<double> bounds, const std::string &labels)
+    : Metric(name, help, labels)
+    , mBounds(std::move(bounds))
+    , mBuckets(std::make_unique<std::atomic<uint64_t>[]>(mBounds.size() + 1))
+    , mCount(0)
+    , mSum(0)
+{
+    for (size_t i = 0; i <= mBounds.size(); ++i)
+        mBuckets[i].store(0, std::memory_order_relaxed);
+}
+
+void MetricsHistogram::observe(double value) {
+    const size_t bucket = std::lower_bound(mBounds.begin(), mBounds.end(), value) - mBounds.begin();
+    mBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+
+    double sum = mSum.load(std::memory_order_relaxed);
+    while (!mSum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed));
+}
+
+void MetricsHistogram::observe(std::chrono::steady_clock::duration duration) {
+    observe(std::chrono::duration<double>(duration).count());
+}
+
+const char * MetricsHistogram::getType() const {
+    return "histogram";
+}
+
+void MetricsHistogram::serialize(std::ostream &stream) const {
+    // Buckets are read one by one while being updated, so the cumulative
+    // counts may be slightly inconsistent with the total. Scrapers tolerate this
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < mBounds.size(); ++i) {
+        cumulative += mBuckets[i].load(std::memory_order_relaxed);
+
+        std::ostringstream label;
+        label << "le=\"" << mBounds[i] << '"';
+        writeSample(stream, "_bucket", label.str(), cumulative);
+    }
+
+    cumulative += mBuckets[mBounds.size()].load(std::memory_order_relaxed);
+    writeSample(stream, "_bucket", "le=\"+Inf\"", cumulative);
+    writeSample(stream, "_sum", "", mSum.load(std::memory_order_relaxed));
+    writeSample(stream, "_count", "", mCount.load(std::memory_order_relaxed));
+}
+
+MetricsTimer::MetricsTimer(MetricsHistogram &histogram)
+    : mHistogram(histogram)
+    , mStart(std::chrono::steady_clock::now())
+{}
+
+MetricsTimer::~MetricsTimer() {
+    mHistogram.observe(std::chrono::steady_clock::now() - mStart);
+}
+
+Metrics::Metrics()
+    : tcpParticipants("judoassistant_tcp_participants", "Connected hubs")
+    , webParticipants("judoassistant_web_participants", "Connected websocket clients")
+    , loadedTournaments("judoassistant_loaded_tournaments", "Tournaments held in memory")
+    , queuedMessages("judoassistant_websocket_queued_messages", "Websocket messages waiting to be written")
+    , queueDepth("judoassistant_websocket_queue_depth", "Depth of a participant's write queue when a message is queued", QUEUE_DEPTH_BOUNDS)
+    , sentMessages("judoassistant_websocket_sent_messages_total", "Websocket messages written")
+    , droppedMessages("judoassistant_websocket_dropped_messages_total", "Queued websocket messages replaced by newer state")
+    , encodeSubscriptionDuration("judoassistant_json_encode_seconds", "Time spent encoding JSON messages", LATENCY_BOUNDS, "message=\"subscription\"")
+    , encodeChangesDuration("judoassistant_json_encode_seconds", "Time spent encoding JSON messages", LATENCY_BOUNDS, "message=\"changes\"")
+    , encodeListingDuration("judoassistant_json_encode_seconds", "Time spent encoding JSON messages", LATENCY_BOUNDS, "message=\"listing\"")
+    , pendingQueries("judoassistant_database_pending_requests", "Database requests waiting for or running on a connection")
+    , queryWaitDuration("judoassistant_database_wait_seconds", "Time database requests wait for a free connection", LATENCY_BOUNDS)
+    , queryDuration("judoassistant_database_query_seconds", "Time spent running database requests", LATENCY_BOUNDS)
+    , strandBacklog("judoassistant_tournament_strand_backlog", "Hub requests waiting to run on a tournament strand")
+    , strandDelay("judoassistant_tournament_strand_delay_seconds", "Time hub requests wait before running on a tournament strand", LATENCY_BOUNDS)
+    , dispatchedActions("judoassistant_tournament_actions_total", "Actions dispatched by hubs")
+    , undoneActions("judoassistant_tournament_undos_total", "Actions undone by hubs")
+    , syncs("judoassistant_tournament_syncs_total", "Full tournament syncs received from hubs")
+    , mMetrics({
+        &tcpParticipants, &webParticipants, &loadedTournaments,
+        &queuedMessages, &queueDepth, &sentMessages, &droppedMessages,
+        &encodeSubscriptionDuration, &encodeChangesDuration, &encodeListingDuration,
+        &pendingQueries, &queryWaitDuration, &queryDuration,
+        &strandBacklog, &strandDelay, &dispatchedActions, &undoneActions, &syncs,
+    })
+{}
+
+std::string Metrics::serialize() const {
+    std::ostringstream stream;
+    const std::string *previousName = nullptr;
+    for (const Metric *metric : mMetrics) {
+        if (previousName == nullptr || *previousName != metric->getName()) {
+            stream << "# HELP " << metric->getName() << ' ' << metric->getHelp() << '\n';
+            stream << "# TYPE " << metric->getName() << ' ' << metric->getType() << '\n';
+        }
+
+        metric->serialize(stream);
+        previousName = &metric->getName();
+    }
+
+    return stream.str();
+}
+
+Metrics & metrics() {
+    static Metrics instance;
+    return instance;
+}
+
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Metrics are recorded from the hot paths of every worker thread. Recording
+// only updates relaxed atomics, so it never takes a lock or allocates. The
+// values are read when the metrics endpoint is scraped
+class Metric {
+public:
+    Metric(const std::string &name, const std::string &help, const std::string &labels);
+    virtual ~Metric() = default;
+
+    const std::string & getName() const;
+    const std::string & getHelp() const;
+    virtual const char * getType() const = 0;
+
+    // Writes the samples in the Prometheus text format
+    virtual void serialize(std::ostream &stream) const = 0;
+
+protected:
+    template <typename T>
+    void writeSample(std::ostream &stream, const std::string &suffix, const std::string &extraLabel, const T &value) const {
+        stream << mName << suffix;
+
+        if (!mLabels.empty() || !extraLabel.empty()) {
+            stream << '{' << mLabels;
+            if (!mLabels.empty() && !extraLabel.empty())
+                stream << ',';
+            stream << extraLabel << '}';
+        }
+
+        stream << ' ' << value << '\n';
+    }
+
+private:
+    std::string mName;
+    std::string mHelp;
+    std::string mLabels;
+};
+
+class MetricsCounter : public Metric {
+public:
+    MetricsCounter(const std::string &name, const std::string &help, const std::string &labels = "");
+
+    void increment(uint64_t value = 1);
+
+    const char * getType() const override;
+    void serialize(std::ostream &stream) const override;
+
+private:
+    std::atomic<uint64_t> mValue;
+};
+
+class MetricsGauge : public Metric {
+public:
+    MetricsGauge(const std::string &name, const std::string &help, const std::string &labels = "");
+
+    void increment(int64_t value = 1);
+    void decrement(int64_t value = 1);
+    void set(int64_t value);
+
+    const char * getType() const override;
+    void serialize(std::ostream &stream) const override;
+
+private:
+    std::atomic<int64_t> mValue;
+};
+
+class MetricsHistogram : public Metric {
+public:
+    MetricsHistogram(const std::string &name, const std::string &help, std::vector<double> bounds, const std::string &labels = "");
+
+    void observe(double value);
+    void observe(std::chrono::steady_clock::duration duration); // Observed in seconds
+
+    const char * getType() const override;
+    void serialize(std::ostream &stream) const override;
+
+private:
+    std::vector<double> mBounds;
+    std::unique_ptr<std::atomic<uint64_t>[]> mBuckets; // Non-cumulative counts. The last bucket is +Inf
+    std::atomic<uint64_t> mCount;
+    std::atomic<double> mSum;
+};
+
+// Measures the time from construction to destruction
+class MetricsTimer {
+public:
+    MetricsTimer(MetricsHistogram &histogram);
+    ~MetricsTimer();
+
+private:
+    MetricsHistogram &mHistogram;
+    std::chrono::steady_clock::time_point mStart;
+};
+
+class Metrics {
+public:
+    Metrics();
+    Metrics(const Metrics &other) = delete;
+
+    MetricsGauge tcpParticipants;
+    MetricsGauge webParticipants;
+    MetricsGauge loadedTournaments;
+
+    MetricsGauge queuedMessages; // Websocket messages waiting to be written, summed over all participants
+    MetricsHistogram queueDepth; // Depth of a participant's write queue when a message is added
+    MetricsCounter sentMessages;
+    MetricsCounter droppedMessages; // Queued messages replaced by newer state
+
+    MetricsHistogram encodeSubscriptionDuration;
+    MetricsHistogram encodeChangesDuration;
+    MetricsHistogram encodeListingDuration;
+
+    MetricsGauge pendingQueries; // Database requests waiting for or running on a connection
+    MetricsHistogram queryWaitDuration; // Time spent waiting for a free connection
+    MetricsHistogram queryDuration;
+
+    MetricsGauge strandBacklog; // Hub requests waiting to run on a tournament strand
+    MetricsHistogram strandDelay;
+    MetricsCounter dispatchedActions;
+    MetricsCounter undoneActions;
+    MetricsCounter syncs;
+
+    std::string serialize() const;
+
+private:
+    std::vector<const Metric *> mMetrics; // Metrics sharing a name are adjacent
+};
+
+Metrics & metrics();
+
@@ -8,7 +8,6 @@
 #include "web/web_server.hpp"
 
 // TODO: Ensure strands are used correctly
-// TODO: Make sure changes are saved every x minutes
 
 TCPParticipant::TCPParticipant(boost::asio::io_context &context, std::shared_ptr<NetworkConnection> connection, WebServer &server, Database &database)
     : mStrand(context)
@@ -241,6 +240,30 @@ void TCPParticipant::asyncClockSync() {
 }
 
 void TCPParticipant::asyncTournamentSync() {
+    auto self = shared_from_this();
+    mServer.acquireTournament(mWebName, boost::asio::bind_executor(mStrand, [this, self](std::shared_ptr<LoadedTournament> loadedTournament) {
+        if (mClosePosted)
+            return;
+
+        mTournament = std::move(loadedTournament);
+        mTournament->setOwner(self);
+
+        // Tell the hub which actions are already applied. It answers with
+        // either a full sync or a resume followed by the missing actions
+        mTournament->getActionIds(boost::asio::bind_executor(mStrand, [this, self](std::vector<ClientActionId> actionIds) {
+            if (mClosePosted)
+                return;
+
+            auto message = std::make_shared<NetworkMessage>();
+            message->encodeWebActionList(actionIds);
+            deliver(std::move(message));
+
+            asyncTournamentUpload();
+        }));
+    }));
+}
+
+void TCPParticipant::asyncTournamentUpload() {
     mReadMessage = std::make_unique<NetworkMessage>();
     auto self = shared_from_this();
     mConnection->asyncRead(*mReadMessage, boost::asio::bind_executor(mStrand, [this, self](boost::system::error_code ec) {
@@ -254,6 +277,14 @@ void TCPParticipant::asyncTournamentSync() {
             return;
         }
 
+        if (mReadMessage->getType() == NetworkMessage::Type::WEB_RESUME) {
+            log_info().field("webName", mWebName).msg("Resuming tournament upload");
+            mTournament->setClockDiff(mClockDiff);
+            markSynced();
+            asyncTournamentListen();
+            return;
+        }
+
         if (mReadMessage->getType() != NetworkMessage::Type::SYNC) {
             close();
             return;
@@ -274,32 +305,29 @@ void TCPParticipant::asyncTournamentSync() {
             action.redo(tournament);
         }
 
-        mServer.acquireTournament(mWebName, boost::asio::bind_executor(mStrand, [this, wrapper, self](std::shared_ptr<LoadedTournament> loadedTournament) {
+        mTournament->sync(std::move(wrapper->tournament), std::move(wrapper->actionList), mClockDiff, boost::asio::bind_executor(mStrand, [this, self](bool success) {
             if (mClosePosted)
                 return;
 
-            mTournament = std::move(loadedTournament);
-            mTournament->setOwner(self);
-            mTournament->sync(std::move(wrapper->tournament), std::move(wrapper->actionList), mClockDiff, boost::asio::bind_executor(mStrand, [this, self](bool success) {
-                if (mClosePosted)
-                    return;
-
-                if (!success) {
-                    close();
-                    return;
-                }
+            if (!success) {
+                close();
+                return;
+            }
 
-                mDatabase.asyncSetSynced(mWebName, boost::asio::bind_executor(mStrand, [this, self](bool success) {
-                    if (mClosePosted)
-                        return;
+            markSynced();
+            asyncTournamentListen();
+        }));
+    }));
+}
 
-                    if (!success)
-                        log_warning().field("webName", mWebName).msg("Failed marking tournament as synced");
-                }));
+void TCPParticipant::markSynced() {
+    auto self = shared_from_this();
+    mDatabase.asyncSetSynced(mWebName, boost::asio::bind_executor(mStrand, [this, self](bool success) {
+        if (mClosePosted)
+            return;
 
-                asyncTournamentListen();
-            }));
-        }));
+        if (!success)
+            log_warning().field("webName", mWebName).msg("Failed marking tournament as synced");
     }));
 }
 
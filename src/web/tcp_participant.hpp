@@ -32,6 +32,8 @@ private:
     void asyncTournamentRegister();
     void asyncClockSync();
     void asyncTournamentSync();
+    void asyncTournamentUpload();
+    void markSynced();
     void asyncTournamentListen();
 
     void write();
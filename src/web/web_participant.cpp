@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/asio/bind_executor.hpp>
@@ -6,8 +7,11 @@
 
 #include "core/log.hpp"
 #include "core/network/network_connection.hpp"
+#include "web/constants/pages.hpp"
+#include "web/constants/websocket.hpp"
 #include "web/json_encoder.hpp"
 #include "web/loaded_tournament.hpp"
+#include "web/metrics.hpp"
 #include "web/web_participant.hpp"
 #include "web/web_server.hpp"
 
@@ -16,18 +20,55 @@
 
 WebParticipant::WebParticipant(boost::asio::io_context &context, std::shared_ptr<boost::beast::websocket::stream<boost::asio::ip::tcp::socket>> connection, WebServer &server, Database &database)
     : mContext(context)
-    , mStrand(mContext)
+    , mAcceptStrand(mContext)
+    , mStrand(&mAcceptStrand)
+    , mShardContext(nullptr)
     , mConnection(std::move(connection))
     , mServer(server)
     , mDatabase(database)
+    , mEncoding(MessageEncoding::JSON)
     , mClosePosted(false)
+    , mResyncRequested(false)
+    , mDroppedMessages(0)
 {
     mConnection->text(true);
 }
 
+WebParticipant::~WebParticipant() {
+    metrics().queuedMessages.decrement(mWriteQueue.size());
+}
+
+template <typename Handler>
+auto WebParticipant::bindStrand(Handler handler) {
+    boost::asio::io_context::strand &strand = *mStrand.load();
+    return boost::asio::bind_executor(strand, [this, &strand, handler](auto... args) {
+        boost::asio::io_context::strand &current = *mStrand.load();
+        if (&current == &strand) {
+            handler(args...);
+            return;
+        }
+
+        boost::asio::dispatch(current, [handler, args...]() { handler(args...); });
+    });
+}
+
+void WebParticipant::moveToShard() {
+    boost::asio::io_context &context = *mShardContext;
+    mShardContext = nullptr;
+
+    // The stream may only be used from one strand at a time. The read that
+    // delivered the subscription has completed, so only a pending write
+    // keeps the participant on the worker pool
+    if (&context == &mContext || !mWriteQueue.empty() || mShardStrand)
+        return;
+
+    mShardStrand.emplace(context);
+    mStrand.store(&*mShardStrand);
+}
+
 void WebParticipant::listen() {
     auto self = shared_from_this();
-    mConnection->async_read(mBuffer, boost::asio::bind_executor(mStrand, [this, self](boost::beast::error_code ec, std::size_t bytes_transferred) {
+    mConnection->async_read(mBuffer, bindStrand([this, self](boost::beast::error_code ec, std::size_t bytes_transferred) {
         if (mClosePosted)
             return;
 
@@ -43,6 +84,14 @@ void WebParticipant::listen() {
 
         mBuffer.consume(bytes_transferred);
 
+        if (mShardContext != nullptr) {
+            // Nothing may touch the stream from the accept strand once the
+            // participant has moved, so the next read is started from the shard
+            moveToShard();
+            boost::asio::dispatch(bindStrand([this, self]() { listen(); }));
+            return;
+        }
+
         listen();
     }));
 }
@@ -77,9 +126,9 @@ bool WebParticipant::parseMessage(const std::string &message) {
     boost::split(parts, message, boost::is_any_of(" "));
 
     if (parts[0] == "subscribeTournament") {
-        if (parts.size() != 2)
+        if (parts.size() < 2)
             return false;
-        return subscribeTournament(parts[1]);
+        return subscribeTournament(parts[1], std::vector<std::string>(std::next(parts.begin(), 2), parts.end()));
     }
 
     if (parts[0] == "subscribeCategory") {
@@ -100,6 +149,43 @@ bool WebParticipant::parseMessage(const std::string &message) {
         return subscribeTatami(parts[1]);
     }
 
+    // Multiple subscriptions are given as kind and id pairs, e.g. "subscribe category 1 tatami 0"
+    if (parts[0] == "subscribe") {
+        if (parts.size() < 3 || parts.size() % 2 == 0)
+            return false;
+        return subscribe(std::vector<std::string>(std::next(parts.begin()), parts.end()));
+    }
+
+    if (parts[0] == "unsubscribe") {
+        if (parts.size() < 3 || parts.size() % 2 == 0)
+            return false;
+        return unsubscribe(std::vector<std::string>(std::next(parts.begin()), parts.end()));
+    }
+
+    if (parts[0] == "listPlayers") {
+        if (parts.size() != 3)
+            return false;
+        return listPlayers(parts[1], parts[2]);
+    }
+
+    if (parts[0] == "listCategories") {
+        if (parts.size() != 3)
+            return false;
+        return listCategories(parts[1], parts[2]);
+    }
+
+    if (parts[0] == "getPlayers") {
+        if (parts.size() < 2)
+            return false;
+        return getPlayers(std::vector<std::string>(std::next(parts.begin()), parts.end()));
+    }
+
+    if (parts[0] == "getCategories") {
+        if (parts.size() < 2)
+            return false;
+        return getCategories(std::vector<std::string>(std::next(parts.begin()), parts.end()));
+    }
+
     if (parts[0] == "listTournaments") {
         if (parts.size() != 1)
             return false;
@@ -116,9 +202,27 @@ bool WebParticipant::parseMessage(const std::string &message) {
     return false;
 }
 
-bool WebParticipant::subscribeTournament(const std::string &webName) {
+bool WebParticipant::subscribeTournament(const std::string &webName, const std::vector<std::string> &options) {
+    bool lazy = false;
+    MessageEncoding encoding = MessageEncoding::JSON;
+    for (const auto &option : options) {
+        if (option == "lazy")
+            lazy = true;
+        else if (option == "msgpack")
+            encoding = MessageEncoding::MESSAGE_PACK;
+        else
+            return false;
+    }
+
+    // Applies to every message delivered from now on
+    mEncoding = encoding;
+
+    // Moved once the message has been handled
+    if (!mShardStrand)
+        mShardContext = &mServer.getTournamentContext(webName);
+
     auto self = shared_from_this();
-    mServer.getTournament(webName, boost::asio::bind_executor(mStrand, [this, self](std::shared_ptr<LoadedTournament> tournament) {
+    mServer.getTournament(webName, bindStrand([this, self, lazy](std::shared_ptr<LoadedTournament> tournament) {
         if (mClosePosted)
             return;
 
@@ -128,7 +232,11 @@ bool WebParticipant::subscribeTournament(const std::string &webName) {
             return;
         }
 
-        tournament->addParticipant(shared_from_this());
+        // The previous tournament can't unload while it still holds the participant
+        if (mTournament != nullptr)
+            mTournament->eraseParticipant(shared_from_this());
+
+        tournament->addParticipant(shared_from_this(), lazy);
         mTournament = std::move(tournament);
     }));
 
@@ -138,7 +246,7 @@ bool WebParticipant::subscribeTournament(const std::string &webName) {
 void WebParticipant::asyncClose(CloseCallback callback) {
     // Send close frame
     auto self = shared_from_this();
-    boost::asio::post(mStrand, [this, self, callback](){
+    boost::asio::post(bindStrand([this, self, callback](){
         mClosePosted = true;
         mConnection->async_close(boost::beast::websocket::close_code::service_restart, [this, self, callback](boost::system::error_code ec) {
             if (mTournament != nullptr) {
@@ -151,7 +259,7 @@ void WebParticipant::asyncClose(CloseCallback callback) {
 
             mServer.leave(shared_from_this(), callback);
         });
-    });
+    }));
 }
 
 void WebParticipant::forceClose() {
@@ -165,24 +273,105 @@ void WebParticipant::forceClose() {
     mServer.leave(shared_from_this(), []() {});
 }
 
-void WebParticipant::deliver(std::shared_ptr<JsonBuffer> message) {
+void WebParticipant::deliver(std::shared_ptr<const JsonBuffer> message, MessageKind kind, std::shared_ptr<const SubscriptionSet> target) {
     auto self = shared_from_this();
-    boost::asio::post(mStrand, [this, message, self](){
+    boost::asio::post(bindStrand([this, message, kind, target, self](){
         if (mClosePosted)
             return;
 
+        if (kind == MessageKind::TOURNAMENT_STATE)
+            mResyncRequested = false;
+        if (kind == MessageKind::TOURNAMENT_STATE || kind == MessageKind::SUBSCRIPTION_STATE)
+            dropSuperseded(kind, target);
+
         bool writeInProgress = !mWriteQueue.empty();
-        mWriteQueue.push(std::move(message));
+        mWriteQueue.push_back({std::move(message), mEncoding, kind, std::move(target)});
+        metrics().queuedMessages.increment();
+        metrics().queueDepth.observe(static_cast<double>(mWriteQueue.size()));
 
         if (!writeInProgress)
             write();
+        else
+            checkQueueLimits();
+    }));
+}
+
+void WebParticipant::dropSuperseded(MessageKind kind, const std::shared_ptr<const SubscriptionSet> &target) {
+    if (mWriteQueue.empty())
+        return;
+
+    // The front message is being written and must stay in place. Queued
+    // changes are kept since they also carry tournament wide updates the
+    // subscription state lacks
+    auto it = std::remove_if(std::next(mWriteQueue.begin()), mWriteQueue.end(), [kind, &target](const QueuedMessage &queued) {
+        if (kind == MessageKind::TOURNAMENT_STATE)
+            return queued.kind != MessageKind::RESPONSE;
+
+        if (queued.kind != MessageKind::SUBSCRIPTION_STATE)
+            return false;
+        return target != nullptr && queued.target != nullptr && *(queued.target) == *target;
     });
+
+    const size_t count = std::distance(it, mWriteQueue.end());
+    if (count == 0)
+        return;
+
+    mWriteQueue.erase(it, mWriteQueue.end());
+    mDroppedMessages += count;
+    metrics().queuedMessages.decrement(count);
+    metrics().droppedMessages.increment(count);
+}
+
+void WebParticipant::checkQueueLimits() {
+    // Pending updates are replaced by a fresh subscription once it arrives
+    if (mWriteQueue.size() > Constants::WEBSOCKET_QUEUE_SOFT_LIMIT && !mResyncRequested && mTournament != nullptr) {
+        mResyncRequested = true;
+        mTournament->resync(shared_from_this());
+    }
+
+    if (mWriteQueue.size() <= Constants::WEBSOCKET_QUEUE_HARD_LIMIT) {
+        mHardLimitTime.reset();
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!mHardLimitTime) {
+        mHardLimitTime = now;
+        return;
+    }
+
+    if (now - *mHardLimitTime < Constants::WEBSOCKET_QUEUE_HARD_LIMIT_TIME)
+        return;
+
+    log_warning().field("queueSize", mWriteQueue.size()).field("droppedMessages", mDroppedMessages).msg("Kicking web participant not keeping up with its messages");
+    kick();
+}
+
+void WebParticipant::kick() {
+    mClosePosted = true;
+
+    // Closing the socket aborts the write in progress. The stream itself is
+    // kept until the participant is destroyed since the write still refers to it
+    boost::system::error_code ec;
+    boost::beast::get_lowest_layer(*mConnection).close(ec);
+
+    if (mTournament != nullptr) {
+        mTournament->eraseParticipant(shared_from_this());
+        mTournament.reset();
+    }
+
+    mServer.leave(shared_from_this(), []() {});
 }
 
 void WebParticipant::write() {
     auto self = shared_from_this();
-    const auto &message = mWriteQueue.front();
-    mConnection->async_write(message->getBuffer(), boost::asio::bind_executor(mStrand, [this, self](boost::beast::error_code ec, std::size_t bytes_transferred) {
+    const auto &queued = mWriteQueue.front();
+    const auto &message = queued.message;
+
+    const bool binary = (queued.encoding == MessageEncoding::MESSAGE_PACK);
+    mConnection->binary(binary);
+    auto buffer = (binary ? message->getMessagePackBuffer() : message->getBuffer());
+    mConnection->async_write(buffer, bindStrand([this, self](boost::beast::error_code ec, std::size_t bytes_transferred) {
         if (mClosePosted)
             return;
 
@@ -191,7 +380,9 @@ void WebParticipant::write() {
             return;
         }
 
-        mWriteQueue.pop();
+        mWriteQueue.pop_front();
+        metrics().queuedMessages.decrement();
+        metrics().sentMessages.increment();
 
         if (!mWriteQueue.empty())
             write();
@@ -238,20 +429,124 @@ bool WebParticipant::subscribePlayer(const std::string &str) {
     return true;
 }
 
+bool WebParticipant::parseSubscriptions(const std::vector<std::string> &targets, SubscriptionSet &subscriptions) {
+    if (targets.size() / 2 > Constants::MAX_SUBSCRIPTIONS)
+        return false;
+
+    try {
+        for (size_t i = 0; i + 1 < targets.size(); i += 2) {
+            const std::string &kind = targets[i];
+            const std::string &id = targets[i+1];
+            if (kind == "category")
+                subscriptions.categories.insert(CategoryId(id));
+            else if (kind == "player")
+                subscriptions.players.insert(PlayerId(id));
+            else if (kind == "tatami")
+                subscriptions.tatamis.insert(std::stoul(id));
+            else
+                return false;
+        }
+    }
+    catch (const std::exception &e) {
+        return false;
+    }
+
+    return true;
+}
+
+bool WebParticipant::subscribe(const std::vector<std::string> &targets) {
+    if (mTournament == nullptr)
+        return false;
+
+    SubscriptionSet subscriptions;
+    if (!parseSubscriptions(targets, subscriptions))
+        return false;
+
+    mTournament->addSubscriptions(shared_from_this(), std::move(subscriptions));
+    return true;
+}
+
+bool WebParticipant::unsubscribe(const std::vector<std::string> &targets) {
+    if (mTournament == nullptr)
+        return false;
+
+    SubscriptionSet subscriptions;
+    if (!parseSubscriptions(targets, subscriptions))
+        return false;
+
+    mTournament->eraseSubscriptions(shared_from_this(), std::move(subscriptions));
+    return true;
+}
+
+bool WebParticipant::listPlayers(const std::string &from, const std::string &count) {
+    try {
+        if (mTournament == nullptr)
+            return false;
+        PlayerId id(from);
+        size_t pageSize = std::min<size_t>(std::stoul(count), Constants::MAX_PAGE_SIZE);
+        mTournament->listPlayers(shared_from_this(), id, pageSize);
+    }
+    catch (const std::exception &e) {
+        return false;
+    }
+
+    return true;
+}
+
+bool WebParticipant::listCategories(const std::string &from, const std::string &count) {
+    try {
+        if (mTournament == nullptr)
+            return false;
+        CategoryId id(from);
+        size_t pageSize = std::min<size_t>(std::stoul(count), Constants::MAX_PAGE_SIZE);
+        mTournament->listCategories(shared_from_this(), id, pageSize);
+    }
+    catch (const std::exception &e) {
+        return false;
+    }
+
+    return true;
+}
+
+bool WebParticipant::getPlayers(const std::vector<std::string> &ids) {
+    try {
+        if (mTournament == nullptr)
+            return false;
+        std::vector<PlayerId> playerIds;
+        for (const auto &str : ids)
+            playerIds.emplace_back(str);
+        mTournament->getPlayers(shared_from_this(), std::move(playerIds));
+    }
+    catch (const std::exception &e) {
+        return false;
+    }
+
+    return true;
+}
+
+bool WebParticipant::getCategories(const std::vector<std::string> &ids) {
+    try {
+        if (mTournament == nullptr)
+            return false;
+        std::vector<CategoryId> categoryIds;
+        for (const auto &str : ids)
+            categoryIds.emplace_back(str);
+        mTournament->getCategories(shared_from_this(), std::move(categoryIds));
+    }
+    catch (const std::exception &e) {
+        return false;
+    }
+
+    return true;
+}
+
 bool WebParticipant::listTournaments() {
     auto self = shared_from_this();
-    mDatabase.asyncListTournaments(boost::asio::bind_executor(mStrand, [this, self](bool success, std::vector<TournamentListing> pastTournaments, std::vector<TournamentListing> upcomingTournaments) {
+    mServer.getTournamentListing(bindStrand([this, self](std::shared_ptr<const JsonBuffer> listing) {
         if (mClosePosted)
             return;
 
-        JsonEncoder encoder;
-
-        if (!success) {
-            deliver(encoder.encodeTournamentListingFailMessage());
-            return;
-        }
-
-        deliver(encoder.encodeTournamentListingMessage(pastTournaments, upcomingTournaments));
+        deliver(std::move(listing));
     }));
 
     return true;
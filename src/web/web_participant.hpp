@@ -1,41 +1,79 @@
 #pragma once
 
+#include <atomic>
 #include <boost/asio/io_context_strand.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
-#include <queue>
+#include <chrono>
+#include <deque>
+#include <optional>
 
 class WebServer;
 class LoadedTournament;
 class NetworkConnection;
 class JsonBuffer;
 class Database;
+struct SubscriptionSet;
+
+enum class MessageEncoding {
+    JSON,
+    MESSAGE_PACK, // Binary frames, chosen by the client when subscribing
+};
+
+// Determines which pending messages a newly delivered message makes obsolete
+enum class MessageKind {
+    RESPONSE, // Reply to a request. Never dropped
+    TOURNAMENT_STATE, // Full tournament subscription. Replaces every pending update
+    SUBSCRIPTION_STATE, // Full state of subscribed targets. Replaces pending states for the same targets
+    CHANGES, // Incremental update for the subscribed targets
+};
 
 class WebParticipant : public std::enable_shared_from_this<WebParticipant> {
 public:
     WebParticipant(boost::asio::io_context &context, std::shared_ptr<boost::beast::websocket::stream<boost::asio::ip::tcp::socket>> connection, WebServer &server, Database &database);
+    ~WebParticipant();
 
     typedef std::function<void()> CloseCallback;
     void asyncClose(CloseCallback callback);
     void listen();
-    void deliver(std::shared_ptr<JsonBuffer> message);
+    // Subscription states and changes carry the targets they were encoded for
+    void deliver(std::shared_ptr<const JsonBuffer> message, MessageKind kind = MessageKind::RESPONSE, std::shared_ptr<const SubscriptionSet> target = nullptr);
 
 private:
+    // Binds the handler to the participant's strand. Handlers bound before the
+    // participant moved to its tournament's shard are forwarded to the shard strand
+    template <typename Handler>
+    auto bindStrand(Handler handler);
+    void moveToShard();
+
     void forceClose();
+    void kick(); // Closes the connection while a write may be in progress
     bool parseMessage(const std::string &message);
     bool validateMessage(const std::string &message);
 
-    bool subscribeTournament(const std::string &webName);
+    bool subscribeTournament(const std::string &webName, const std::vector<std::string> &options);
     bool subscribeCategory(const std::string &id);
     bool subscribePlayer(const std::string &id);
     bool subscribeTatami(const std::string &index);
+    bool parseSubscriptions(const std::vector<std::string> &targets, SubscriptionSet &subscriptions);
+    bool subscribe(const std::vector<std::string> &targets);
+    bool unsubscribe(const std::vector<std::string> &targets);
+    bool listPlayers(const std::string &from, const std::string &count);
+    bool listCategories(const std::string &from, const std::string &count);
+    bool getPlayers(const std::vector<std::string> &ids);
+    bool getCategories(const std::vector<std::string> &ids);
     bool listTournaments();
     bool clock();
 
     void write();
+    void dropSuperseded(MessageKind kind, const std::shared_ptr<const SubscriptionSet> &target);
+    void checkQueueLimits();
 
     boost::asio::io_context& mContext;
-    boost::asio::io_context::strand mStrand;
+    boost::asio::io_context::strand mAcceptStrand; // Used until the participant moves to a tournament shard
+    std::optional<boost::asio::io_context::strand> mShardStrand; // Emplaced at most once
+    std::atomic<boost::asio::io_context::strand *> mStrand; // Guards the participant state and the stream
+    boost::asio::io_context *mShardContext; // Shard of the tournament being subscribed to. Cleared once the participant has moved
     std::shared_ptr<boost::beast::websocket::stream<boost::asio::ip::tcp::socket>> mConnection;
     boost::beast::multi_buffer mBuffer;
 
@@ -43,7 +81,18 @@ private:
     Database &mDatabase;
 
     std::shared_ptr<LoadedTournament> mTournament;
-    std::queue<std::shared_ptr<JsonBuffer>> mWriteQueue;
+    struct QueuedMessage {
+        std::shared_ptr<const JsonBuffer> message;
+        MessageEncoding encoding;
+        MessageKind kind;
+        std::shared_ptr<const SubscriptionSet> target;
+    };
+
+    std::deque<QueuedMessage> mWriteQueue; // The front message is being written
+    MessageEncoding mEncoding;
     bool mClosePosted;
+    bool mResyncRequested; // Whether a fresh subscription was requested to replace the queued updates
+    std::optional<std::chrono::steady_clock::time_point> mHardLimitTime; // Time the queue went over the hard limit
+    size_t mDroppedMessages;
 };
 
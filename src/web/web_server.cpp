@@ -1,15 +1,24 @@
+#include <algorithm>
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/dispatch.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
+#include <boost/beast/http.hpp>
 #include <boost/bind.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <functional>
+#ifdef __linux__
+#include <pthread.h>
+#endif
 
 #include "core/id.hpp"
 #include "core/log.hpp"
 #include "core/network/network_message.hpp"
 #include "core/network/plain_socket.hpp"
 #include "core/web/web_types.hpp"
+#include "web/constants/tournaments.hpp"
+#include "web/constants/websocket.hpp"
+#include "web/metrics.hpp"
 #include "web/web_server.hpp"
 
 using boost::asio::ip::tcp;
@@ -18,13 +27,28 @@ WebServer::WebServer(const Config &config)
     : mConfig(config)
     , mContext(config.workers)
     , mStrand(mContext)
+    , mUnloadTimer(mContext)
+    , mListingVersion(0)
     , mTCPEndpoint(tcp::v4(), config.port)
     , mTCPAcceptor(mContext, mTCPEndpoint)
     , mWebEndpoint(tcp::v4(), config.webPort)
     , mWebAcceptor(mContext, mWebEndpoint)
+    , mStorageContext(Constants::STORAGE_THREADS)
 {
+    mStorageWork.emplace(boost::asio::make_work_guard(mStorageContext));
+
+    for (size_t i = 0; i < config.tournamentShards; ++i) {
+        mShards.push_back(std::make_unique<boost::asio::io_context>(1));
+        mShardWork.push_back(boost::asio::make_work_guard(*mShards.back()));
+    }
+
     tcpAccept();
     webAccept();
+
+    if (config.metricsPort != 0) {
+        mMetricsAcceptor.emplace(mContext, tcp::endpoint(boost::asio::ip::address_v4::loopback(), config.metricsPort));
+        metricsAccept();
+    }
 }
 
 void WebServer::run() {
@@ -41,7 +65,12 @@ void WebServer::run() {
     }
 
     // Launch database
-    mDatabase = std::make_unique<Database>(mContext, mConfig.postgres);
+    mDatabase = std::make_unique<Database>(mContext, mConfig.postgres, mConfig.databaseConnections);
+
+    scheduleUnload();
+
+    for (size_t i = 0; i < Constants::STORAGE_THREADS; ++i)
+        mStorageThreads.emplace_back([this]() { mStorageContext.run(); });
 
     // Launch worker threads
     log_info().field("threadCount", mConfig.workers).msg("Launching worker threads");
@@ -52,10 +81,57 @@ void WebServer::run() {
     // log_info().msg("Waiting for clients");
     // mDatabase->asyncRegisterUser("svendcsvendsen@gmail.com", "password", [this](UserRegistrationResponse response, const WebToken &token) {});
 
+    if (!mShards.empty())
+        launchShards();
+
     work();
 
     for (std::thread &thread : mThreads)
         thread.join();
+
+    if (!mShards.empty()) {
+        // Let the shards finish saving, then run the callbacks they posted back
+        // after the workers ran out of work
+        mShardWork.clear();
+        for (std::thread &thread : mShardThreads)
+            thread.join();
+
+        mContext.restart();
+        mContext.run();
+    }
+
+    // Saves keep their tournament's context running until done, so only
+    // journal records may be left to write
+    mStorageWork.reset();
+    for (std::thread &thread : mStorageThreads)
+        thread.join();
+}
+
+void WebServer::launchShards() {
+    log_info().field("shardCount", mShards.size()).msg("Launching tournament shards");
+    for (size_t i = 0; i < mShards.size(); ++i) {
+        boost::asio::io_context &shard = *mShards[i];
+        mShardThreads.emplace_back([&shard]() { shard.run(); });
+
+#ifdef __linux__
+        // Keep each shard on its own core so that the tournaments it owns stay in that core's cache
+        const unsigned int cores = std::thread::hardware_concurrency();
+        if (cores == 0)
+            continue;
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(i % cores, &cpus);
+        if (pthread_setaffinity_np(mShardThreads.back().native_handle(), sizeof(cpu_set_t), &cpus) != 0)
+            log_warning().field("shard", i).msg("Failed pinning tournament shard to a core");
+#endif
+    }
+}
+
+boost::asio::io_context & WebServer::getTournamentContext(const std::string &webName) {
+    if (mShards.empty())
+        return mContext;
+    return *mShards[std::hash<std::string>()(webName) % mShards.size()];
 }
 
 void WebServer::saveTournaments() {
@@ -88,6 +164,9 @@ void WebServer::quit() {
     boost::asio::post(mStrand, [this]() {
         mTCPAcceptor.close();
         mWebAcceptor.close();
+        if (mMetricsAcceptor)
+            mMetricsAcceptor->close();
+        mUnloadTimer.cancel();
 
         // Close all TCP participants
         if (!mParticipants.empty()) {
@@ -118,6 +197,7 @@ void WebServer::tcpAccept() {
                 auto participant = std::make_shared<TCPParticipant>(mContext, std::move(connection), *this, *mDatabase);
                 participant->asyncAuth();
                 mParticipants.insert(std::move(participant));
+                metrics().tcpParticipants.set(mParticipants.size());
             }));
         }
 
@@ -135,6 +215,14 @@ void WebServer::webAccept() {
         else {
             auto connection = std::make_shared<boost::beast::websocket::stream<boost::asio::ip::tcp::socket>>(std::move(socket));
 
+            boost::beast::websocket::permessage_deflate deflate;
+            deflate.server_enable = true;
+            deflate.server_max_window_bits = Constants::WEBSOCKET_DEFLATE_WINDOW_BITS;
+            deflate.client_max_window_bits = Constants::WEBSOCKET_DEFLATE_WINDOW_BITS;
+            deflate.compLevel = Constants::WEBSOCKET_DEFLATE_LEVEL;
+            deflate.memLevel = Constants::WEBSOCKET_DEFLATE_MEM_LEVEL;
+            connection->set_option(deflate);
+
             connection->async_accept(boost::asio::bind_executor(mStrand, [this, connection](boost::beast::error_code ec) {
                 if (ec) {
                     if (ec.value() != boost::system::errc::operation_canceled && ec.value() != boost::system::errc::bad_file_descriptor)
@@ -147,6 +235,7 @@ void WebServer::webAccept() {
                 auto participant = std::make_shared<WebParticipant>(mContext, std::move(connection), *this, *mDatabase);
                 participant->listen();
                 mWebParticipants.insert(std::move(participant));
+                metrics().webParticipants.set(mWebParticipants.size());
             }));
         }
 
@@ -155,10 +244,98 @@ void WebServer::webAccept() {
     });
 }
 
+// State of a single metrics request, kept alive by its handlers
+struct MetricsRequest {
+    MetricsRequest(tcp::socket socket)
+        : socket(std::move(socket))
+    {}
+
+    tcp::socket socket;
+    boost::beast::flat_buffer buffer;
+    boost::beast::http::request<boost::beast::http::empty_body> request;
+    boost::beast::http::response<boost::beast::http::string_body> response;
+};
+
+void WebServer::metricsAccept() {
+    mMetricsAcceptor->async_accept([this](boost::system::error_code ec, tcp::socket socket) {
+        if (ec) {
+            if (ec.value() != boost::system::errc::operation_canceled && ec.value() != boost::system::errc::bad_file_descriptor)
+                log_error().field("message", ec.message()).msg("Received error code in metrics async_accept");
+        }
+        else {
+            auto state = std::make_shared<MetricsRequest>(std::move(socket));
+            boost::beast::http::async_read(state->socket, state->buffer, state->request, [state](boost::beast::error_code ec, std::size_t bytes_transferred) {
+                if (ec)
+                    return;
+
+                auto &response = state->response;
+                response.version(state->request.version());
+                response.keep_alive(false);
+
+                if (state->request.target() == "/metrics") {
+                    response.result(boost::beast::http::status::ok);
+                    response.set(boost::beast::http::field::content_type, "text/plain; version=0.0.4");
+                    response.body() = metrics().serialize();
+                }
+                else {
+                    response.result(boost::beast::http::status::not_found);
+                }
+
+                response.prepare_payload();
+                boost::beast::http::async_write(state->socket, response, [state](boost::beast::error_code ec, std::size_t bytes_transferred) {
+                    boost::system::error_code ignored;
+                    state->socket.shutdown(tcp::socket::shutdown_send, ignored);
+                });
+            });
+        }
+
+        if (mMetricsAcceptor->is_open())
+            metricsAccept();
+    });
+}
+
+void WebServer::getTournamentListing(TournamentListingCallback callback) {
+    boost::asio::dispatch(mStrand, [this, callback]() {
+        const bool expired = (std::chrono::steady_clock::now() - mListingTime > Constants::LISTING_TTL);
+        if (mListing != nullptr && !expired && mListingVersion == mDatabase->getListingVersion()) {
+            boost::asio::dispatch(mContext, std::bind(callback, mListing));
+            return;
+        }
+
+        // Requests arriving while the listing is queried share its result
+        mListingCallbacks.push_back(callback);
+        if (mListingCallbacks.size() > 1)
+            return;
+
+        const uint64_t version = mDatabase->getListingVersion();
+        mDatabase->asyncListTournaments([this, version](bool success, std::vector<TournamentListing> pastTournaments, std::vector<TournamentListing> upcomingTournaments) {
+            JsonEncoder encoder;
+            std::shared_ptr<const JsonBuffer> listing;
+            if (success)
+                listing = encoder.encodeTournamentListingMessage(pastTournaments, upcomingTournaments);
+            else
+                listing = encoder.encodeTournamentListingFailMessage();
+
+            boost::asio::dispatch(mStrand, [this, success, version, listing]() {
+                if (success) {
+                    mListing = listing;
+                    mListingVersion = version;
+                    mListingTime = std::chrono::steady_clock::now();
+                }
+
+                for (const auto &callback : mListingCallbacks)
+                    boost::asio::dispatch(mContext, std::bind(callback, listing));
+                mListingCallbacks.clear();
+            });
+        });
+    });
+}
+
 void WebServer::leave(std::shared_ptr<TCPParticipant> participant, LeaveCallback callback) {
     boost::asio::post(mStrand, [this, participant, callback]() {
         log_info().msg("TCP Participant Left");
         mParticipants.erase(participant);
+        metrics().tcpParticipants.set(mParticipants.size());
         boost::asio::post(mContext, callback);
     });
 }
@@ -167,6 +344,7 @@ void WebServer::leave(std::shared_ptr<WebParticipant> participant, LeaveCallback
     boost::asio::post(mStrand, [this, participant, callback]() {
         log_info().msg("Web Participant Left");
         mWebParticipants.erase(participant);
+        metrics().webParticipants.set(mWebParticipants.size());
         boost::asio::post(mContext, callback);
     });
 }
@@ -179,20 +357,121 @@ void WebServer::work() {
     mContext.run();
 }
 
+void WebServer::scheduleUnload() {
+    mUnloadTimer.expires_after(Constants::UNLOAD_INTERVAL);
+    mUnloadTimer.async_wait(boost::asio::bind_executor(mStrand, [this](boost::system::error_code ec) {
+        if (ec)
+            return;
+
+        unloadTournaments();
+        compactJournals();
+        scheduleUnload();
+    }));
+}
+
+void WebServer::unloadTournaments() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto idleTimeout = std::chrono::minutes(mConfig.tournamentIdleTimeout);
+    const size_t memoryBudget = mConfig.tournamentMemoryBudget * 1024 * 1024;
+
+    // Least recently used first
+    std::vector<std::pair<std::chrono::steady_clock::time_point, std::string>> tournaments;
+    size_t memoryUsage = 0;
+    for (const auto &p : mLoadedTournaments) {
+        tournaments.emplace_back(p.second->getLastAccess(), p.first);
+        memoryUsage += p.second->getMemoryEstimate();
+    }
+
+    std::sort(tournaments.begin(), tournaments.end());
+
+    for (const auto &[lastAccess, webName] : tournaments) {
+        const auto idleTime = now - lastAccess;
+        if (idleTime < Constants::MIN_UNLOAD_IDLE_TIME)
+            break;
+        if (idleTime < idleTimeout && memoryUsage <= memoryBudget)
+            break;
+
+        // Tournaments in use are skipped by unloadTournament, so the budget
+        // may still be exceeded until the next check
+        auto tournament = mLoadedTournaments.at(webName);
+        memoryUsage -= std::min(memoryUsage, tournament->getMemoryEstimate());
+        unloadTournament(webName, std::move(tournament));
+    }
+}
+
+void WebServer::compactJournals() {
+    for (const auto &p : mLoadedTournaments)
+        p.second->compactJournal();
+}
+
+void WebServer::unloadTournament(const std::string &webName, std::shared_ptr<LoadedTournament> tournament) {
+    const auto lastAccess = tournament->getLastAccess();
+    tournament->prepareUnload([this, webName, tournament, lastAccess](bool success) {
+        if (!success)
+            return;
+
+        boost::asio::dispatch(mStrand, [this, webName, tournament, lastAccess]() {
+            auto it = mLoadedTournaments.find(webName);
+            if (it == mLoadedTournaments.end() || it->second != tournament)
+                return;
+
+            // Handed out by getTournament or acquireTournament while saving
+            if (tournament->getLastAccess() != lastAccess)
+                return;
+
+            log_info().field("webName", webName).msg("Unloading tournament");
+            mLoadedTournaments.erase(it);
+            metrics().loadedTournaments.set(mLoadedTournaments.size());
+        });
+    });
+}
+
 void WebServer::acquireTournament(const std::string &webName, AcquireTournamentCallback callback) {
     boost::asio::dispatch(mStrand, [this, webName, callback]() {
         auto it = mLoadedTournaments.find(webName);
-        std::shared_ptr<LoadedTournament> tournament;
         if (it != mLoadedTournaments.end()) {
             // TODO: Kick existing participant if any
-            tournament = it->second;
-        }
-        else {
-            tournament = std::make_shared<LoadedTournament>(webName, mConfig.dataDirectory, mContext, *mDatabase);
-            mLoadedTournaments.insert({webName, tournament});
+            it->second->touch();
+            boost::asio::dispatch(mContext, std::bind(callback, it->second));
+            return;
         }
 
-        boost::asio::dispatch(mContext, std::bind(callback, std::move(tournament)));
+        // Load the saved tournament, if any, so that the hub only has to
+        // upload the actions the web server is missing
+        mDatabase->asyncGetSaveStatus(webName, boost::asio::bind_executor(mStrand, [this, webName, callback](bool isSaved) {
+            auto tournament = std::make_shared<LoadedTournament>(webName, mConfig.dataDirectory, getTournamentContext(webName), mStorageContext, *mDatabase);
+            if (!isSaved) {
+                auto it = mLoadedTournaments.find(webName);
+                if (it != mLoadedTournaments.end()) { // The tournament was created by someone else while querying
+                    it->second->touch();
+                    boost::asio::dispatch(mContext, std::bind(callback, it->second));
+                    return;
+                }
+
+                mLoadedTournaments.insert({webName, tournament});
+                metrics().loadedTournaments.set(mLoadedTournaments.size());
+                boost::asio::dispatch(mContext, std::bind(callback, std::move(tournament)));
+                return;
+            }
+
+            tournament->load(boost::asio::bind_executor(mStrand, [this, webName, tournament, callback](bool success) {
+                auto it = mLoadedTournaments.find(webName);
+                if (it != mLoadedTournaments.end()) { // The tournament was loaded by someone else
+                    it->second->touch();
+                    boost::asio::dispatch(mContext, std::bind(callback, it->second));
+                    return;
+                }
+
+                // A tournament failing to load is replaced by the sync from the hub
+                if (!success)
+                    log_warning().field("webName", webName).msg("Failed loading tournament. Waiting for sync");
+
+                mLoadedTournaments.insert({webName, tournament});
+
+                metrics().loadedTournaments.set(mLoadedTournaments.size());
+                boost::asio::dispatch(mContext, std::bind(callback, tournament));
+            }));
+        }));
     });
 }
 
@@ -200,6 +479,7 @@ void WebServer::getTournament(const std::string &webName, GetTournamentCallback
     boost::asio::dispatch(mStrand, [this, webName, callback]() {
         auto it = mLoadedTournaments.find(webName);
         if (it != mLoadedTournaments.end()) {
+            it->second->touch();
             boost::asio::dispatch(mContext, std::bind(callback, it->second));
             return;
         }
@@ -210,16 +490,18 @@ void WebServer::getTournament(const std::string &webName, GetTournamentCallback
                 return;
             }
 
-            auto tournament = std::make_shared<LoadedTournament>(webName, mConfig.dataDirectory, mContext, *mDatabase);
+            auto tournament = std::make_shared<LoadedTournament>(webName, mConfig.dataDirectory, getTournamentContext(webName), mStorageContext, *mDatabase);
             tournament->load(boost::asio::bind_executor(mStrand, [this, webName, tournament, callback](bool success) {
                 auto it = mLoadedTournaments.find(webName);
                 if (it != mLoadedTournaments.end()) { // The tournament was loaded by someone else
+                    it->second->touch();
                     boost::asio::dispatch(mContext, std::bind(callback, it->second));
                     return;
                 }
 
                 if (success) {
                     mLoadedTournaments.insert({webName, tournament});
+                    metrics().loadedTournaments.set(mLoadedTournaments.size());
                     boost::asio::dispatch(mContext, std::bind(callback, tournament));
                     return;
                 }
@@ -1,12 +1,16 @@
 #pragma once
 
+#include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context_strand.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
+#include <optional>
 #include <thread>
 #include <vector>
 
 #include "core/core.hpp"
+#include "web/json_encoder.hpp"
 #include "web/config.hpp"
 #include "web/database.hpp"
 #include "web/loaded_tournament.hpp"
@@ -31,16 +35,36 @@ public:
     typedef std::function<void (bool)> SaveTournamentCallback;
     void saveTournament(std::shared_ptr<LoadedTournament> tournament, SaveTournamentCallback);
 
+    // Gets the encoded tournament listing. It is cached until the listing
+    // changes in the database or the cache expires
+    typedef std::function<void (std::shared_ptr<const JsonBuffer>)> TournamentListingCallback;
+    void getTournamentListing(TournamentListingCallback callback);
+
+    // Gets the context the tournament runs on. With sharding enabled each
+    // tournament is pinned to one single-threaded context by its web name.
+    // Web participants move onto it once they subscribe to the tournament
+    boost::asio::io_context & getTournamentContext(const std::string &webName);
+
     typedef std::function<void ()> LeaveCallback;
     void leave(std::shared_ptr<TCPParticipant> participant, LeaveCallback callback);
     void leave(std::shared_ptr<WebParticipant> participant, LeaveCallback callback);
 
 private:
     void work();
+    void launchShards();
     void tcpAccept();
     void assignWebName(std::shared_ptr<TCPParticipant> participant, std::string webName);
 
     void webAccept();
+    void metricsAccept();
+
+    // Unloads tournaments that have been idle for too long, then the least
+    // recently used ones until the memory budget is met. Journals of the
+    // remaining tournaments are compacted on the same timer
+    void scheduleUnload();
+    void unloadTournaments();
+    void unloadTournament(const std::string &webName, std::shared_ptr<LoadedTournament> tournament);
+    void compactJournals();
 
     void saveTournaments(); // Used as callback when shutting down
     void closeWebParticipants(); // Used as callback when shutting down
@@ -48,6 +72,7 @@ private:
     Config mConfig;
     boost::asio::io_context mContext;
     boost::asio::io_context::strand mStrand;
+    boost::asio::steady_timer mUnloadTimer;
 
     boost::asio::ip::tcp::endpoint mTCPEndpoint;
     boost::asio::ip::tcp::acceptor mTCPAcceptor;
@@ -55,11 +80,28 @@ private:
     boost::asio::ip::tcp::endpoint mWebEndpoint;
     boost::asio::ip::tcp::acceptor mWebAcceptor;
 
+    std::optional<boost::asio::ip::tcp::acceptor> mMetricsAcceptor; // Only bound to localhost
+
     std::unordered_set<std::shared_ptr<TCPParticipant>> mParticipants;
     std::unordered_set<std::shared_ptr<WebParticipant>> mWebParticipants;
     std::unordered_map<std::string, std::shared_ptr<LoadedTournament>> mLoadedTournaments;
 
+    std::shared_ptr<const JsonBuffer> mListing;
+    uint64_t mListingVersion; // Database listing version the cached listing was read at
+    std::chrono::steady_clock::time_point mListingTime;
+    std::vector<TournamentListingCallback> mListingCallbacks; // Waiting for the listing query in progress
+
     std::vector<std::thread> mThreads;
+
+    typedef boost::asio::executor_work_guard<boost::asio::io_context::executor_type> WorkGuard;
+    std::vector<std::unique_ptr<boost::asio::io_context>> mShards;
+    std::vector<WorkGuard> mShardWork; // Keeps the shards running while idle until shutdown
+    std::vector<std::thread> mShardThreads;
+
+    // Journal records and save-files are written here, off the worker and shard threads
+    boost::asio::io_context mStorageContext;
+    std::optional<WorkGuard> mStorageWork;
+    std::vector<std::thread> mStorageThreads;
     std::unique_ptr<Database> mDatabase;
 };
 
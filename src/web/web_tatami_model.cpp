@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "core/draw_systems/draw_system.hpp"
 #include "core/log.hpp"
 #include "core/rulesets/ruleset.hpp"
@@ -16,19 +18,28 @@ WebTatamiModel::WebTatamiModel(const TournamentStore &tournament, TatamiLocation
     flush();
 }
 
-const std::list<CombinedId>& WebTatamiModel::getMatches() const {
+const std::vector<CombinedId>& WebTatamiModel::getMatches() const {
     assert(!mResetting);
     return mMatches;
 }
 
-const std::list<CombinedId>& WebTatamiModel::getInsertedMatches() const {
+const std::vector<CombinedId>& WebTatamiModel::getInsertedMatches() const {
     assert(!mResetting);
     return mInsertedMatches;
 }
 
+const std::vector<CombinedId>& WebTatamiModel::getChangedMatches() const {
+    assert(!mResetting);
+    return mChangedMatches;
+}
+
 void WebTatamiModel::changeMatches(const TournamentStore &tournament, CategoryId categoryId, const std::vector<MatchId> &matchIds) {
-    if (mResetting)
+    if (mResetting) {
+        // Any match may be displayed once the model is reloaded
+        for (auto matchId: matchIds)
+            mUpdatedMatches.emplace_back(categoryId, matchId);
         return;
+    }
 
     const auto &category = mTournament.getCategory(categoryId);
 
@@ -38,36 +49,18 @@ void WebTatamiModel::changeMatches(const TournamentStore &tournament, CategoryId
         if (it == mLoadedMatches.end())
             continue;
 
+        mUpdatedMatches.push_back(combinedId);
+
         const auto loadingTime = it->second;
         const auto &match = category.getMatch(matchId);
 
-        bool wasFinished = (mUnfinishedLoadedMatchesSet.find(combinedId) == mUnfinishedLoadedMatchesSet.end());
+        bool wasFinished = (mUnfinishedLoadedMatches.find(loadingTime) == mUnfinishedLoadedMatches.end());
         bool isFinished = (match.getStatus() == MatchStatus::FINISHED);
 
-        if (isFinished && !wasFinished) {
-            // Remove from unfinished matches
-            for (auto i = mUnfinishedLoadedMatches.begin(); i != mUnfinishedLoadedMatches.end(); ++i) {
-                const CombinedId &curId = i->first;
-                if (curId == combinedId) {
-                    mUnfinishedLoadedMatches.erase(i);
-                    break;
-                }
-            }
-
-            mUnfinishedLoadedMatchesSet.erase(combinedId);
-        }
-        else if(!isFinished && wasFinished) {
-            // Add to unfinished matches
-            auto i = mUnfinishedLoadedMatches.begin();
-            for (;i != mUnfinishedLoadedMatches.end(); ++i) {
-                auto curLoadingTime = i->second;
-                if (curLoadingTime > loadingTime)
-                    break;
-            }
-
-            mUnfinishedLoadedMatches.insert(i, std::pair(combinedId, loadingTime));
-            mUnfinishedLoadedMatchesSet.insert(combinedId);
-        }
+        if (isFinished && !wasFinished)
+            mUnfinishedLoadedMatches.erase(loadingTime);
+        else if (!isFinished && wasFinished)
+            mUnfinishedLoadedMatches.emplace(loadingTime, combinedId);
     }
 }
 
@@ -99,6 +92,7 @@ void WebTatamiModel::clearChanges() {
     assert(!mResetting);
 
     mInsertedMatches.clear();
+    mChangedMatches.clear();
     mMatchesChanged = false;
     mChanged = false;
 }
@@ -110,7 +104,6 @@ void WebTatamiModel::reset() {
     mLoadedGroups.clear();
 
     mUnfinishedLoadedMatches.clear();
-    mUnfinishedLoadedMatchesSet.clear();
 
     mResetting = false;
 
@@ -140,8 +133,7 @@ void WebTatamiModel::loadBlocks() {
             if (match.getStatus() == MatchStatus::FINISHED)
                 continue;
 
-            mUnfinishedLoadedMatches.emplace_back(combinedId, loadingTime);
-            mUnfinishedLoadedMatchesSet.insert(combinedId);
+            mUnfinishedLoadedMatches.emplace(loadingTime, combinedId);
         }
     }
 }
@@ -151,54 +143,37 @@ void WebTatamiModel::flush() {
         reset();
     loadBlocks();
 
-    // Update matches and inserted matches to be the front of mUnfinishedMatches
-    size_t i = 0;
-
-    auto it = mMatches.begin();
-    auto jt = mUnfinishedLoadedMatches.begin();
-    while (true) {
-        if (it == mMatches.end() && jt == mUnfinishedLoadedMatches.end())
-            break;
-
-        if (it == mMatches.end() && i == DISPLAY_COUNT)
-            break;
+    // The displayed matches are the first unfinished ones in loading order
+    std::vector<CombinedId> matches;
+    for (auto it = mUnfinishedLoadedMatches.begin(); it != mUnfinishedLoadedMatches.end() && matches.size() < DISPLAY_COUNT; ++it)
+        matches.push_back(it->second);
 
-        // Copy matches from mUnfinishedMatches
-        if (it == mMatches.end() && jt != mUnfinishedLoadedMatches.end()) {
-            const CombinedId &combinedId = jt->first;
-            mMatches.insert(it, combinedId);
+    if (matches != mMatches) {
+        for (const auto &combinedId : matches) {
+            if (std::find(mMatches.begin(), mMatches.end(), combinedId) != mMatches.end())
+                continue;
+            if (std::find(mInsertedMatches.begin(), mInsertedMatches.end(), combinedId) != mInsertedMatches.end())
+                continue;
             mInsertedMatches.push_back(combinedId);
-            mMatchesChanged = true;
-            ++i;
-            ++jt;
-            continue;
         }
 
-        if (jt == mUnfinishedLoadedMatches.end() || i >= DISPLAY_COUNT) { // This match should not be loaded
-            auto next = std::next(it);
-            mMatches.erase(it);
-            it = next;
-            mMatchesChanged = true;
-            continue;
-        }
+        mMatches = std::move(matches);
+        mMatchesChanged = true;
+    }
 
-        // Both iterators != end
-        const CombinedId &combinedId = jt->first;
-        if (*it == combinedId) {
-            // Matches are the same. Continue
-            ++it;
-            ++i;
-            ++jt;
-        }
-        else {
-            // Matches are different. Erase from matches and continue
-            auto next = std::next(it);
-            mMatches.erase(it);
-            it = next;
-            mMatchesChanged = true;
+    // Inserted matches are sent in full, so only displayed matches that were
+    // already present need to be reported as changed
+    for (const auto &combinedId : mUpdatedMatches) {
+        if (std::find(mMatches.begin(), mMatches.end(), combinedId) == mMatches.end())
             continue;
-        }
+        if (std::find(mInsertedMatches.begin(), mInsertedMatches.end(), combinedId) != mInsertedMatches.end())
+            continue;
+        if (std::find(mChangedMatches.begin(), mChangedMatches.end(), combinedId) != mChangedMatches.end())
+            continue;
+        mChangedMatches.push_back(combinedId);
     }
+
+    mUpdatedMatches.clear();
 }
 
 bool WebTatamiModel::matchesChanged() const {
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "core/core.hpp"
@@ -14,11 +17,13 @@ public:
     static constexpr unsigned int DISPLAY_COUNT = 5; // The minimum number of matches to keep loaded
 
     WebTatamiModel(const TournamentStore &tournament, TatamiLocation tatami);
-    const std::list<CombinedId>& getMatches() const;
-    const std::list<CombinedId>& getInsertedMatches() const;
+    const std::vector<CombinedId>& getMatches() const;
+    const std::vector<CombinedId>& getInsertedMatches() const;
+    const std::vector<CombinedId>& getChangedMatches() const; // Displayed matches changed since the last clear. Excludes inserted matches
     bool matchesChanged() const;
     bool changed() const;
 
+    // Only called with the matches located on this tatami
     void changeMatches(const TournamentStore &tournament, CategoryId categoryId, const std::vector<MatchId> &matchIds);
     void changeTatamis(const TournamentStore &tournament, const std::vector<BlockLocation> &locations, const std::vector<std::pair<CategoryId, MatchType>> &blocks);
 
@@ -37,12 +42,13 @@ private:
     std::unordered_map<CombinedId, size_t> mLoadedMatches; // Matches loaded and their loading time
     std::unordered_set<PositionId> mLoadedGroups; // Blocks loaded
 
-    std::list<std::pair<CombinedId, size_t>> mUnfinishedLoadedMatches; // Unfinished (and loaded) matches and loading time
-    std::unordered_set<CombinedId> mUnfinishedLoadedMatchesSet;
+    std::map<size_t, CombinedId> mUnfinishedLoadedMatches; // Unfinished (and loaded) matches by loading time
+    std::vector<CombinedId> mUpdatedMatches; // Matches changed since the last flush that may be displayed after it
 
     bool mMatchesChanged;
     bool mChanged;
-    std::list<CombinedId> mMatches;
-    std::list<CombinedId> mInsertedMatches;
+    std::vector<CombinedId> mMatches; // At most DISPLAY_COUNT
+    std::vector<CombinedId> mInsertedMatches;
+    std::vector<CombinedId> mChangedMatches;
 };
 
@@ -24,8 +24,9 @@ void WebTournamentStore::clearChanges() {
 
     mChangedMatches.clear();
 
-    for (auto &model : mTatamiModels)
-        model.clearChanges();
+    for (size_t index : mChangedTatamis)
+        mTatamiModels[index].clearChanges();
+    mChangedTatamis.clear();
 }
 
 void WebTournamentStore::changeTournament() {
@@ -47,6 +48,7 @@ void WebTournamentStore::beginAddPlayers(const std::vector<PlayerId> &playerIds)
 
 void WebTournamentStore::endAddPlayers(const std::vector<PlayerId> &playerIds) {
     for (auto playerId : playerIds) {
+        mPlayerIds.insert(playerId);
         assert(mChangedPlayers.find(playerId) == mChangedPlayers.end());
         mPlayerMatchResets.insert(playerId);
         if (mErasedPlayers.find(playerId) != mErasedPlayers.end()) {
@@ -61,6 +63,7 @@ void WebTournamentStore::endAddPlayers(const std::vector<PlayerId> &playerIds) {
 
 void WebTournamentStore::beginErasePlayers(const std::vector<PlayerId> &playerIds) {
     for (auto playerId : playerIds) {
+        mPlayerIds.erase(playerId);
         assert(mErasedPlayers.find(playerId) == mErasedPlayers.end());
         mPlayerMatchResets.erase(playerId);
         if (mAddedPlayers.find(playerId) != mAddedPlayers.end()) {
@@ -89,8 +92,10 @@ void WebTournamentStore::beginResetPlayers() {
 void WebTournamentStore::endResetPlayers() {
     // Add all players
     std::vector<PlayerId> playerIds;
-    for (const auto &p : getPlayers())
+    for (const auto &p : getPlayers()) {
         playerIds.push_back(p.first);
+        mPlayerIds.insert(p.first);
+    }
 
     beginAddPlayers(playerIds);
 }
@@ -122,6 +127,7 @@ void WebTournamentStore::beginAddCategories(const std::vector<CategoryId> &categ
 
 void WebTournamentStore::endAddCategories(const std::vector<CategoryId> &categoryIds) {
     for (auto categoryId : categoryIds) {
+        mCategoryIds.insert(categoryId);
         assert(mChangedCategories.find(categoryId) == mChangedCategories.end());
         mCategoryMatchResets.insert(categoryId);
         if (mErasedCategories.find(categoryId) != mErasedCategories.end()) {
@@ -143,6 +149,7 @@ void WebTournamentStore::endAddCategories(const std::vector<CategoryId> &categor
 
 void WebTournamentStore::beginEraseCategories(const std::vector<CategoryId>& categoryIds) {
     for (auto categoryId : categoryIds) {
+        mCategoryIds.erase(categoryId);
         assert(mErasedCategories.find(categoryId) == mErasedCategories.end());
         mCategoryMatchResets.erase(categoryId);
         if (mAddedCategories.find(categoryId) != mAddedCategories.end()) {
@@ -184,9 +191,27 @@ void WebTournamentStore::changeMatches(CategoryId categoryId, const std::vector<
     for (auto matchId : matchIds)
         mChangedMatches.insert(CombinedId(categoryId, matchId));
 
-    if (!mResettingTatamis) {
-        for (WebTatamiModel &model : mTatamiModels)
-            model.changeMatches(*this, categoryId, matchIds);
+    if (mResettingTatamis)
+        return;
+
+    // Only the model of the tatami a match is located on can have it loaded
+    const auto &category = getCategory(categoryId);
+    std::map<size_t, std::vector<MatchId>> tatamiMatches;
+    for (auto matchId : matchIds) {
+        auto location = category.getLocation(category.getMatch(matchId).getType());
+        if (!location)
+            continue;
+
+        auto it = mTatamiIndices.find(location->getTatamiHandle().id);
+        if (it == mTatamiIndices.end())
+            continue;
+
+        tatamiMatches[it->second].push_back(matchId);
+    }
+
+    for (const auto &[index, tatamiMatchIds] : tatamiMatches) {
+        mTatamiModels[index].changeMatches(*this, categoryId, tatamiMatchIds);
+        mFlushTatamis.insert(index);
     }
 }
 
@@ -211,9 +236,19 @@ void WebTournamentStore::eraseMatchesFromPlayer(PlayerId playerId, const std::ve
 }
 
 void WebTournamentStore::changeTatamis(const std::vector<BlockLocation> &locations, const std::vector<std::pair<CategoryId, MatchType>> &blocks) {
-    if (!mResettingTatamis) {
-        for (WebTatamiModel &model : mTatamiModels)
-            model.changeTatamis(*this, locations, blocks);
+    if (mResettingTatamis)
+        return;
+
+    std::set<size_t> indices;
+    for (const auto &location : locations) {
+        auto it = mTatamiIndices.find(location.getTatamiHandle().id);
+        if (it != mTatamiIndices.end())
+            indices.insert(it->second);
+    }
+
+    for (size_t index : indices) {
+        mTatamiModels[index].changeTatamis(*this, locations, blocks);
+        mFlushTatamis.insert(index);
     }
 }
 
@@ -277,21 +312,50 @@ const std::unordered_set<CombinedId>& WebTournamentStore::getChangedMatches() co
     return mChangedMatches;
 }
 
+const std::set<PlayerId>& WebTournamentStore::getPlayerIds() const {
+    return mPlayerIds;
+}
+
+const std::set<CategoryId>& WebTournamentStore::getCategoryIds() const {
+    return mCategoryIds;
+}
+
+void WebTournamentStore::indexIds() {
+    mPlayerIds.clear();
+    for (const auto &p : getPlayers())
+        mPlayerIds.insert(p.first);
+
+    mCategoryIds.clear();
+    for (const auto &p : getCategories())
+        mCategoryIds.insert(p.first);
+}
+
 void WebTournamentStore::flushWebTatamiModels() {
     if (mResettingTatamis) {
         mTatamiModels.clear();
+        mTatamiIndices.clear();
+        mChangedTatamis.clear();
 
         const auto &tatamis = getTatamis();
         for (size_t i = 0; i < getTatamis().tatamiCount(); ++i) {
             TatamiLocation location{tatamis.getHandle(i)};
             mTatamiModels.emplace_back(*this, location);
+            mTatamiIndices[location.handle.id] = i;
+            mChangedTatamis.insert(i);
         }
         mResettingTatamis = false;
     }
     else {
-        for (auto &model: mTatamiModels)
+        // Models without notifications since the last flush are unchanged
+        for (size_t index : mFlushTatamis) {
+            auto &model = mTatamiModels[index];
             model.flush();
+            if (model.changed() || model.matchesChanged() || !model.getChangedMatches().empty())
+                mChangedTatamis.insert(index);
+        }
     }
+
+    mFlushTatamis.clear();
 }
 
 const WebTatamiModel& WebTournamentStore::getWebTatamiModel(size_t index) const {
@@ -303,6 +367,10 @@ const std::vector<WebTatamiModel>& WebTournamentStore::getWebTatamiModels() cons
     return mTatamiModels;
 }
 
+const std::set<size_t>& WebTournamentStore::getChangedTatamis() const {
+    return mChangedTatamis;
+}
+
 void WebTournamentStore::resetCategoryResults(const std::vector<CategoryId> &categoryIds) {
     mCategoryResultsResets.insert(categoryIds.begin(), categoryIds.end());
 }
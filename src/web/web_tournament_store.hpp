@@ -1,5 +1,7 @@
 #pragma once
 
+#include <set>
+
 #include "core/stores/tournament_store.hpp"
 #include "web/web_tatami_model.hpp"
 
@@ -23,6 +25,11 @@ public:
 
     const std::unordered_set<CombinedId>& getChangedMatches() const;
 
+    // Ids in ascending order, used to serve pages without scanning the tournament
+    const std::set<PlayerId>& getPlayerIds() const;
+    const std::set<CategoryId>& getCategoryIds() const;
+    void indexIds(); // Rebuild the ordered ids after the store was deserialized
+
     // Parent methods to override
     void changeTournament() override;
 
@@ -64,6 +71,7 @@ public:
     void flushWebTatamiModels();
     const WebTatamiModel& getWebTatamiModel(size_t index) const;
     const std::vector<WebTatamiModel>& getWebTatamiModels() const;
+    const std::set<size_t>& getChangedTatamis() const; // Indices of the models with changes since the last clear
 
 private:
     bool mTournamentChanged;
@@ -81,7 +89,13 @@ private:
 
     std::unordered_set<CombinedId> mChangedMatches;
 
+    std::set<PlayerId> mPlayerIds;
+    std::set<CategoryId> mCategoryIds;
+
     std::vector<WebTatamiModel> mTatamiModels;
+    std::unordered_map<PositionId, size_t> mTatamiIndices; // Model index by tatami handle id
+    std::set<size_t> mFlushTatamis; // Models notified of changes since the last flush
+    std::set<size_t> mChangedTatamis;
     bool mResettingTatamis;
 };
 